@@ -8,6 +8,15 @@ public class Defiance : ModuleRules
 	{
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
-		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "EnhancedInput" });
+		PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "HeadMountedDisplay", "EnhancedInput", "UMG", "Slate", "SlateCore", "MassEntity", "MassCommon", "AnimationCore" });
+
+		// The network automation tests drive Play In Editor sessions
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.Add("UnrealEd");
+
+			// The reachability bake looks up the default game mode of the project
+			PrivateDependencyModuleNames.Add("EngineSettings");
+		}
 	}
 }
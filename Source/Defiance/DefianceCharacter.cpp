@@ -1,6 +1,7 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DefianceCharacter.h"
+#include "MemoryTags.h"
 #include "Animation/BaseAnimInstance_ABP.h"
 #include "BasicSupportLibrary.h"
 #include "Kismet/KismetMathLibrary.h"
@@ -9,27 +10,42 @@
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/SphereComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/PlayerState.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Net/UnrealNetwork.h"
 #include "GameFramework/Controller.h"
-#include "GameFramework/SpringArmComponent.h"
+#include "Characters/DefianceSpringArmComponent.h"
 #include "EnhancedInput/Public/InputMappingContext.h"
 #include "EnhancedInput/Public/EnhancedInputSubsystems.h"
 #include "EnhancedInput/Public/EnhancedInputComponent.h"
 #include "MyInputConfigData.h"
 #include "Combat/LockOnComponent.h"
+#include "Combat/MeleeComponent.h"
+#include "Characters/DefianceMovementComponent.h"
+#include "Characters/ClimbingComponent.h"
+#include "Characters/SwingComponent.h"
 
 //////////////////////////////////////////////////////////////////////////
 // ADefianceCharacter
 
-ADefianceCharacter::ADefianceCharacter()
+ADefianceCharacter::ADefianceCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UDefianceMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
-	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	LLM_SCOPE_BYTAG(Defiance);
+
+	// The character itself has nothing to do every frame; its components tick on their own (Blueprints with an Event Tick turn it back on)
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Instantiating components
-	LockOnComponent = CreateDefaultSubobject<ULockOnComponent>(TEXT("Lock On Component"));
+	{
+		LLM_SCOPE_BYTAG(Defiance_LockOn);
+		LockOnComponent = CreateDefaultSubobject<ULockOnComponent>(TEXT("Lock On Component"));
+	}
+
+	ClimbingComponent = CreateDefaultSubobject<UClimbingComponent>(TEXT("ClimbingComponent"));
+	SwingComponent = CreateDefaultSubobject<USwingComponent>(TEXT("SwingComponent"));
+	MeleeComponent = CreateDefaultSubobject<UMeleeComponent>(TEXT("MeleeComponent"));
 
 		
 	// Set size for collision capsule
@@ -52,8 +68,10 @@ ADefianceCharacter::ADefianceCharacter()
 	GetCharacterMovement()->MinAnalogWalkSpeed = 20.f;
 	GetCharacterMovement()->BrakingDecelerationWalking = 2000.f;
 
+	// The camera exists in every build so server and client share one component layout (Blueprint overrides and
+	// references depend on it); dedicated servers switch it off in BeginPlay
 	// Create a camera boom (pulls in towards the player if there is a collision)
-	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
+	CameraBoom = CreateDefaultSubobject<UDefianceSpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
 	CameraBoom->TargetArmLength = 400.0f; // The camera follows at this distance behind the character	
 	CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
@@ -63,26 +81,40 @@ ADefianceCharacter::ADefianceCharacter()
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 
+#if UE_SERVER
+	// Dedicated servers never render, so only montages (root motion) need to be evaluated
+	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+#endif
+
 }
 
 
 void ADefianceCharacter::BeginPlay()
 {
+	// The lock on indicator is drawn by the HUD's indicator layer; the old per-character widget is never created
+	UBasicSupportLibrary::DisableWidgetComponents(this);
+
 	Super::BeginPlay();
 
+	// Nobody looks through the camera of a dedicated server
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		CameraBoom->SetComponentTickEnabled(false);
+		CameraBoom->bDoCollisionTest = false;
+		FollowCamera->SetComponentTickEnabled(false);
+	}
+
+#if !UE_SERVER
 	AnimInstance = Cast<UBaseAnimInstance_ABP>(GetMesh()->GetAnimInstance());
 	if (AnimInstance == nullptr) {
 		UE_LOG(LogTemp, Error, TEXT("ADefianceCharacter [BeginPlay]: The animation instance has not been set."))
 		return;
 	}
+#endif
 	
 }
 
 
-void ADefianceCharacter::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-}
 
 
 
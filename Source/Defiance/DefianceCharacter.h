@@ -6,7 +6,6 @@
 #include "GameFramework/Character.h"
 #include "Types.h"
 #include "Curves/CurveFloat.h"
-#include "Components/WidgetComponent.h"
 #include "Components/TimelineComponent.h"
 #include "Interfaces/Enemy.h"
 #include "DefianceCharacter.generated.h"
@@ -18,23 +17,31 @@ class ADefianceCharacter : public ACharacter, public IEnemy
 
 	/** Camera boom positioning the camera behind the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	class USpringArmComponent* CameraBoom;
+	class UDefianceSpringArmComponent* CameraBoom;
 
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class UCameraComponent* FollowCamera;
 
+	/** Grabs and moves along the edges of the level's climb graphs */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Climbing, meta = (AllowPrivateAccess = "true"))
+	class UClimbingComponent* ClimbingComponent;
+
+	/** Swings from ropes, high bars and grapple anchors */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Climbing, meta = (AllowPrivateAccess = "true"))
+	class USwingComponent* SwingComponent;
+
+	/** Melee attacks and hit reactions; attack windows are opened by UMeleeAttackNotifyState on the attack montages */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	class UMeleeComponent* MeleeComponent;
+
 public:
-	ADefianceCharacter();
+	ADefianceCharacter(const FObjectInitializer& ObjectInitializer);
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	class ULockOnComponent* LockOnComponent;
 
 
-	/** Keep this as clean as possible */
-	virtual void Tick(float DeltaTime);
-
-
 protected:
 	/** Called when the game starts or when spawned */
 	virtual void BeginPlay() override;
@@ -47,9 +54,15 @@ protected:
 
 public:
 	/** Returns CameraBoom subobject **/
-	FORCEINLINE class USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
+	FORCEINLINE class UDefianceSpringArmComponent* GetCameraBoom() const { return CameraBoom; }
 	/** Returns FollowCamera subobject **/
 	FORCEINLINE class UCameraComponent* GetFollowCamera() const { return FollowCamera; }
+	/** Returns ClimbingComponent subobject **/
+	FORCEINLINE class UClimbingComponent* GetClimbingComponent() const { return ClimbingComponent; }
+	/** Returns SwingComponent subobject **/
+	FORCEINLINE class USwingComponent* GetSwingComponent() const { return SwingComponent; }
+	/** Returns MeleeComponent subobject **/
+	FORCEINLINE class UMeleeComponent* GetMeleeComponent() const { return MeleeComponent; }
 
 
 
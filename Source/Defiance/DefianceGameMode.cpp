@@ -1,15 +1,77 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "DefianceGameMode.h"
+#include "MemoryTags.h"
 #include "DefianceCharacter.h"
-#include "UObject/ConstructorHelpers.h"
+#include "UI/DefianceHUD.h"
+#include "Characters/ActorPoolSubsystem.h"
+#include "Engine/AssetManager.h"
 
 ADefianceGameMode::ADefianceGameMode()
 {
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter"));
-	if (PlayerPawnBPClass.Class != NULL)
+	// set default pawn class to our Blueprinted character; it is only referenced softly so it does not load with the game mode
+	SoftDefaultPawnClass = TSoftClassPtr<APawn>(FSoftObjectPath(TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C")));
+
+	// Target indicators are drawn by one HUD layer instead of a widget component per actor
+	HUDClass = ADefianceHUD::StaticClass();
+}
+
+void ADefianceGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	if (SoftDefaultPawnClass.IsNull()) { return; }
+
+	// Start streaming the pawn as early as possible so it is ready by the time the first player logs in
+	DefaultPawnClassHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		SoftDefaultPawnClass.ToSoftObjectPath(),
+		FStreamableDelegate::CreateUObject(this, &ADefianceGameMode::OnDefaultPawnClassLoaded),
+		FStreamableManager::AsyncLoadHighPriority
+	);
+}
+
+void ADefianceGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	// After the level's BeginPlay, which would switch the ticks of actors pooled earlier back on; still before the
+	// first frame, so no wave pays for the spawns
+	if (UActorPoolSubsystem* Pool{ UActorPoolSubsystem::Get(this) })
 	{
-		DefaultPawnClass = PlayerPawnBPClass.Class;
+		for (const TPair<TSubclassOf<AActor>, int32>& PooledActor : PooledActorCounts)
+		{
+			Pool->Prewarm(PooledActor.Key, PooledActor.Value);
+		}
 	}
 }
+
+void ADefianceGameMode::OnDefaultPawnClassLoaded()
+{
+	if (UClass* LoadedClass{ SoftDefaultPawnClass.Get() })
+	{
+		DefaultPawnClass = LoadedClass;
+	}
+}
+
+UClass* ADefianceGameMode::GetDefaultPawnClassForController_Implementation(AController* InController)
+{
+	// A player logged in before streaming finished; block on the load rather than spawning the wrong pawn
+	if (!SoftDefaultPawnClass.IsNull() && SoftDefaultPawnClass.Get() == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("ADefianceGameMode [GetDefaultPawnClassForController]: Default pawn class requested before streaming finished; loading synchronously."))
+		DefaultPawnClass = SoftDefaultPawnClass.LoadSynchronous();
+	}
+	else if (UClass* LoadedClass{ SoftDefaultPawnClass.Get() })
+	{
+		DefaultPawnClass = LoadedClass;
+	}
+
+	return Super::GetDefaultPawnClassForController_Implementation(InController);
+}
+
+APawn* ADefianceGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+	LLM_SCOPE_BYTAG(Defiance);
+
+	return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
+#include "Engine/StreamableManager.h"
 #include "DefianceGameMode.generated.h"
 
 UCLASS(minimalapi)
@@ -11,8 +12,31 @@ class ADefianceGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
+	/** Keeps the default pawn class resident once it has been streamed in */
+	TSharedPtr<FStreamableHandle> DefaultPawnClassHandle;
+
 public:
 	ADefianceGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual void StartPlay() override;
+
+	virtual UClass* GetDefaultPawnClassForController_Implementation(AController* InController) override;
+
+	/** Tags the player's pawn for LLM, including the components its Blueprint adds */
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+	/** Pawn class spawned for players; streamed in asynchronously when the game starts instead of at module load */
+	UPROPERTY(EditDefaultsOnly, Category = Classes)
+	TSoftClassPtr<APawn> SoftDefaultPawnClass;
+
+	/** Number of actors of each class spawned into UActorPoolSubsystem before play begins, so waves do not spawn them */
+	UPROPERTY(EditDefaultsOnly, Category = Classes)
+	TMap<TSubclassOf<AActor>, int32> PooledActorCounts;
+
+	/** Called when the default pawn class has finished streaming */
+	void OnDefaultPawnClassLoaded();
 };
 
 
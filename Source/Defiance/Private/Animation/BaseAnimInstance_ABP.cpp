@@ -5,6 +5,16 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "../DefianceCharacter.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Characters/SignificanceSubsystem.h"
+#include "Animation/AnimNodeBase.h"
+#include "BonePose.h"
+#include "TwoBoneIK.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Foot Placement Traces"), STAT_FootPlacementTraces, STATGROUP_Game);
+DECLARE_CYCLE_STAT(TEXT("Foot Placement IK"), STAT_FootPlacementIK, STATGROUP_Anim);
+
 
 void UBaseAnimInstance_ABP::NativeInitializeAnimation()
 {
@@ -13,11 +23,228 @@ void UBaseAnimInstance_ABP::NativeInitializeAnimation()
 	{
 		CharacterMovement = Character->GetCharacterMovement();
 	}
+
+	FootTraceDelegate.BindUObject(this, &UBaseAnimInstance_ABP::HandleFootTrace);
+
+	FBaseAnimInstanceProxy& Proxy{ GetProxyOnGameThread<FBaseAnimInstanceProxy>() };
+	Proxy.PelvisBone = PelvisBone;
+	Proxy.FootBones[0] = LeftFootBone;
+	Proxy.FootBones[1] = RightFootBone;
+
+	// The subsystem only pushes changes of tier, so one set before this instance existed has to be picked up here
+	if (const USignificanceSubsystem* Significance{ IsValid(Character) ? USignificanceSubsystem::Get(Character) : nullptr })
+	{
+		SignificanceTier = Significance->GetTier(Character);
+	}
 }
 
 void UBaseAnimInstance_ABP::NativeUpdateAnimation(float DeltaTimeX)
 {
-	
+	UpdateFootTraces(DeltaTimeX);
+}
+
+void UBaseAnimInstance_ABP::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	// Only the targets copied on the game thread are read here, so the IK never waits on a trace
+	FootPlacementAlpha = FMath::FInterpTo(FootPlacementAlpha, TargetFootPlacementAlpha, DeltaSeconds, FootInterpSpeed);
+
+	// The pelvis goes down to the lower foot and the feet are placed relative to it
+	const float TargetPelvisOffset{ FMath::Min(FMath::Min(TargetFootOffsets[0], TargetFootOffsets[1]), 0.0f) };
+	PelvisOffset = FMath::FInterpTo(PelvisOffset, TargetPelvisOffset, DeltaSeconds, FootInterpSpeed);
+	LeftFootOffset = FMath::FInterpTo(LeftFootOffset, TargetFootOffsets[0] - TargetPelvisOffset, DeltaSeconds, FootInterpSpeed);
+	RightFootOffset = FMath::FInterpTo(RightFootOffset, TargetFootOffsets[1] - TargetPelvisOffset, DeltaSeconds, FootInterpSpeed);
+	LeftFootRotation = FMath::RInterpTo(LeftFootRotation, TargetFootRotations[0], DeltaSeconds, FootInterpSpeed);
+	RightFootRotation = FMath::RInterpTo(RightFootRotation, TargetFootRotations[1], DeltaSeconds, FootInterpSpeed);
+
+	FBaseAnimInstanceProxy& Proxy{ GetProxyOnAnyThread<FBaseAnimInstanceProxy>() };
+	Proxy.PelvisOffset = PelvisOffset;
+	Proxy.FootOffsets[0] = LeftFootOffset;
+	Proxy.FootOffsets[1] = RightFootOffset;
+	Proxy.FootRotations[0] = LeftFootRotation;
+	Proxy.FootRotations[1] = RightFootRotation;
+	Proxy.FootPlacementAlpha = FootPlacementAlpha;
+}
+
+
+bool FBaseAnimInstanceProxy::Evaluate_WithRoot(FPoseContext& Output, FAnimNode_Base* InRootNode)
+{
+	EvaluateAnimationNode_WithRoot(Output, InRootNode);
+
+	if (FootPlacementAlpha > UE_KINDA_SMALL_NUMBER) { ApplyFootPlacement(Output); }
+	return true;
+}
+
+void FBaseAnimInstanceProxy::CacheBones(const FBoneContainer& RequiredBones)
+{
+	CachedBonesSerial = RequiredBones.GetSerialNumber();
+
+	auto FindBone = [&RequiredBones](FName BoneName)
+	{
+		const int32 MeshIndex{ RequiredBones.GetPoseBoneIndexForBoneName(BoneName) };
+		return MeshIndex != INDEX_NONE ? RequiredBones.MakeCompactPoseIndex(FMeshPoseBoneIndex(MeshIndex)).GetInt() : INDEX_NONE;
+	};
+	auto FindParent = [&RequiredBones](int32 BoneIndex)
+	{
+		return BoneIndex != INDEX_NONE ? RequiredBones.GetParentBoneIndex(FCompactPoseBoneIndex(BoneIndex)).GetInt() : INDEX_NONE;
+	};
+
+	PelvisIndex = FindBone(PelvisBone);
+	for (int32 Foot = 0; Foot < 2; Foot++)
+	{
+		const int32 FootIndex{ FindBone(FootBones[Foot]) };
+		const int32 CalfIndex{ FindParent(FootIndex) };
+		const int32 ThighIndex{ FindParent(CalfIndex) };
+
+		// A leg missing a bone in this LOD is left as animated
+		const bool bHasLeg{ ThighIndex != INDEX_NONE };
+		LegIndices[Foot][0] = bHasLeg ? ThighIndex : INDEX_NONE;
+		LegIndices[Foot][1] = bHasLeg ? CalfIndex : INDEX_NONE;
+		LegIndices[Foot][2] = bHasLeg ? FootIndex : INDEX_NONE;
+	}
+}
+
+void FBaseAnimInstanceProxy::ApplyFootPlacement(FPoseContext& Output)
+{
+	SCOPE_CYCLE_COUNTER(STAT_FootPlacementIK);
+
+	const FBoneContainer& RequiredBones{ Output.Pose.GetBoneContainer() };
+	if (RequiredBones.GetSerialNumber() != CachedBonesSerial) { CacheBones(RequiredBones); }
+	if (PelvisIndex == INDEX_NONE) { return; }
+
+	FComponentSpacePoseContext CSContext{ this };
+	CSContext.Pose.InitPose(Output.Pose);
+
+	// The offsets are vertical and the rotations tilt the feet in world space
+	const FTransform& ComponentTransform{ GetComponentTransform() };
+	const FVector Up{ ComponentTransform.InverseTransformVectorNoScale(FVector::UpVector) };
+	const FQuat ComponentRotation{ ComponentTransform.GetRotation() };
+
+	// The pelvis goes first so the legs are solved from where it ends up
+	const FCompactPoseBoneIndex Pelvis{ PelvisIndex };
+	FTransform PelvisTransform{ CSContext.Pose.GetComponentSpaceTransform(Pelvis) };
+	PelvisTransform.AddToTranslation(Up * PelvisOffset);
+
+	TArray<FBoneTransform> BoneTransforms{ FBoneTransform(Pelvis, PelvisTransform) };
+	CSContext.Pose.LocalBlendCSBoneTransforms(BoneTransforms, FootPlacementAlpha);
+
+	for (int32 Foot = 0; Foot < 2; Foot++)
+	{
+		if (LegIndices[Foot][2] == INDEX_NONE) { continue; }
+
+		const FCompactPoseBoneIndex Thigh{ LegIndices[Foot][0] };
+		const FCompactPoseBoneIndex Calf{ LegIndices[Foot][1] };
+		const FCompactPoseBoneIndex FootBone{ LegIndices[Foot][2] };
+
+		FTransform ThighTransform{ CSContext.Pose.GetComponentSpaceTransform(Thigh) };
+		FTransform CalfTransform{ CSContext.Pose.GetComponentSpaceTransform(Calf) };
+		FTransform FootTransform{ CSContext.Pose.GetComponentSpaceTransform(FootBone) };
+
+		// The knee keeps bending the way the animation bends it
+		const FVector Knee{ CalfTransform.GetLocation() };
+		const FVector JointTarget{ Knee + (Knee - (ThighTransform.GetLocation() + FootTransform.GetLocation()) * 0.5) };
+		const FVector Effector{ FootTransform.GetLocation() + Up * FootOffsets[Foot] };
+		AnimationCore::SolveTwoBoneIK(ThighTransform, CalfTransform, FootTransform, JointTarget, Effector, false, 1.0f, 1.0f);
+
+		const FQuat GroundRotation{ ComponentRotation.Inverse() * FootRotations[Foot].Quaternion() * ComponentRotation };
+		FootTransform.SetRotation(GroundRotation * FootTransform.GetRotation());
+
+		BoneTransforms.Reset();
+		BoneTransforms.Add(FBoneTransform(Thigh, ThighTransform));
+		BoneTransforms.Add(FBoneTransform(Calf, CalfTransform));
+		BoneTransforms.Add(FBoneTransform(FootBone, FootTransform));
+		CSContext.Pose.LocalBlendCSBoneTransforms(BoneTransforms, FootPlacementAlpha);
+	}
+
+	FCSPose<FCompactPose>::ConvertComponentPosesToLocalPoses(MoveTemp(CSContext.Pose), Output.Pose);
+}
+
+
+void UBaseAnimInstance_ABP::UpdateFootTraces(float DeltaTimeX)
+{
+	if (!IsValid(Character) || !IsValid(CharacterMovement)) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_FootPlacementTraces);
+
+	// Far away the difference does not show, and in the air there is no ground to place the feet on
+	const bool bPlaceFeet{ SignificanceTier != ESignificanceTier::Low && CharacterMovement->IsMovingOnGround() };
+	TargetFootPlacementAlpha = bPlaceFeet ? 1.0f : 0.0f;
+
+	if (!bPlaceFeet)
+	{
+		for (int32 Foot = 0; Foot < 2; Foot++)
+		{
+			FootTraces[Foot].bHasGround = false;
+			TargetFootOffsets[Foot] = 0.0f;
+			TargetFootRotations[Foot] = FRotator::ZeroRotator;
+		}
+		return;
+	}
+
+	const USkeletalMeshComponent* Mesh{ Character->GetMesh() };
+	const float MeshZ{ static_cast<float>(Mesh->GetComponentLocation().Z) };
+
+	for (int32 Foot = 0; Foot < 2; Foot++)
+	{
+		FFootTrace& FootTrace{ FootTraces[Foot] };
+		const FVector FootLocation{ Mesh->GetSocketLocation(Foot == 0 ? LeftFootBone : RightFootBone) };
+
+		const bool bPlanted{ FVector::DistSquared2D(FootLocation, FootTrace.LastFootLocation) <= FMath::Square(PlantedFootSpeed * DeltaTimeX) };
+		FootTrace.LastFootLocation = FootLocation;
+
+		// A planted foot keeps the ground found under it; a moving one is traced again, one trace in flight at a time
+		const bool bReuseGround{ FootTrace.bHasGround && bPlanted && FVector::DistSquared2D(FootLocation, FootTrace.TracedLocation) <= FMath::Square(PlantedFootTolerance) };
+		if (!bReuseGround && !FootTrace.bTracePending)
+		{
+			FootTrace.Trace = GetWorld()->AsyncLineTraceByChannel(
+				EAsyncTraceType::Single,
+				FVector(FootLocation.X, FootLocation.Y, MeshZ + FootTraceUp),
+				FVector(FootLocation.X, FootLocation.Y, MeshZ - FootTraceDown),
+				ECollisionChannel::ECC_Visibility,
+				FCollisionQueryParams{ SCENE_QUERY_STAT(FootPlacement), false, Character },
+				FCollisionResponseParams::DefaultResponseParam,
+				&FootTraceDelegate,
+				Foot
+			);
+			FootTrace.TracedLocation = FootLocation;
+			FootTrace.bTracePending = true;
+		}
+
+		// Until the first trace lands the foot stays where the animation put it
+		if (!FootTrace.bHasGround)
+		{
+			TargetFootOffsets[Foot] = 0.0f;
+			TargetFootRotations[Foot] = FRotator::ZeroRotator;
+			continue;
+		}
+
+		const FVector& Normal{ FootTrace.GroundNormal };
+		TargetFootOffsets[Foot] = FMath::Clamp(FootTrace.GroundZ - MeshZ, -MaxFootOffset, MaxFootOffset);
+		TargetFootRotations[Foot] = FRotator(
+			-FMath::RadiansToDegrees(FMath::Atan2(Normal.X, Normal.Z)),
+			0.0f,
+			FMath::RadiansToDegrees(FMath::Atan2(Normal.Y, Normal.Z))
+		);
+	}
+}
+
+void UBaseAnimInstance_ABP::HandleFootTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	const int32 Foot{ static_cast<int32>(TraceDatum.UserData) };
+	if (Foot < 0 || Foot >= 2) { return; }
+
+	FFootTrace& FootTrace{ FootTraces[Foot] };
+	if (TraceHandle != FootTrace.Trace) { return; }
+	FootTrace.bTracePending = false;
+
+	const FHitResult* Hit{ TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit ? &TraceDatum.OutHits[0] : nullptr };
+	FootTrace.bHasGround = Hit != nullptr;
+	if (Hit)
+	{
+		FootTrace.GroundZ = static_cast<float>(Hit->ImpactPoint.Z);
+		FootTrace.GroundNormal = Hit->ImpactNormal;
+	}
 }
 
 
@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Animation/MeleeAttackNotifyState.h"
+#include "Combat/MeleeComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+
+
+void UMeleeAttackNotifyState::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference)
+{
+	Super::NotifyBegin(MeshComp, Animation, TotalDuration, EventReference);
+
+	if (!IsValid(MeshComp)) { return; }
+
+	// Montage previews in the editor have no melee component; BeginAttack itself ignores machines that do not detect hits
+	if (UMeleeComponent* Melee{ IsValid(MeshComp->GetOwner()) ? MeshComp->GetOwner()->FindComponentByClass<UMeleeComponent>() : nullptr })
+	{
+		Melee->BeginAttack();
+	}
+}
+
+void UMeleeAttackNotifyState::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference)
+{
+	if (IsValid(MeshComp))
+	{
+		if (UMeleeComponent* Melee{ IsValid(MeshComp->GetOwner()) ? MeshComp->GetOwner()->FindComponentByClass<UMeleeComponent>() : nullptr })
+		{
+			Melee->EndAttack();
+		}
+	}
+
+	Super::NotifyEnd(MeshComp, Animation, EventReference);
+}
+
+FString UMeleeAttackNotifyState::GetNotifyName_Implementation() const
+{
+	return TEXT("Melee Attack Window");
+}
@@ -2,6 +2,7 @@
 
 
 #include "BasicSupportLibrary.h"
+#include "Components/WidgetComponent.h"
 
 
 FVector UBasicSupportLibrary::GetPlayerInputMovementDirectionXY(FRotator CameraRotation, float ForwardMovementValue, float RightMovementValue)
@@ -94,4 +95,25 @@ EDetailedDirection UBasicSupportLibrary::GetDetailedDirectionFromAngle(float Ang
 	return EDetailedDirection::Forward;
 }
 
+bool UBasicSupportLibrary::IsEventOverriddenInBlueprint(const UObject* Object, FName EventName)
+{
+	if (!IsValid(Object)) { return false; }
+
+	// A Blueprint override replaces the native function with a script one in the generated class
+	const UFunction* Function{ Object->FindFunction(EventName) };
+	return Function && !Function->HasAnyFunctionFlags(FUNC_Native);
+}
 
+void UBasicSupportLibrary::DisableWidgetComponents(AActor* Actor)
+{
+	if (!IsValid(Actor)) { return; }
+
+	// The components stay so Blueprints referencing them still compile; without a class they never create a widget
+	TInlineComponentArray<UWidgetComponent*> WidgetComponents{ Actor };
+	for (UWidgetComponent* WidgetComponent : WidgetComponents)
+	{
+		WidgetComponent->SetWidgetClass(nullptr);
+		WidgetComponent->SetVisibility(false);
+		WidgetComponent->SetComponentTickEnabled(false);
+	}
+}
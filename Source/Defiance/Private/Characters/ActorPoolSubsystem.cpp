@@ -0,0 +1,299 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/ActorPoolSubsystem.h"
+#include "Interfaces/Poolable.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+
+
+static FAutoConsoleCommandWithWorldAndArgs ActorPoolBenchmarkCommand(
+	TEXT("defiance.ActorPool.Benchmark"),
+	TEXT("Times waves spawned with SpawnActor against waves taken from the actor pool. Args: <ClassPath> [Waves=10] [WaveSize=50]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UActorPoolSubsystem* Pool{ UActorPoolSubsystem::Get(World) };
+		UClass* ActorClass{ Args.Num() > 0 ? LoadClass<AActor>(nullptr, *Args[0]) : nullptr };
+		if (!Pool || !ActorClass)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("UActorPoolSubsystem [Benchmark]: Usage: defiance.ActorPool.Benchmark <ClassPath> [Waves] [WaveSize]"))
+			return;
+		}
+
+		const int32 Waves{ Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10 };
+		const int32 WaveSize{ Args.Num() > 2 ? FMath::Max(1, FCString::Atoi(*Args[2])) : 50 };
+
+		const FActorPoolBenchmarkResult Result{ Pool->Benchmark(ActorClass, Waves, WaveSize, [](const TArray<AActor*>&) {}) };
+
+		UE_LOG(LogTemp, Display, TEXT("UActorPoolSubsystem [Benchmark]: %s, %d waves of %d. SpawnActor: %.3f ms per wave (worst %.3f ms). Pool: %.3f ms per wave (worst %.3f ms)."),
+			*ActorClass->GetName(), Waves, WaveSize, Result.SpawnAverage, Result.SpawnWorst, Result.PoolAverage, Result.PoolWorst)
+	}));
+
+
+
+UActorPoolSubsystem* UActorPoolSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UActorPoolSubsystem>() : nullptr;
+}
+
+void UActorPoolSubsystem::Deinitialize()
+{
+	if (WorldBeginPlayHandle.IsValid()) { GetWorld()->OnWorldBeginPlay.Remove(WorldBeginPlayHandle); }
+
+	Super::Deinitialize();
+}
+
+
+
+void UActorPoolSubsystem::Prewarm(TSubclassOf<AActor> ActorClass, int32 Count)
+{
+	if (!ActorClass) { return; }
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	// Actors spawned before play get their BeginPlay with the level, which switches their ticks back on
+	UWorld* World{ GetWorld() };
+	if (!World->HasBegunPlay() && !WorldBeginPlayHandle.IsValid())
+	{
+		WorldBeginPlayHandle = World->OnWorldBeginPlay.AddUObject(this, &UActorPoolSubsystem::HandleWorldBeginPlay);
+	}
+
+	const int32 NumToSpawn{ Count - GetNumFree(ActorClass) };
+	for (int32 i = 0; i < NumToSpawn; i++)
+	{
+		AActor* Actor{ World->SpawnActor<AActor>(ActorClass, FTransform(PoolLocation), SpawnParams) };
+		if (!IsValid(Actor))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("UActorPoolSubsystem [Prewarm]: Failed to spawn %s."), *ActorClass->GetName())
+			return;
+		}
+
+		Deactivate(Actor);
+	}
+}
+
+AActor* UActorPoolSubsystem::Acquire(TSubclassOf<AActor> ActorClass, const FTransform& Transform)
+{
+	if (!ActorClass) { return nullptr; }
+
+	AActor* Actor{ nullptr };
+	if (FActorPoolBucket* Bucket{ Pools.Find(ActorClass.Get()) })
+	{
+		// Pooled actors can still be destroyed by a level unload or a stray Destroy call
+		while (!Actor && Bucket->FreeActors.Num() > 0)
+		{
+			AActor* Candidate{ Bucket->FreeActors.Pop(EAllowShrinking::No) };
+			if (IsValid(Candidate)) { Actor = Candidate; }
+		}
+	}
+
+	if (!Actor)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+		Actor = GetWorld()->SpawnActor<AActor>(ActorClass, Transform, SpawnParams);
+		if (!IsValid(Actor)) { return nullptr; }
+	}
+	else
+	{
+		Actor->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+		Actor->SetActorHiddenInGame(false);
+		Actor->SetActorEnableCollision(true);
+
+		FPausedTicks Ticks;
+		if (PausedTicks.RemoveAndCopyValue(Actor, Ticks))
+		{
+			if (Ticks.bActorTicked) { Actor->SetActorTickEnabled(true); }
+			for (const TWeakObjectPtr<UActorComponent>& Component : Ticks.Components)
+			{
+				if (Component.IsValid()) { Component->SetComponentTickEnabled(true); }
+			}
+		}
+
+		if (ACharacter* Character{ Cast<ACharacter>(Actor) })
+		{
+			Character->GetCharacterMovement()->SetDefaultMovementMode();
+		}
+
+		if (Actor->HasAuthority() && Actor->GetIsReplicated())
+		{
+			Actor->SetNetDormancy(DORM_Awake);
+			Actor->ForceNetUpdate();
+		}
+
+		APawn* Pawn{ Cast<APawn>(Actor) };
+		if (Pawn && !Pawn->GetController() && Pawn->HasAuthority()
+			&& (Pawn->AutoPossessAI == EAutoPossessAI::Spawned || Pawn->AutoPossessAI == EAutoPossessAI::PlacedInWorldOrSpawned))
+		{
+			Pawn->SpawnDefaultController();
+		}
+	}
+
+	if (IPoolable* Poolable{ Cast<IPoolable>(Actor) }) { Poolable->OnAcquiredFromPool(); }
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (IPoolable* Poolable{ Cast<IPoolable>(Component) }) { Poolable->OnAcquiredFromPool(); }
+	}
+
+	return Actor;
+}
+
+void UActorPoolSubsystem::Release(AActor* Actor)
+{
+	if (!IsValid(Actor) || PausedTicks.Contains(Actor)) { return; }
+
+	// Reset while the actor is still possessed and placed, so resets can go through the usual code paths
+	if (IPoolable* Poolable{ Cast<IPoolable>(Actor) }) { Poolable->OnReleasedToPool(); }
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (IPoolable* Poolable{ Cast<IPoolable>(Component) }) { Poolable->OnReleasedToPool(); }
+	}
+
+	Deactivate(Actor);
+}
+
+void UActorPoolSubsystem::Deactivate(AActor* Actor)
+{
+	if (APawn* Pawn{ Cast<APawn>(Actor) })
+	{
+		// AI controllers are cheap next to the pawn and carry per-life state such as perception and blackboards
+		AController* PawnController{ Pawn->GetController() };
+		if (PawnController && !PawnController->IsPlayerController())
+		{
+			PawnController->UnPossess();
+			PawnController->Destroy();
+		}
+	}
+
+	if (ACharacter* Character{ Cast<ACharacter>(Actor) })
+	{
+		Character->GetCharacterMovement()->StopMovementImmediately();
+		Character->GetCharacterMovement()->DisableMovement();
+	}
+
+	Actor->SetActorHiddenInGame(true);
+	Actor->SetActorEnableCollision(false);
+	Actor->SetActorLocation(PoolLocation, false, nullptr, ETeleportType::ResetPhysics);
+	PauseTicks(Actor, PausedTicks.FindOrAdd(Actor));
+
+	// Send the hidden state once more, then close the channels until the actor is acquired again
+	if (Actor->HasAuthority() && Actor->GetIsReplicated())
+	{
+		Actor->ForceNetUpdate();
+		Actor->SetNetDormancy(DORM_DormantAll);
+	}
+
+	Pools.FindOrAdd(Actor->GetClass()).FreeActors.Add(Actor);
+}
+
+void UActorPoolSubsystem::PauseTicks(AActor* Actor, FPausedTicks& OutPausedTicks) const
+{
+	if (Actor->IsActorTickEnabled())
+	{
+		Actor->SetActorTickEnabled(false);
+		OutPausedTicks.bActorTicked = true;
+	}
+
+	for (UActorComponent* Component : Actor->GetComponents())
+	{
+		if (Component->IsComponentTickEnabled())
+		{
+			Component->SetComponentTickEnabled(false);
+			OutPausedTicks.Components.AddUnique(Component);
+		}
+	}
+}
+
+void UActorPoolSubsystem::HandleWorldBeginPlay()
+{
+	GetWorld()->OnWorldBeginPlay.Remove(WorldBeginPlayHandle);
+	WorldBeginPlayHandle.Reset();
+
+	for (TPair<TObjectKey<AActor>, FPausedTicks>& Pooled : PausedTicks)
+	{
+		if (AActor* Actor{ Pooled.Key.ResolveObjectPtr() }) { PauseTicks(Actor, Pooled.Value); }
+	}
+}
+
+int32 UActorPoolSubsystem::GetNumFree(TSubclassOf<AActor> ActorClass) const
+{
+	const FActorPoolBucket* Bucket{ Pools.Find(ActorClass.Get()) };
+	return Bucket ? Bucket->FreeActors.Num() : 0;
+}
+
+
+
+FActorPoolBenchmarkResult UActorPoolSubsystem::Benchmark(TSubclassOf<AActor> ActorClass, int32 Waves, int32 WaveSize, TFunctionRef<void(const TArray<AActor*>&)> OnPoolWave)
+{
+	FActorPoolBenchmarkResult Result;
+	if (!ActorClass || Waves < 1 || WaveSize < 1) { return Result; }
+
+	UWorld* World{ GetWorld() };
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	TArray<AActor*> Wave;
+	Wave.Reserve(WaveSize);
+
+	double SpawnTotal{ 0.0 };
+	for (int32 WaveIndex = 0; WaveIndex < Waves; WaveIndex++)
+	{
+		const double StartTime{ FPlatformTime::Seconds() };
+		for (int32 i = 0; i < WaveSize; i++)
+		{
+			Wave.Add(World->SpawnActor<AActor>(ActorClass, GetBenchmarkTransform(i), SpawnParams));
+		}
+		const double WaveTime{ FPlatformTime::Seconds() - StartTime };
+		SpawnTotal += WaveTime;
+		Result.SpawnWorst = FMath::Max(Result.SpawnWorst, WaveTime * 1000.0);
+
+		for (AActor* Actor : Wave)
+		{
+			if (IsValid(Actor)) { Actor->Destroy(); }
+		}
+		Wave.Reset();
+	}
+
+	// Pre-warming happens during load in a real session, so it is left out of the timings
+	Prewarm(ActorClass, WaveSize);
+
+	double PoolTotal{ 0.0 };
+	for (int32 WaveIndex = 0; WaveIndex < Waves; WaveIndex++)
+	{
+		const double StartTime{ FPlatformTime::Seconds() };
+		for (int32 i = 0; i < WaveSize; i++)
+		{
+			Wave.Add(Acquire(ActorClass, GetBenchmarkTransform(i)));
+		}
+		const double WaveTime{ FPlatformTime::Seconds() - StartTime };
+		PoolTotal += WaveTime;
+		Result.PoolWorst = FMath::Max(Result.PoolWorst, WaveTime * 1000.0);
+
+		OnPoolWave(Wave);
+
+		for (AActor* Actor : Wave)
+		{
+			Release(Actor);
+		}
+		Wave.Reset();
+	}
+
+	Result.SpawnAverage = SpawnTotal * 1000.0 / Waves;
+	Result.PoolAverage = PoolTotal * 1000.0 / Waves;
+	return Result;
+}
+
+FTransform UActorPoolSubsystem::GetBenchmarkTransform(int32 Index)
+{
+	// Spread each wave on a grid away from the players so the spawns do not collide with each other
+	return FTransform(FVector(50000.0 + 200.0 * (Index % 10), 50000.0 + 200.0 * (Index / 10), 0.0));
+}
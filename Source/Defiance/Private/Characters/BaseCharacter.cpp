@@ -2,21 +2,29 @@
 
 
 #include "Characters/BaseCharacter.h"
+#include "MemoryTags.h"
 #include "Animation/BaseAnimInstance_ABP.h"
-#include "GameFramework/SpringArmComponent.h"
+#include "Characters/DefianceSpringArmComponent.h"
 #include "Camera/CameraComponent.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Net/UnrealNetwork.h"
+#include "Characters/DefianceMovementComponent.h"
 
 // Sets default values
-ABaseCharacter::ABaseCharacter()
+ABaseCharacter::ABaseCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UDefianceMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	LLM_SCOPE_BYTAG(Defiance);
 
+ 	// The character itself has nothing to do every frame; its components tick on their own (Blueprints with an Event Tick turn it back on)
+	PrimaryActorTick.bCanEverTick = false;
 
+
+	// The camera exists in every build so server and client share one component layout (Blueprint overrides and
+	// references depend on it); dedicated servers switch it off in BeginPlay
 	// Create a camera boom (pulls in towards the player if there is a collision)
-	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
+	CameraBoom = CreateDefaultSubobject<UDefianceSpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
 	CameraBoom->TargetArmLength = 400.0f; // The camera follows at this distance behind the character	
 	CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
@@ -26,6 +34,10 @@ ABaseCharacter::ABaseCharacter()
 	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
 	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
 
+#if UE_SERVER
+	// Dedicated servers never render, so only montages (root motion) need to be evaluated
+	GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+#endif
 
 	//// Configure character movement
 	GetCharacterMovement()->bOrientRotationToMovement = true; // Character moves in the direction of input...	
@@ -47,21 +59,24 @@ void ABaseCharacter::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Nobody looks through the camera of a dedicated server
+	if (GetNetMode() == NM_DedicatedServer)
+	{
+		CameraBoom->SetComponentTickEnabled(false);
+		CameraBoom->bDoCollisionTest = false;
+		FollowCamera->SetComponentTickEnabled(false);
+	}
+
+#if !UE_SERVER
 	AnimInstance = Cast<UBaseAnimInstance_ABP>(GetMesh()->GetAnimInstance());
 	if (!IsValid(AnimInstance)) {
 		UE_LOG(LogTemp, Error, TEXT("ABaseCharacter [BeginPlay]: The animation instance has not been set."))
 			return;
 	}
+#endif
 	
 }
 
-// Called every frame
-void ABaseCharacter::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-}
-
 // Called to bind functionality to input
 void ABaseCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
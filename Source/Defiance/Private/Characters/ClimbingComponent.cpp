@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/ClimbingComponent.h"
+#include "Characters/DefianceMovementComponent.h"
+#include "Characters/SwingComponent.h"
+#include "Environment/ClimbGraphActor.h"
+#include "Network/NetTelemetrySubsystem.h"
+#include "GameFramework/Character.h"
+
+
+// Sets default values for this component's properties
+UClimbingComponent::UClimbingComponent()
+{
+	// Climbing is driven by input events and simulated by the movement component; there is nothing to do per frame
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+
+// Called when the game starts
+void UClimbingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OwnerRef = GetOwner<ACharacter>();
+	MovementComp = Cast<UDefianceMovementComponent>(OwnerRef->GetCharacterMovement());
+	ClimbGraph = GetWorld()->GetSubsystem<UClimbGraphSubsystem>();
+
+	if (!IsValid(MovementComp))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UClimbingComponent [BeginPlay]: The owner does not use UDefianceMovementComponent."))
+		return;
+	}
+
+	MovementComp->OnClimbTransition.AddUObject(this, &UClimbingComponent::HandleClimbTransition);
+}
+
+void UClimbingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsValid(MovementComp))
+	{
+		MovementComp->OnClimbTransition.RemoveAll(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UClimbingComponent::HandleClimbTransition(EClimbTransition Transition)
+{
+	OnClimbTransitionDelegate.Broadcast(Transition);
+}
+
+
+
+bool UClimbingComponent::IsClimbing() const
+{
+	return IsValid(MovementComp) && MovementComp->IsClimbing();
+}
+
+EClimbStance UClimbingComponent::GetClimbStance() const
+{
+	return IsValid(MovementComp) ? MovementComp->GetClimbStance() : EClimbStance::Hanging;
+}
+
+bool UClimbingComponent::TryGrab()
+{
+	if (!IsValid(MovementComp) || !IsValid(ClimbGraph)) { return false; }
+	if (MovementComp->IsClimbing()) { return false; }
+
+	float Alpha;
+	FClimbEdgeHandle Edge{ ClimbGraph->FindNearestEdge(MovementComp->GetClimbHandLocation(), MovementComp->ClimbGrabRadius, Alpha) };
+	if (!Edge.IsValid()) { return false; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Climb); }
+	MovementComp->RequestGrab(Edge);
+	return true;
+}
+
+void UClimbingComponent::Shimmy(float AxisValue)
+{
+	if (!IsClimbing()) { return; }
+
+	// Shimmying is plain movement input; the climbing movement mode projects it onto the edge
+	OwnerRef->AddMovementInput(OwnerRef->GetActorRightVector(), AxisValue);
+}
+
+void UClimbingComponent::Ascend()
+{
+	if (!IsClimbing()) { return; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Climb); }
+	MovementComp->RequestClimbTransition(EClimbTransition::Ascent);
+}
+
+void UClimbingComponent::Descend()
+{
+	if (!IsClimbing()) { return; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Climb); }
+	MovementComp->RequestClimbTransition(EClimbTransition::Descent);
+}
+
+void UClimbingComponent::Pivot()
+{
+	if (!IsClimbing()) { return; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Climb); }
+	MovementComp->RequestClimbTransition(EClimbTransition::Pivot);
+}
+
+bool UClimbingComponent::JumpToEdge(FVector Direction)
+{
+	if (!IsClimbing() || !IsValid(ClimbGraph) || Direction.IsNearlyZero()) { return false; }
+
+	float Alpha;
+	FClimbEdgeHandle Target{ ClimbGraph->FindJumpTarget(MovementComp->GetClimbHandLocation(), Direction.GetSafeNormal(), MovementComp->ClimbMaxJumpDistance, MovementComp->ClimbEdge, Alpha) };
+	if (!Target.IsValid()) { return false; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Climb); }
+	MovementComp->RequestClimbTransition(EClimbTransition::Jump, Target);
+	return true;
+}
+
+bool UClimbingComponent::Swing()
+{
+	if (!IsClimbing() || GetClimbStance() != EClimbStance::Swinging || !IsValid(ClimbGraph)) { return false; }
+
+	USwingComponent* SwingComp{ OwnerRef->FindComponentByClass<USwingComponent>() };
+	const FClimbEdge* Edge{ ClimbGraph->GetEdge(MovementComp->ClimbEdge) };
+	if (!IsValid(SwingComp) || !Edge) { return false; }
+
+	// Telemetry is recorded by the swing component
+	SwingComp->StartSwing(Edge->GetPoint(MovementComp->ClimbAlpha), Edge->Type);
+	return SwingComp->bIsSwinging;
+}
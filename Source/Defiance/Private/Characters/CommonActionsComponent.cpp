@@ -2,13 +2,18 @@
 
 
 #include "Characters/CommonActionsComponent.h"
+#include "MemoryTags.h"
 #include "BasicSupportLibrary.h"
+#include "Network/NetTelemetrySubsystem.h"
+#include "Network/ActionValidationSubsystem.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/CharacterMovementComponent.h"
-#include "GameFramework/SpringArmComponent.h"
+#include "Characters/DefianceSpringArmComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Net/UnrealNetwork.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Engine/AssetManager.h"
+#include "Animation/AnimMontage.h"
 
 
 
@@ -17,7 +22,8 @@ UCommonActionsComponent::UCommonActionsComponent()
 {
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
+	// Everything happens in response to input or replication, so there is nothing to tick
+	PrimaryComponentTick.bCanEverTick = false;
 
 	SetIsReplicated(true);
 }
@@ -55,23 +61,81 @@ void UCommonActionsComponent::BeginPlay()
 	OwnerRef = GetOwner<ACharacter>();
 	Controller = GetWorld()->GetFirstPlayerController();
 	MovementComp = OwnerRef->GetCharacterMovement();
-	CameraBoomLocation = OwnerRef->FindComponentByClass<USpringArmComponent>()->GetRelativeLocation();
+
+#if !UE_SERVER
+	CameraBoom = OwnerRef->FindComponentByClass<UDefianceSpringArmComponent>();
+#endif
 
 
 	// Initialization
 	MovementComp->MaxWalkSpeed = MaxRunSpeed;
 	MovementComp->MaxWalkSpeedCrouched = MaxCrouchSpeed;
 	MovementComp->NavAgentProps.bCanCrouch = bCanCrouch;	
+
+	RequestMontagesAsyncLoad();
 }
 
 
-// Called every frame
-void UCommonActionsComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UCommonActionsComponent::RequestMontagesAsyncLoad()
+{
+	LLM_SCOPE_BYTAG(Defiance_CommonActions);
+
+	TArray<FSoftObjectPath> DodgeMontagePaths;
+	for (const TPair<EDetailedDirection, TSoftObjectPtr<UAnimMontage>>& Montage : DodgeAnimMontage)
+	{
+		if (!Montage.Value.IsNull()) { DodgeMontagePaths.Add(Montage.Value.ToSoftObjectPath()); }
+	}
+
+	TArray<FSoftObjectPath> RollMontagePaths;
+	for (const TPair<EDetailedDirection, TSoftObjectPtr<UAnimMontage>>& Montage : RollAnimMontage)
+	{
+		if (!Montage.Value.IsNull()) { RollMontagePaths.Add(Montage.Value.ToSoftObjectPath()); }
+	}
+
+	FStreamableManager& StreamableManager{ UAssetManager::GetStreamableManager() };
+
+	// Dodge is the first action a player reaches for, so it is streamed ahead of everything else
+	if (DodgeMontagePaths.Num() > 0)
+	{
+		DodgeMontagesHandle = StreamableManager.RequestAsyncLoad(DodgeMontagePaths, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	if (RollMontagePaths.Num() > 0)
+	{
+		RollMontagesHandle = StreamableManager.RequestAsyncLoad(RollMontagePaths, FStreamableDelegate(), FStreamableManager::DefaultAsyncLoadPriority);
+	}
+}
+
+UAnimMontage* UCommonActionsComponent::GetMontage(const TMap<EDetailedDirection, TSoftObjectPtr<UAnimMontage>>& Montages, EDetailedDirection DetailedDirection) const
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	const TSoftObjectPtr<UAnimMontage>* Montage{ Montages.Find(DetailedDirection) };
+	if (Montage == nullptr || Montage->IsNull()) { return nullptr; }
+
+	if (UAnimMontage* LoadedMontage{ Montage->Get() }) { return LoadedMontage; }
+
+	UE_LOG(LogTemp, Warning, TEXT("UCommonActionsComponent [GetMontage]: %s was requested before streaming finished; loading synchronously."), *Montage->ToString())
+	LLM_SCOPE_BYTAG(Defiance_CommonActions);
+	return Montage->LoadSynchronous();
 }
 
 
+void UCommonActionsComponent::OnReleasedToPool()
+{
+	if (!IsValid(OwnerRef) || !IsValid(MovementComp)) { return; }
+
+	OwnerRef->StopAnimMontage();
+	bIsDodging = false;
+	bIsRolling = false;
+	bUseDirectionalMovement = false;
+
+	bIsSprinting = false;
+	OnRep_IsSprinting();
+	bIsCrouching = false;
+	OnRep_IsCrouching();
+	MovementStance = EMovementStance::Running;
+	OnRep_MovementStance();
+}
+
 void UCommonActionsComponent::OnRep_MovementStance()
 {
 	OnUpdatedMovementStanceDelegate.Broadcast(MovementStance);
@@ -108,12 +172,16 @@ void UCommonActionsComponent::ToggleSprint()
 {
 	if (!IsValid(MovementComp) || !IsValid(OwnerRef)) { return; }
 
+	UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) };
+
 	if (!bIsSprinting)
 	{
+		if (Telemetry) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::StartSprint); }
 		SR_StartSprint();
 	}
 	else
 	{
+		if (Telemetry) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::EndSprint); }
 		SR_EndSprint();
 	}
 }
@@ -174,12 +242,16 @@ void UCommonActionsComponent::ToggleCrouch()
 {
 	if (!IsValid(MovementComp) || !IsValid(OwnerRef)) { return; }
 
+	UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) };
+
 	if (!bIsCrouching)
 	{
+		if (Telemetry) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::StartCrouch); }
 		SR_StartCrouch();
 	}
 	else
 	{
+		if (Telemetry) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::EndCrouch); }
 		SR_EndCrouch();
 	}
 }
@@ -193,17 +265,22 @@ void UCommonActionsComponent::OnRep_IsCrouching()
 		{
 			OwnerRef->Crouch();
 
-			USpringArmComponent* CameraBoom{ OwnerRef->FindComponentByClass<USpringArmComponent>() };
-			float CapsuleHalfHeight{ OwnerRef->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight() };
-			float CapsuleHalfHeightCrouched{ MovementComp->GetCrouchedHalfHeight() };
-			CameraBoom->SetRelativeLocation(FVector(0.f, 0.f, (CapsuleHalfHeight - CapsuleHalfHeightCrouched)));
+#if !UE_SERVER
+			if (IsValid(CameraBoom))
+			{
+				float CapsuleHalfHeight{ OwnerRef->GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight() };
+				float CapsuleHalfHeightCrouched{ MovementComp->GetCrouchedHalfHeight() };
+				CameraBoom->SetCrouchOffset(CapsuleHalfHeight - CapsuleHalfHeightCrouched);
+			}
+#endif
 		}
 		else
 		{
 			OwnerRef->UnCrouch();
 
-			USpringArmComponent* CameraBoom{ OwnerRef->FindComponentByClass<USpringArmComponent>() };
-			CameraBoom->SetRelativeLocation(CameraBoomLocation);
+#if !UE_SERVER
+			if (IsValid(CameraBoom)) { CameraBoom->SetCrouchOffset(0.0f); }
+#endif
 		}
 	}
 }
@@ -247,12 +324,16 @@ void UCommonActionsComponent::DodgeRoll()
 	float Angle{ static_cast<float>(MovementRotationAroundPlayer.Yaw)};
 	EDetailedDirection DetailedDirection{ UBasicSupportLibrary::GetDetailedDirectionFromAngle(Angle) };
 
+	UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) };
+
 	if (bCanDodge && !bIsDodging && !bIsRolling)
 	{
+		if (Telemetry) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Dodge); }
 		SR_Dodge(DetailedDirection);
 	}
 	else if (bCanRoll && !bIsRolling)
 	{
+		if (Telemetry) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Roll); }
 		SR_Roll(DetailedDirection);
 	}
 
@@ -262,23 +343,48 @@ void UCommonActionsComponent::DodgeRoll()
 
 bool UCommonActionsComponent::SR_Dodge_Validate(EDetailedDirection DetailedDirection)
 {
-	if (!bCanDodge || bIsDodging) { return false; }
-	return true;
+	// Only malformed requests are refused here; the state is checked when UActionValidationSubsystem applies the dodge
+	return DetailedDirection <= EDetailedDirection::Right;
 }
 
 void UCommonActionsComponent::SR_Dodge_Implementation(EDetailedDirection DetailedDirection)
 {
-	if (!DodgeAnimMontage.Contains(DetailedDirection)) return;
+	UActionValidationSubsystem* Validation{ UActionValidationSubsystem::Get(this) };
+	if (!Validation)
+	{
+		ApplyDodge(DetailedDirection);
+		return;
+	}
+
+	Validation->QueueAction(ENetAction::Dodge, OwnerRef, FApplyActionDelegate::CreateUObject(this, &UCommonActionsComponent::ApplyDodge, DetailedDirection));
+}
+
+bool UCommonActionsComponent::ApplyDodge(EDetailedDirection DetailedDirection)
+{
+	// Checked here rather than in the pass so a second dodge queued in the same frame is refused
+	if (!bCanDodge || bIsDodging) { return false; }
+
+	// A direction without a montage has nothing to play, so the request is refused rather than applied as a no-op
+	const TSoftObjectPtr<UAnimMontage>* Montage{ DodgeAnimMontage.Find(DetailedDirection) };
+	if (!Montage || Montage->IsNull()) { return false; }
 
 	bIsCrouching = false;
 	OnRep_IsCrouching();
 	bIsDodging = true;
 	NM_PlayDodgeAnim(DetailedDirection);
+	return true;
 }
 
 void UCommonActionsComponent::NM_PlayDodgeAnim_Implementation(EDetailedDirection DetailedDirection)
 {
-	float Duration{ OwnerRef->PlayAnimMontage(DodgeAnimMontage[DetailedDirection]) };
+	float Duration{ OwnerRef->PlayAnimMontage(GetMontage(DodgeAnimMontage, DetailedDirection)) };
+
+	// A timer with no duration never fires and would leave the flag set for good
+	if (Duration <= 0.0f)
+	{
+		FinishDodgeAnim();
+		return;
+	}
 
 	FTimerHandle DodgeTimerHandle;
 	OwnerRef->GetWorldTimerManager().SetTimer(
@@ -299,23 +405,47 @@ void UCommonActionsComponent::FinishDodgeAnim()
 
 bool UCommonActionsComponent::SR_Roll_Validate(EDetailedDirection DetailedDirection)
 {
-	if (!bCanRoll || bIsRolling) { return false; }
-	return true;
+	// Only malformed requests are refused here; the state is checked when UActionValidationSubsystem applies the roll
+	return DetailedDirection <= EDetailedDirection::Right;
 }
 
 void UCommonActionsComponent::SR_Roll_Implementation(EDetailedDirection DetailedDirection)
 {
-	if (!RollAnimMontage.Contains(DetailedDirection)) return;
+	UActionValidationSubsystem* Validation{ UActionValidationSubsystem::Get(this) };
+	if (!Validation)
+	{
+		ApplyRoll(DetailedDirection);
+		return;
+	}
+
+	Validation->QueueAction(ENetAction::Roll, OwnerRef, FApplyActionDelegate::CreateUObject(this, &UCommonActionsComponent::ApplyRoll, DetailedDirection));
+}
+
+bool UCommonActionsComponent::ApplyRoll(EDetailedDirection DetailedDirection)
+{
+	if (!bCanRoll || bIsRolling) { return false; }
+
+	// A direction without a montage has nothing to play, so the request is refused rather than applied as a no-op
+	const TSoftObjectPtr<UAnimMontage>* Montage{ RollAnimMontage.Find(DetailedDirection) };
+	if (!Montage || Montage->IsNull()) { return false; }
 
 	bIsCrouching = false;
 	OnRep_IsCrouching();
 	bIsRolling = true;
 	NM_PlayRollAnim(DetailedDirection);
+	return true;
 }
 
 void UCommonActionsComponent::NM_PlayRollAnim_Implementation(EDetailedDirection DetailedDirection)
 {
-	float Duration{ OwnerRef->PlayAnimMontage(RollAnimMontage[DetailedDirection]) };
+	float Duration{ OwnerRef->PlayAnimMontage(GetMontage(RollAnimMontage, DetailedDirection)) };
+
+	// A timer with no duration never fires and would leave the flag set for good
+	if (Duration <= 0.0f)
+	{
+		FinishRollAnim();
+		return;
+	}
 
 	FTimerHandle RollTimerHandle;
 	OwnerRef->GetWorldTimerManager().SetTimer(
@@ -0,0 +1,658 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/DefianceMovementComponent.h"
+#include "Environment/ClimbGraphActor.h"
+#include "Network/NetTelemetrySubsystem.h"
+#include "Network/RewindSubsystem.h"
+#include "Characters/SignificanceSubsystem.h"
+#include "Characters/GrapplingHookComponent.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+
+
+//////////////////////////////////////////////////////////////////////////
+// Network move data
+
+void FDefianceNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	const FSavedMove_Defiance& DefianceMove{ static_cast<const FSavedMove_Defiance&>(ClientMove) };
+	PackedClimbEdge = DefianceMove.SavedPackedClimbEdge;
+	ClimbTransition = DefianceMove.SavedClimbTransition;
+	bWantsToSwing = DefianceMove.bSavedWantsToSwing;
+	SwingAnchor = DefianceMove.SavedSwingAnchor;
+	SwingType = DefianceMove.SavedSwingType;
+	bWantsToLaunch = DefianceMove.bSavedWantsToLaunch;
+	LaunchGrapple = DefianceMove.SavedLaunchGrapple.Get();
+	LaunchGrappleIndex = DefianceMove.SavedLaunchGrappleIndex;
+}
+
+bool FDefianceNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// Most moves carry no climbing request, so they only cost a single bit
+	uint8 bHasClimbRequest{ (ClimbTransition != EClimbTransition::None || PackedClimbEdge != FClimbEdgeHandle().Pack()) ? uint8(1) : uint8(0) };
+	Ar.SerializeBits(&bHasClimbRequest, 1);
+
+	if (bHasClimbRequest)
+	{
+		uint8 Transition{ static_cast<uint8>(ClimbTransition) };
+		Ar << PackedClimbEdge;
+		Ar << Transition;
+		ClimbTransition = static_cast<EClimbTransition>(Transition);
+	}
+	else if (Ar.IsLoading())
+	{
+		PackedClimbEdge = FClimbEdgeHandle().Pack();
+		ClimbTransition = EClimbTransition::None;
+	}
+
+	uint8 bHasSwingRequest{ bWantsToSwing ? uint8(1) : uint8(0) };
+	Ar.SerializeBits(&bHasSwingRequest, 1);
+	bWantsToSwing = bHasSwingRequest != 0;
+
+	if (bHasSwingRequest)
+	{
+		uint8 Type{ static_cast<uint8>(SwingType) };
+		Ar << SwingAnchor;
+		Ar << Type;
+		SwingType = static_cast<EClimbableType>(Type);
+	}
+
+	uint8 bHasLaunchRequest{ bWantsToLaunch ? uint8(1) : uint8(0) };
+	Ar.SerializeBits(&bHasLaunchRequest, 1);
+	bWantsToLaunch = bHasLaunchRequest != 0;
+
+	if (bHasLaunchRequest)
+	{
+		// Grapple points are placed in the level, so they are referenced by their stable name
+		UObject* Grapple{ LaunchGrapple };
+		if (PackageMap) { PackageMap->SerializeObject(Ar, AActor::StaticClass(), Grapple); }
+		Ar << LaunchGrappleIndex;
+		LaunchGrapple = Cast<AActor>(Grapple);
+	}
+
+	return !Ar.IsError();
+}
+
+FDefianceNetworkMoveDataContainer::FDefianceNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Saved move
+
+void FSavedMove_Defiance::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToGrab = false;
+	SavedClimbTransition = EClimbTransition::None;
+	SavedPackedClimbEdge = FClimbEdgeHandle().Pack();
+	bSavedWantsToSwing = false;
+	SavedSwingAnchor = FVector::ZeroVector;
+	SavedSwingType = EClimbableType::Rope;
+	bSavedWantsToLaunch = false;
+	SavedLaunchGrapple = nullptr;
+	SavedLaunchGrappleIndex = INDEX_NONE;
+	bSavedSwinging = false;
+	SavedSwingState.Solver.Reset();
+}
+
+uint8 FSavedMove_Defiance::GetCompressedFlags() const
+{
+	uint8 Result{ Super::GetCompressedFlags() };
+
+	if (bSavedWantsToGrab) { Result |= FLAG_Custom_0; }
+
+	return Result;
+}
+
+bool FSavedMove_Defiance::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	const FSavedMove_Defiance* NewDefianceMove{ static_cast<const FSavedMove_Defiance*>(NewMove.Get()) };
+
+	// Climbing, swinging and launch requests are one-shot and must reach the server on the move they were made in
+	if (bSavedWantsToGrab || bSavedWantsToSwing || bSavedWantsToLaunch || SavedClimbTransition != EClimbTransition::None) { return false; }
+	if (NewDefianceMove->bSavedWantsToGrab || NewDefianceMove->bSavedWantsToSwing || NewDefianceMove->bSavedWantsToLaunch
+		|| NewDefianceMove->SavedClimbTransition != EClimbTransition::None) { return false; }
+
+	// A combined move would replay from the wrong swing state
+	if (bSavedSwinging || NewDefianceMove->bSavedSwinging) { return false; }
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+bool FSavedMove_Defiance::IsImportantMove(const FSavedMovePtr& LastAckedMove) const
+{
+	if (bSavedWantsToGrab || bSavedWantsToSwing || bSavedWantsToLaunch || SavedClimbTransition != EClimbTransition::None) { return true; }
+
+	return Super::IsImportantMove(LastAckedMove);
+}
+
+void FSavedMove_Defiance::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const UDefianceMovementComponent* MovementComp{ Cast<UDefianceMovementComponent>(C->GetCharacterMovement()) })
+	{
+		bSavedWantsToGrab = MovementComp->bWantsToGrab;
+		SavedClimbTransition = MovementComp->RequestedClimbTransition;
+		SavedPackedClimbEdge = MovementComp->RequestedClimbEdge.Pack();
+		bSavedWantsToSwing = MovementComp->bWantsToSwing;
+		SavedSwingAnchor = MovementComp->RequestedSwingAnchor;
+		SavedSwingType = MovementComp->RequestedSwingType;
+		bSavedWantsToLaunch = MovementComp->bWantsToLaunch;
+		SavedLaunchGrapple = MovementComp->RequestedLaunchGrapple;
+		SavedLaunchGrappleIndex = MovementComp->RequestedLaunchGrappleIndex;
+
+		// Saved before the move runs, so this is the state a replay of the move starts from
+		const USwingComponent* SwingComp{ MovementComp->GetSwingComponent() };
+		bSavedSwinging = MovementComp->IsSwinging() && IsValid(SwingComp);
+		if (bSavedSwinging) { SavedSwingState = SwingComp->GetSwingState(); }
+	}
+}
+
+void FSavedMove_Defiance::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	if (UDefianceMovementComponent* MovementComp{ Cast<UDefianceMovementComponent>(C->GetCharacterMovement()) })
+	{
+		MovementComp->bWantsToGrab = bSavedWantsToGrab;
+		MovementComp->RequestedClimbTransition = SavedClimbTransition;
+		MovementComp->RequestedClimbEdge = FClimbEdgeHandle::Unpack(SavedPackedClimbEdge);
+		MovementComp->bWantsToSwing = bSavedWantsToSwing;
+		MovementComp->RequestedSwingAnchor = SavedSwingAnchor;
+		MovementComp->RequestedSwingType = SavedSwingType;
+		MovementComp->bWantsToLaunch = bSavedWantsToLaunch;
+		MovementComp->RequestedLaunchGrapple = SavedLaunchGrapple;
+		MovementComp->RequestedLaunchGrappleIndex = SavedLaunchGrappleIndex;
+
+		// The correction can predate the swing; the replay starts it again on the move it started on
+		USwingComponent* SwingComp{ MovementComp->GetSwingComponent() };
+		if (bSavedSwinging && !MovementComp->IsSwinging() && IsValid(SwingComp))
+		{
+			SwingComp->RestoreSwingState(SavedSwingState);
+			MovementComp->SetMovementMode(MOVE_Custom, static_cast<uint8>(ECustomMovementMode::CMOVE_Swinging));
+		}
+	}
+}
+
+FNetworkPredictionData_Client_Defiance::FNetworkPredictionData_Client_Defiance(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Defiance::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Defiance());
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// UDefianceMovementComponent
+
+UDefianceMovementComponent::UDefianceMovementComponent()
+{
+	SetNetworkMoveDataContainer(DefianceNetworkMoveDataContainer);
+}
+
+void UDefianceMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ClimbGraph = GetWorld()->GetSubsystem<UClimbGraphSubsystem>();
+	SwingComponent = CharacterOwner ? CharacterOwner->FindComponentByClass<USwingComponent>() : nullptr;
+	GrapplingHookComponent = CharacterOwner ? CharacterOwner->FindComponentByClass<UGrapplingHookComponent>() : nullptr;
+
+	// Every character is recorded on the server so requests can be validated against what the client saw
+	if (URewindSubsystem* Rewind{ URewindSubsystem::Get(this) }) { Rewind->RegisterCharacter(CharacterOwner); }
+
+	if (USignificanceSubsystem* Significance{ USignificanceSubsystem::Get(this) }) { Significance->RegisterCharacter(CharacterOwner); }
+}
+
+void UDefianceMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (URewindSubsystem* Rewind{ URewindSubsystem::Get(this) }) { Rewind->UnregisterCharacter(CharacterOwner); }
+
+	if (USignificanceSubsystem* Significance{ USignificanceSubsystem::Get(this) }) { Significance->UnregisterCharacter(CharacterOwner); }
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UDefianceMovementComponent::ClientAdjustPosition_Implementation(float TimeStamp, FVector NewLoc, FVector NewVel, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode, TOptional<FRotator> OptionalRotation)
+{
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) })
+	{
+		Telemetry->RecordCorrection(GetOwner());
+	}
+
+	Super::ClientAdjustPosition_Implementation(TimeStamp, NewLoc, NewVel, NewBase, NewBaseBoneName, bHasBase, bBaseRelativePosition, ServerMovementMode, OptionalRotation);
+
+	ResyncClimbState();
+}
+
+FNetworkPredictionData_Client* UDefianceMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UDefianceMovementComponent* MutableThis{ const_cast<UDefianceMovementComponent*>(this) };
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Defiance(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+bool UDefianceMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	FNetworkPredictionData_Client_Character* ClientData{ GetPredictionData_Client_Character() };
+
+	// The correction only carries the character, so the swing is rewound to the first move that is replayed and its end
+	// is moved to where the server has the character
+	if (ClientData && ClientData->bUpdatePosition && IsSwinging() && IsValid(SwingComponent))
+	{
+		const FSavedMove_Defiance* FirstMove{ ClientData->SavedMoves.Num() > 0 ? static_cast<const FSavedMove_Defiance*>(ClientData->SavedMoves[0].Get()) : nullptr };
+		if (FirstMove && FirstMove->bSavedSwinging) { SwingComponent->RestoreSwingState(FirstMove->SavedSwingState); }
+
+		SwingComponent->SyncToCharacter(UpdatedComponent->GetComponentLocation(), Velocity);
+	}
+
+	return Super::ClientUpdatePositionAfterServerUpdate();
+}
+
+void UDefianceMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToGrab = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+}
+
+void UDefianceMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+	// On the server, pick up the climbing, swinging and launch requests the client sent with this move
+	if (const FDefianceNetworkMoveData* MoveData{ static_cast<const FDefianceNetworkMoveData*>(GetCurrentNetworkMoveData()) })
+	{
+		RequestedClimbEdge = FClimbEdgeHandle::Unpack(MoveData->PackedClimbEdge);
+		RequestedClimbTransition = MoveData->ClimbTransition;
+
+		// Only the anchor and type come from the client; the swing starts from our own location and velocity
+		const UEnum* ClimbableTypeEnum{ StaticEnum<EClimbableType>() };
+		const int64 TypeValue{ static_cast<int64>(MoveData->SwingType) };
+		const bool bValidType{ ClimbableTypeEnum->IsValidEnumValue(TypeValue) && TypeValue < ClimbableTypeEnum->GetMaxEnumValue() };
+
+		bWantsToSwing = MoveData->bWantsToSwing && bValidType && !MoveData->SwingAnchor.ContainsNaN();
+		RequestedSwingAnchor = MoveData->SwingAnchor;
+		RequestedSwingType = MoveData->SwingType;
+
+		if (MoveData->bWantsToSwing && !bWantsToSwing)
+		{
+			if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordRejectedValidation(ENetAction::Swing); }
+		}
+
+		// The grapple is checked when the move applies the launch
+		bWantsToLaunch = MoveData->bWantsToLaunch;
+		RequestedLaunchGrapple = MoveData->LaunchGrapple;
+		RequestedLaunchGrappleIndex = MoveData->LaunchGrappleIndex;
+	}
+
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+}
+
+
+
+/*-------------------------------------------CLIMBING-------------------------------------------*/
+
+void UDefianceMovementComponent::RequestGrab(FClimbEdgeHandle Edge)
+{
+	bWantsToGrab = true;
+	RequestedClimbEdge = Edge;
+}
+
+void UDefianceMovementComponent::RequestClimbTransition(EClimbTransition Transition, FClimbEdgeHandle TargetEdge)
+{
+	RequestedClimbTransition = Transition;
+	RequestedClimbEdge = TargetEdge;
+}
+
+bool UDefianceMovementComponent::IsClimbing() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Climbing);
+}
+
+void UDefianceMovementComponent::RequestSwing(const FVector& Anchor, EClimbableType Type)
+{
+	bWantsToSwing = true;
+	RequestedSwingAnchor = Anchor;
+	RequestedSwingType = Type;
+}
+
+void UDefianceMovementComponent::RequestGrappleLaunch(AActor* Grapple, int32 Index)
+{
+	bWantsToLaunch = true;
+	RequestedLaunchGrapple = Grapple;
+	RequestedLaunchGrappleIndex = Index;
+}
+
+bool UDefianceMovementComponent::IsSwinging() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Swinging);
+}
+
+EClimbStance UDefianceMovementComponent::GetClimbStance() const
+{
+	if (!IsClimbing() || !IsValid(ClimbGraph)) { return EClimbStance::Hanging; }
+
+	// Simulated proxies do not run the climbing simulation, so look the edge up from where they are
+	FClimbEdgeHandle Edge{ ClimbEdge };
+	if (!Edge.IsValid())
+	{
+		float Alpha;
+		Edge = ClimbGraph->FindNearestEdge(GetClimbHandLocation(), ClimbGrabRadius, Alpha);
+	}
+
+	const FClimbEdge* EdgeData{ ClimbGraph->GetEdge(Edge) };
+	return EdgeData ? UClimbGraphSubsystem::GetStanceForType(EdgeData->Type) : EClimbStance::Hanging;
+}
+
+FVector UDefianceMovementComponent::GetClimbHandLocation() const
+{
+	if (IsClimbing())
+	{
+		return UpdatedComponent->GetComponentLocation()
+			+ UpdatedComponent->GetForwardVector() * ClimbHangOffset.X
+			+ FVector::UpVector * ClimbHangOffset.Y;
+	}
+
+	return UpdatedComponent->GetComponentLocation() + FVector::UpVector * ClimbHandHeight;
+}
+
+FTransform UDefianceMovementComponent::GetClimbHangTransform(const FClimbEdge& Edge, float Alpha) const
+{
+	const FVector Facing{ bClimbPivoted ? FVector(Edge.Normal) : -FVector(Edge.Normal) };
+	const FVector Location{ Edge.GetPoint(Alpha) - Facing * ClimbHangOffset.X - FVector::UpVector * ClimbHangOffset.Y };
+
+	return FTransform(FRotator(0.0f, Facing.Rotation().Yaw, 0.0f), Location);
+}
+
+void UDefianceMovementComponent::BroadcastClimbTransition(EClimbTransition Transition)
+{
+	// Replayed moves already announced their transitions the first time they ran
+	if (Transition == EClimbTransition::None) { return; }
+	if (CharacterOwner && CharacterOwner->bClientUpdating) { return; }
+
+	OnClimbTransition.Broadcast(Transition);
+}
+
+bool UDefianceMovementComponent::EnterClimbing(FClimbEdgeHandle Edge, float MaxDistance, EClimbTransition Transition)
+{
+	const FClimbEdge* EdgeData{ IsValid(ClimbGraph) ? ClimbGraph->GetEdge(Edge) : nullptr };
+	if (!EdgeData) { return false; }
+
+	// Both sides derive the grab point from the edge and their own location, so only the edge has to be sent
+	const FVector HandLocation{ GetClimbHandLocation() };
+	const FVector Start{ EdgeData->Start };
+	const FVector End{ EdgeData->End };
+	const FVector ClosestPoint{ FMath::ClosestPointOnSegment(HandLocation, Start, End) };
+	if (FVector::Distance(HandLocation, ClosestPoint) > MaxDistance) { return false; }
+
+	const float Length{ EdgeData->GetLength() };
+	ClimbEdge = Edge;
+	ClimbAlpha = (Length > UE_KINDA_SMALL_NUMBER) ? static_cast<float>(FVector::Distance(Start, ClosestPoint)) / Length : 0.0f;
+
+	if (!IsClimbing())
+	{
+		bClimbPivoted = false;
+		SetMovementMode(MOVE_Custom, static_cast<uint8>(ECustomMovementMode::CMOVE_Climbing));
+	}
+
+	BroadcastClimbTransition(Transition);
+	return true;
+}
+
+void UDefianceMovementComponent::ResyncClimbState()
+{
+	if (!IsClimbing() || !IsValid(ClimbGraph))
+	{
+		ClimbEdge = FClimbEdgeHandle();
+		return;
+	}
+
+	// The correction carries our location but not the edge; keep ours if we are still on it
+	const FVector HandLocation{ GetClimbHandLocation() };
+	const float MaxDistance{ ClimbGrabRadius + ClimbGrabTolerance };
+	const FClimbEdge* EdgeData{ ClimbGraph->GetEdge(ClimbEdge) };
+
+	if (!EdgeData || FVector::Distance(HandLocation, FMath::ClosestPointOnSegment(HandLocation, FVector(EdgeData->Start), FVector(EdgeData->End))) > MaxDistance)
+	{
+		float Alpha;
+		ClimbEdge = ClimbGraph->FindNearestEdge(HandLocation, MaxDistance, Alpha);
+		EdgeData = ClimbGraph->GetEdge(ClimbEdge);
+	}
+
+	if (!EdgeData)
+	{
+		SetMovementMode(MOVE_Falling);
+		return;
+	}
+
+	const FVector Start{ EdgeData->Start };
+	const FVector End{ EdgeData->End };
+	const float Length{ EdgeData->GetLength() };
+	const FVector ClosestPoint{ FMath::ClosestPointOnSegment(HandLocation, Start, End) };
+	ClimbAlpha = (Length > UE_KINDA_SMALL_NUMBER) ? static_cast<float>(FVector::Distance(Start, ClosestPoint)) / Length : 0.0f;
+	bClimbPivoted = FVector::DotProduct(UpdatedComponent->GetForwardVector(), FVector(EdgeData->Normal)) > 0.0;
+}
+
+void UDefianceMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	if (bWantsToGrab && !IsClimbing())
+	{
+		EnterClimbing(RequestedClimbEdge, ClimbGrabRadius + ClimbGrabTolerance, EClimbTransition::None);
+	}
+	else if (IsClimbing())
+	{
+		const FClimbEdge* EdgeData{ ClimbGraph->GetEdge(ClimbEdge) };
+
+		switch (RequestedClimbTransition)
+		{
+		case EClimbTransition::Ascent:
+			// Room on top was verified when the graph was baked
+			if (EdgeData && EdgeData->bCanAscend)
+			{
+				const UCapsuleComponent* Capsule{ CharacterOwner->GetCapsuleComponent() };
+				const FVector StandLocation{ EdgeData->GetPoint(ClimbAlpha)
+					- FVector(EdgeData->Normal) * (Capsule->GetScaledCapsuleRadius() + 10.0f)
+					+ FVector::UpVector * (Capsule->GetScaledCapsuleHalfHeight() + 2.0f) };
+
+				UpdatedComponent->SetWorldLocation(StandLocation, false, nullptr, ETeleportType::TeleportPhysics);
+				SetMovementMode(MOVE_Walking);
+				BroadcastClimbTransition(EClimbTransition::Ascent);
+			}
+			break;
+
+		case EClimbTransition::Descent:
+			SetMovementMode(MOVE_Falling);
+			BroadcastClimbTransition(EClimbTransition::Descent);
+			break;
+
+		case EClimbTransition::Pivot:
+			if (GetClimbStance() == EClimbStance::Swinging)
+			{
+				bClimbPivoted = !bClimbPivoted;
+				BroadcastClimbTransition(EClimbTransition::Pivot);
+			}
+			break;
+
+		case EClimbTransition::Jump:
+			EnterClimbing(RequestedClimbEdge, ClimbMaxJumpDistance + ClimbGrabTolerance, EClimbTransition::Jump);
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	// Started here rather than by an RPC, so the server starts the swing on the same move the client did
+	if (bWantsToSwing && !IsSwinging() && IsValid(SwingComponent))
+	{
+		SwingComponent->BeginSwingFromMove(RequestedSwingAnchor, RequestedSwingType);
+	}
+
+	// Launched here rather than by the caller, so the server launches on the same move and from its own location;
+	// the pending launch is applied further on in this move
+	if (bWantsToLaunch && IsValid(GrapplingHookComponent))
+	{
+		GrapplingHookComponent->LaunchFromMove(RequestedLaunchGrapple.Get(), RequestedLaunchGrappleIndex);
+	}
+
+	// Requests only apply to the move they were made in; replays restore them through PrepMoveFor
+	bWantsToGrab = false;
+	bWantsToSwing = false;
+	bWantsToLaunch = false;
+	RequestedLaunchGrapple = nullptr;
+	RequestedLaunchGrappleIndex = INDEX_NONE;
+	RequestedClimbTransition = EClimbTransition::None;
+	RequestedClimbEdge = FClimbEdgeHandle();
+}
+
+void UDefianceMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	if (IsClimbing())
+	{
+		Velocity = FVector::ZeroVector;
+	}
+	else if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Climbing))
+	{
+		ClimbEdge = FClimbEdgeHandle();
+		bClimbPivoted = false;
+	}
+
+	if (!IsSwinging() && PreviousMovementMode == MOVE_Custom && PreviousCustomMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Swinging))
+	{
+		if (IsValid(SwingComponent)) { SwingComponent->HandleSwingEnded(); }
+	}
+}
+
+void UDefianceMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	Super::PhysCustom(deltaTime, Iterations);
+
+	if (CustomMovementMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Climbing))
+	{
+		PhysClimbing(deltaTime, Iterations);
+	}
+	else if (CustomMovementMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Swinging))
+	{
+		PhysSwinging(deltaTime, Iterations);
+	}
+}
+
+void UDefianceMovementComponent::PhysicsRotation(float DeltaTime)
+{
+	// While climbing or swinging the rotation is set by PhysClimbing / PhysSwinging
+	if (IsClimbing() || IsSwinging()) { return; }
+
+	Super::PhysicsRotation(DeltaTime);
+}
+
+void UDefianceMovementComponent::PhysClimbing(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME) { return; }
+
+	const FClimbEdge* EdgeData{ IsValid(ClimbGraph) ? ClimbGraph->GetEdge(ClimbEdge) : nullptr };
+	if (!EdgeData)
+	{
+		// The cell holding the edge streamed out from under us
+		SetMovementMode(MOVE_Falling);
+		StartNewPhysics(DeltaTime, Iterations);
+		return;
+	}
+
+	// Shimmy along the edge with the part of the input that points along it
+	const FVector EdgeDirection{ FVector(EdgeData->End - EdgeData->Start).GetSafeNormal() };
+	const float MaxAccel{ GetMaxAcceleration() };
+	const float Input{ (MaxAccel > 0.0f) ? FMath::Clamp(static_cast<float>(FVector::DotProduct(Acceleration, EdgeDirection)) / MaxAccel, -1.0f, 1.0f) : 0.0f };
+	const float Length{ FMath::Max(EdgeData->GetLength(), UE_KINDA_SMALL_NUMBER) };
+	float NewAlpha{ ClimbAlpha + Input * ClimbShimmySpeed * DeltaTime / Length };
+
+	if (NewAlpha > 1.0f || NewAlpha < 0.0f)
+	{
+		// Continue onto the connected edge, carrying over the distance past the end
+		const bool bForward{ NewAlpha > 1.0f };
+		EClimbTransition Transition;
+		const FClimbEdgeHandle Neighbour{ ClimbGraph->GetNeighbour(ClimbEdge, bForward, Transition) };
+
+		if (const FClimbEdge* NeighbourData{ ClimbGraph->GetEdge(Neighbour) })
+		{
+			const float Overshoot{ (bForward ? NewAlpha - 1.0f : -NewAlpha) * Length };
+			const float NeighbourAlpha{ FMath::Clamp(Overshoot / FMath::Max(NeighbourData->GetLength(), UE_KINDA_SMALL_NUMBER), 0.0f, 1.0f) };
+
+			ClimbEdge = Neighbour;
+			EdgeData = NeighbourData;
+			NewAlpha = bForward ? NeighbourAlpha : 1.0f - NeighbourAlpha;
+			BroadcastClimbTransition(Transition);
+		}
+	}
+
+	ClimbAlpha = FMath::Clamp(NewAlpha, 0.0f, 1.0f);
+
+	// Travel towards the hang point; this also covers the flight after a grab or a jump
+	const FTransform HangTransform{ GetClimbHangTransform(*EdgeData, ClimbAlpha) };
+	const FVector ToTarget{ HangTransform.GetLocation() - UpdatedComponent->GetComponentLocation() };
+	const FVector Delta{ ToTarget.GetClampedToMaxSize(FMath::Max(ClimbSnapSpeed, ClimbShimmySpeed) * DeltaTime) };
+
+	Velocity = Delta / DeltaTime;
+
+	FHitResult Hit(1.0f);
+	SafeMoveUpdatedComponent(Delta, HangTransform.GetRotation(), true, Hit);
+
+	if (Hit.IsValidBlockingHit())
+	{
+		SlideAlongSurface(Delta, 1.0f - Hit.Time, Hit.Normal, Hit, true);
+	}
+}
+
+void UDefianceMovementComponent::PhysSwinging(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME) { return; }
+
+	if (!IsValid(SwingComponent) || !SwingComponent->GetSwingState().Solver.IsActive())
+	{
+		SetMovementMode(MOVE_Falling);
+		StartNewPhysics(DeltaTime, Iterations);
+		return;
+	}
+
+	// The input pumps the swing, like it shimmies while climbing
+	const float MaxAccel{ GetMaxAcceleration() };
+	const FVector PumpInput{ (MaxAccel > 0.0f) ? Acceleration / MaxAccel : FVector::ZeroVector };
+
+	// Solved as part of the move, so the server and a replay after a correction step it with the same time and input
+	FVector SwingLocation;
+	FQuat SwingRotation;
+	SwingComponent->SimulateSwing(DeltaTime, PumpInput, SwingLocation, SwingRotation);
+
+	const FVector Delta{ SwingLocation - UpdatedComponent->GetComponentLocation() };
+
+	Velocity = Delta / DeltaTime;
+
+	FHitResult Hit(1.0f);
+	SafeMoveUpdatedComponent(Delta, SwingRotation, true, Hit);
+
+	if (Hit.IsValidBlockingHit())
+	{
+		SlideAlongSurface(Delta, 1.0f - Hit.Time, Hit.Normal, Hit, true);
+	}
+}
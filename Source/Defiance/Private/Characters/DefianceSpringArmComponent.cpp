@@ -0,0 +1,144 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/DefianceSpringArmComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+
+
+UDefianceSpringArmComponent::UDefianceSpringArmComponent()
+{
+	ProbeParams = FCollisionQueryParams{ SCENE_QUERY_STAT(SpringArm), false };
+}
+
+
+void UDefianceSpringArmComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OwnerRef = GetOwner<APawn>();
+	CapsuleRef = Cast<UCapsuleComponent>(GetAttachParent());
+	if (CapsuleRef) { LastCapsuleHalfHeight = CapsuleRef->GetUnscaledCapsuleHalfHeight(); }
+
+	BaseRelativeLocation = GetRelativeLocation();
+
+	ProbeParams.AddIgnoredActor(GetOwner());
+	ProbeTraceDelegate.BindUObject(this, &UDefianceSpringArmComponent::HandleProbeTrace);
+}
+
+
+void UDefianceSpringArmComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	// The capsule moves its center when it changes height, which the offset takes back so the view does not pop
+	if (CapsuleRef)
+	{
+		const float CapsuleHalfHeight{ CapsuleRef->GetUnscaledCapsuleHalfHeight() };
+		CrouchOffset -= CapsuleHalfHeight - LastCapsuleHalfHeight;
+		LastCapsuleHalfHeight = CapsuleHalfHeight;
+	}
+
+	if (!FMath::IsNearlyEqual(CrouchOffset, TargetCrouchOffset))
+	{
+		CrouchOffset = FMath::FInterpTo(CrouchOffset, TargetCrouchOffset, DeltaTime, CrouchInterpSpeed);
+		SetRelativeLocation(BaseRelativeLocation + FVector(0.0f, 0.0f, CrouchOffset));
+	}
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+
+void UDefianceSpringArmComponent::SetCrouchOffset(float NewCrouchOffset)
+{
+	TargetCrouchOffset = NewCrouchOffset;
+}
+
+
+bool UDefianceSpringArmComponent::IsViewedLocally() const
+{
+	if (OwnerRef && OwnerRef->IsLocallyControlled()) { return true; }
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController{ It->Get() };
+		if (PlayerController && PlayerController->IsLocalController() && PlayerController->GetViewTarget() == GetOwner()) { return true; }
+	}
+
+	return false;
+}
+
+
+void UDefianceSpringArmComponent::UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime)
+{
+	// Nobody looks through the booms of the other characters, so they never probe
+	if (bDoTrace && !IsViewedLocally()) { bDoTrace = false; }
+
+	if (!bAsyncProbe || !bDoTrace || TargetArmLength == 0.0f)
+	{
+		CollisionArmLength = -1.0f;
+		Super::UpdateDesiredArmLocation(bDoTrace, bDoLocationLag, bDoRotationLag, DeltaTime);
+		return;
+	}
+
+	// Lag and the unobstructed arm end are solved as usual; only the collision is taken from the probes
+	Super::UpdateDesiredArmLocation(false, bDoLocationLag, bDoRotationLag, DeltaTime);
+
+	const FVector ArmOrigin{ PreviousArmOrigin };
+	const FVector DesiredLoc{ PreviousDesiredLoc };
+	const FVector ArmVector{ DesiredLoc - ArmOrigin };
+	const float ArmLength{ static_cast<float>(ArmVector.Size()) };
+
+	// The last result is a frame old; a hit that is closing in is carried on by one more frame
+	float TargetLength{ ArmLength };
+	if (bProbeHit)
+	{
+		const float PredictedDistance{ bPreviousProbeHit ? 2.0f * ProbeHitDistance - PreviousProbeHitDistance : ProbeHitDistance };
+		TargetLength = FMath::Clamp(FMath::Min(PredictedDistance, ProbeHitDistance), 0.0f, ArmLength);
+	}
+
+	// Pulling in must be immediate to keep the camera out of walls; extending again is smoothed
+	if (CollisionArmLength < 0.0f || TargetLength < CollisionArmLength) { CollisionArmLength = TargetLength; }
+	else { CollisionArmLength = FMath::FInterpTo(CollisionArmLength, TargetLength, DeltaTime, ProbeRecoverySpeed); }
+	CollisionArmLength = FMath::Min(CollisionArmLength, ArmLength);
+
+	const bool bHitSomething{ CollisionArmLength < ArmLength - UE_KINDA_SMALL_NUMBER };
+	const FVector CollisionLoc{ ArmOrigin + ArmVector.GetSafeNormal() * CollisionArmLength };
+	const FVector ResultLoc{ BlendLocations(DesiredLoc, CollisionLoc, bHitSomething, DeltaTime) };
+
+	bIsCameraFixed = ResultLoc != DesiredLoc;
+	UnfixedCameraPosition = DesiredLoc;
+
+	// Same socket update as the base class, from the collided location
+	const FTransform WorldCamTM{ PreviousDesiredRot, ResultLoc };
+	const FTransform RelCamTM{ WorldCamTM.GetRelativeTransform(GetComponentTransform()) };
+	RelativeSocketLocation = RelCamTM.GetLocation();
+	RelativeSocketRotation = RelCamTM.GetRotation();
+	UpdateChildTransforms();
+
+	// Only the newest probe matters; an older one still in flight is ignored when it lands
+	ProbeTrace = GetWorld()->AsyncSweepByChannel(
+		EAsyncTraceType::Single,
+		ArmOrigin,
+		DesiredLoc,
+		FQuat::Identity,
+		ProbeChannel,
+		FCollisionShape::MakeSphere(ProbeSize),
+		ProbeParams,
+		FCollisionResponseParams::DefaultResponseParam,
+		&ProbeTraceDelegate
+	);
+}
+
+
+void UDefianceSpringArmComponent::HandleProbeTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	if (TraceHandle != ProbeTrace) { return; }
+
+	bPreviousProbeHit = bProbeHit;
+	PreviousProbeHitDistance = ProbeHitDistance;
+
+	const FHitResult* Hit{ TraceDatum.OutHits.Num() > 0 && TraceDatum.OutHits[0].bBlockingHit ? &TraceDatum.OutHits[0] : nullptr };
+	bProbeHit = Hit != nullptr;
+	ProbeHitDistance = Hit ? static_cast<float>(FVector::Distance(TraceDatum.Start, Hit->Location)) : 0.0f;
+}
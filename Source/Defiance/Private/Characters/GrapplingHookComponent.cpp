@@ -2,12 +2,24 @@
 
 
 #include "Characters/GrapplingHookComponent.h"
+#include "MemoryTags.h"
+#include "Characters/SwingComponent.h"
+#include "Characters/DefianceMovementComponent.h"
+#include "Network/NetTelemetrySubsystem.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
 #include "Net/UnrealNetwork.h"
 #include "Camera/CameraComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Interfaces/Grapple.h"
 #include "Kismet/GameplayStatics.h"
+#include "Physics/GameplayQuerySubsystem.h"
+#include "Environment/GrappleVisibilitySubsystem.h"
+#include "Physics/GrappleBallistics.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Grapple Ballistic Filter"), STAT_GrappleBallisticFilter, STATGROUP_Game);
 
 
 // Sets default values for this component's properties
@@ -15,7 +27,9 @@ UGrapplingHookComponent::UGrapplingHookComponent()
 {
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
+	// Grapple detection only drives the local player's highlighting, which a dedicated server never needs
+	PrimaryComponentTick.bCanEverTick = !UE_SERVER;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	SetIsReplicated(true);
 }
@@ -27,7 +41,11 @@ void UGrapplingHookComponent::BeginPlay()
 	Super::BeginPlay();
 
 	OwnerRef = GetOwner<ACharacter>();
-	
+
+	OwnerRef->ReceiveControllerChangedDelegate.AddDynamic(this, &UGrapplingHookComponent::HandleControllerChanged);
+	OwnerRef->LandedDelegate.AddDynamic(this, &UGrapplingHookComponent::HandleLanded);
+	PrefetchTraceDelegate.BindUObject(this, &UGrapplingHookComponent::HandlePrefetchTrace);
+	HandleControllerChanged(OwnerRef, nullptr, OwnerRef->GetController());
 }
 
 
@@ -36,35 +54,62 @@ void UGrapplingHookComponent::TickComponent(float DeltaTime, ELevelTick TickType
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	if (bIsLaunching && GetWorld()->GetTimeSeconds() > FlightEndTime) { EndFlight(); }
 
-	if (OwnerRef->IsLocallyControlled()) { DetectGrapple(DetectionRadius); }
+	DetectGrapple(DetectionRadius);
+
+	FlushGrappleNotifications();
 
 }
 
+void UGrapplingHookComponent::HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	// Remote proxies and AI never run detection. IsPlayerControlled would stay false on clients until the player state
+	// replicates, so the controller is checked instead
+	const bool bIsLocalPlayer{ OwnerRef->IsLocallyControlled() && OwnerRef->GetController<APlayerController>() };
+	if (!bIsLocalPlayer)
+	{
+		if (UGameplayQuerySubsystem* QuerySubsystem{ UGameplayQuerySubsystem::Get(this) }) { QuerySubsystem->CancelQuery(DetectionQueryId); }
+		DetectionQueryId = 0;
 
+		// The tick that would send the deactivation is about to stop
+		EndFlight();
+		UpdateActiveGrapple(nullptr);
+		FlushGrappleNotifications();
+	}
 
-void UGrapplingHookComponent::DetectGrapple(float Range)
-{
-	FVector CurrentLocation{ OwnerRef->GetActorLocation() };
-	FCollisionShape Sphere{ FCollisionShape::MakeSphere(Range) };
-	FCollisionQueryParams IgnoreParams{
-		FName{TEXT("Ignore Collision Params")},
-		false,
-		OwnerRef
-	};
+	SetComponentTickEnabled(bIsLocalPlayer);
+}
 
-	TArray<FHitResult> OutHit;
 
-	bool bHasFoundTarget{ GetWorld()->SweepMultiByChannel(
-		OutHit,
-		CurrentLocation,
-		CurrentLocation,
-		FQuat::Identity,
-		ECollisionChannel::ECC_GameTraceChannel2,
-		Sphere,
-		IgnoreParams
-	) };
 
+void UGrapplingHookComponent::DetectGrapple(float Range)
+{
+	UGameplayQuerySubsystem* QuerySubsystem{ UGameplayQuerySubsystem::Get(this) };
+	if (!QuerySubsystem) { return; }
+
+	// Detection runs every tick; while one search is waiting for the budget there is no point queuing another
+	if (QuerySubsystem->IsQueryPending(DetectionQueryId)) { return; }
+
+	// In flight, the candidates of the last search are still being traced one per frame
+	if (bIsLaunching && PrefetchCandidates.Num() > 0) { return; }
+
+	FGameplayQueryRequest Request;
+	Request.Shape = EGameplayQueryShape::Sphere;
+	Request.Start = GetDetectionOrigin();
+	Request.End = Request.Start;
+	Request.Radius = Range;
+	Request.Channel = ECollisionChannel::ECC_GameTraceChannel2;
+	Request.Params = FCollisionQueryParams{ FName{TEXT("Ignore Collision Params")}, false, OwnerRef };
+	Request.DeadlineFrames = DetectionDeadlineFrames;
+	Request.OnComplete = FGameplayQueryDelegate::CreateUObject(this, &UGrapplingHookComponent::HandleDetectionQuery);
+
+	DetectionQueryId = QuerySubsystem->SubmitQuery(MoveTemp(Request));
+}
+
+void UGrapplingHookComponent::HandleDetectionQuery(const TArray<FHitResult>& OutHit)
+{
+	DetectionQueryId = 0;
 
 	// Nothing detected. Deactivate previous detected target if there is one
 	if (OutHit.Num() == 0) 
@@ -74,46 +119,107 @@ void UGrapplingHookComponent::DetectGrapple(float Range)
 	}
 
 	UCameraComponent* CameraRef{ OwnerRef->GetComponentByClass<UCameraComponent>() };
+	if (!IsValid(CameraRef)) { return; }
+
+	const FVector OwnerLocation{ GetDetectionOrigin() };
+
+	// In flight the camera is expected to follow the owner down to the landing point
+	FVector CameraLocation{ CameraRef->GetComponentLocation() + (OwnerLocation - OwnerRef->GetActorLocation()) };
 	FVector CameraFwdVector{ CameraRef->GetForwardVector() };
 	float FOV{ CameraRef->FieldOfView };
 
-	AActor* SelectedTarget{ nullptr };
-	float SelectedTargetDotProd{ -1.0f };
-
+	// Keep the candidates in the field of view, best aligned with the camera first
+	TArray<FGrappleCandidate, TInlineAllocator<16>> Candidates;
 	for (const FHitResult &Hit : OutHit)
 	{
-		FHitResult VisibilityHit;
+		AActor* HitActor{ Hit.GetActor() };
+		if (!IsValid(HitActor)) { continue; }
+
+		// Fields hold many anchors; each hit is one of them
+		IGrapple* GrapplePoint{ Cast<IGrapple>(HitActor) };
+		const int32 AnchorIndex{ GrapplePoint ? GrapplePoint->GetAnchorIndex(Hit) : INDEX_NONE };
+		if (bIsLaunching && LaunchedGrapple == HitActor && LaunchedGrappleIndex == AnchorIndex) { continue; }
+		const FVector AnchorLocation{ GrapplePoint ? GrapplePoint->GetAnchorLocation(AnchorIndex) : HitActor->GetActorLocation() };
+
+		// Points the bake found no clear arc to from here are never offered
+		if (GrapplePoint && !GrapplePoint->IsReachableFrom(OwnerLocation, AnchorIndex)) { continue; }
 
-		bool bIsTargetVisible{ GetWorld()->LineTraceSingleByChannel(
+		FVector CameraToTargetDirection{ UKismetMathLibrary::GetDirectionUnitVector(CameraLocation, AnchorLocation) };
+		float DotProd{ static_cast<float>(FVector::DotProduct(CameraFwdVector, CameraToTargetDirection)) };
+		if (FMath::RadiansToDegrees(acosf(DotProd)) < FOV / 2)
+		{
+			const FVector LandingLocation{ GrapplePoint ? GrapplePoint->GetAnchorLandingLocation(AnchorIndex) : AnchorLocation };
+			Candidates.Add(FGrappleCandidate{ DotProd, HitActor, AnchorIndex, AnchorLocation, LandingLocation });
+		}
+	}
+
+	// Candidates a launch from here cannot reach are dropped before any trace, all of them checked in one batch
+	if (Candidates.Num() > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_GrappleBallisticFilter);
+
+		TArray<float, TInlineAllocator<16>> LandingX, LandingY, LandingZ;
+		for (const FGrappleCandidate& Candidate : Candidates)
+		{
+			LandingX.Add(static_cast<float>(Candidate.LandingLocation.X));
+			LandingY.Add(static_cast<float>(Candidate.LandingLocation.Y));
+			LandingZ.Add(static_cast<float>(Candidate.LandingLocation.Z));
+		}
+
+		TArray<bool, TInlineAllocator<16>> Reachable;
+		Reachable.SetNumUninitialized(Candidates.Num());
+		FGrappleBallistics::ComputeReachable(OwnerLocation, LandingX, LandingY, LandingZ, OwnerRef->GetCharacterMovement()->GetGravityZ(), ArcParam, LaunchModifier, MaxLaunchSpeed, Reachable);
+
+		for (int32 i = Candidates.Num() - 1; i >= 0; i--)
+		{
+			if (!Reachable[i]) { Candidates.RemoveAtSwap(i); }
+		}
+	}
+	Candidates.Sort([](const FGrappleCandidate& A, const FGrappleCandidate& B) { return A.Alignment > B.Alignment; });
+
+	// Points the baked visibility rules out from here are dropped without a trace; anchors are not baked
+	if (const UGrappleVisibilitySubsystem* VisibilitySubsystem{ GetWorld()->GetSubsystem<UGrappleVisibilitySubsystem>() })
+	{
+		Candidates.RemoveAll([VisibilitySubsystem, &CameraLocation](const FGrappleCandidate& Candidate)
+		{
+			return Candidate.Index == INDEX_NONE && VisibilitySubsystem->GetVisibility(CameraLocation, Candidate.Actor.Get()) == EGrappleVisibility::Hidden;
+		});
+	}
+
+	if (bIsLaunching)
+	{
+		LLM_SCOPE_BYTAG(Defiance_Grapple);
+		PrefetchCandidates.Reset();
+		PrefetchCandidates.Append(Candidates);
+		NextPrefetchCandidate = 0;
+		PrefetchCameraLocation = CameraLocation;
+		TracePrefetchCandidate();
+		return;
+	}
+
+	// The first visible candidate is the best one, so usually a single visibility trace is needed instead of one per hit
+	FCollisionQueryParams IgnoreParams{ FName{TEXT("Ignore Collision Params")}, false, OwnerRef };
+	const FGrappleCandidate* SelectedCandidate{ nullptr };
+	for (const FGrappleCandidate& Candidate : Candidates)
+	{
+		FHitResult VisibilityHit;
+		GetWorld()->LineTraceSingleByChannel(
 			VisibilityHit,
-			CameraRef->GetComponentLocation(),
-			Hit.GetActor()->GetActorLocation(),
+			CameraLocation,
+			Candidate.Location,
 			ECollisionChannel::ECC_Visibility,
 			IgnoreParams
-		) };
-			
-		if (VisibilityHit.GetActor() == Hit.GetActor())
-		{	
-			FVector CameraToTargetDirection{ UKismetMathLibrary::GetDirectionUnitVector(
-					CameraRef->GetComponentLocation(),
-					Hit.GetActor()->GetActorLocation()
-			) };
-
-			float DotProd{ static_cast<float>(FVector::DotProduct(CameraFwdVector, CameraToTargetDirection)) };
-			if (FMath::RadiansToDegrees(acosf(DotProd)) < FOV / 2)
-			{
-				
-				if (DotProd > SelectedTargetDotProd)
-				{
-					SelectedTargetDotProd = DotProd;
-					SelectedTarget = Hit.GetActor();
-				}
-			}
+		);
+
+		if (IsCandidateHit(VisibilityHit, Candidate))
+		{
+			SelectedCandidate = &Candidate;
+			break;
 		}
 	}
 
 	// Nothing detected. Deactivate previous detected target if there is one
-	if (!IsValid(SelectedTarget))
+	if (!SelectedCandidate)
 	{
 		UpdateActiveGrapple(nullptr);
 		return;
@@ -122,70 +228,231 @@ void UGrapplingHookComponent::DetectGrapple(float Range)
 	else
 	{
 		// If the target is the same as the already activated target do nothing
-		if (ActiveGrapple == SelectedTarget) { return; }
+		if (ActiveGrapple == SelectedCandidate->Actor && ActiveGrappleIndex == SelectedCandidate->Index) { return; }
 
 		// If the target is a new target deactivate previous target and activate the new one 
-		UpdateActiveGrapple(SelectedTarget);
+		UpdateActiveGrapple(SelectedCandidate->Actor.Get(), SelectedCandidate->Index);
 	}
 
 }
 
-void UGrapplingHookComponent::UpdateActiveGrapple(AActor* NewGrapple)
+bool UGrapplingHookComponent::IsCandidateHit(const FHitResult& Hit, const FGrappleCandidate& Candidate)
 {
-	// Deactivate previous active grapple point 
-	if (IsValid(ActiveGrapple))
+	AActor* HitActor{ Hit.GetActor() };
+	if (!HitActor || HitActor != Candidate.Actor) { return false; }
+	if (Candidate.Index == INDEX_NONE) { return true; }
+
+	const IGrapple* HitGrapple{ Cast<IGrapple>(HitActor) };
+	return HitGrapple && HitGrapple->GetAnchorIndex(Hit) == Candidate.Index;
+}
+
+FVector UGrapplingHookComponent::GetDetectionOrigin() const
+{
+	return bIsLaunching ? FlightLanding : OwnerRef->GetActorLocation();
+}
+
+void UGrapplingHookComponent::TracePrefetchCandidate()
+{
+	while (NextPrefetchCandidate < PrefetchCandidates.Num() && !PrefetchCandidates[NextPrefetchCandidate].Actor.IsValid())
 	{
-		if (ActiveGrapple->Implements<UGrapple>())
-		{
-			IGrapple::Execute_OnDeactivate(ActiveGrapple);
-		}
+		NextPrefetchCandidate++;
 	}
 
-	// Set new value and if it is valid activate the new active grapple point
-	if (!IsValid(NewGrapple))
+	// None of them is visible from the landing point
+	if (NextPrefetchCandidate >= PrefetchCandidates.Num())
 	{
-		ActiveGrapple = nullptr;
+		PrefetchCandidates.Reset();
+		UpdateActiveGrapple(nullptr);
+		return;
 	}
-	else
+
+	PrefetchTrace = GetWorld()->AsyncLineTraceByChannel(
+		EAsyncTraceType::Single,
+		PrefetchCameraLocation,
+		PrefetchCandidates[NextPrefetchCandidate].Location,
+		ECollisionChannel::ECC_Visibility,
+		FCollisionQueryParams{ FName{TEXT("Ignore Collision Params")}, false, OwnerRef },
+		FCollisionResponseParams::DefaultResponseParam,
+		&PrefetchTraceDelegate
+	);
+}
+
+void UGrapplingHookComponent::HandlePrefetchTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum)
+{
+	// Traces of a flight that has ended since are ignored
+	if (TraceHandle != PrefetchTrace || !PrefetchCandidates.IsValidIndex(NextPrefetchCandidate)) { return; }
+	PrefetchTrace = FTraceHandle();
+
+	const FGrappleCandidate& Candidate{ PrefetchCandidates[NextPrefetchCandidate] };
+	if (TraceDatum.OutHits.Num() > 0 && IsCandidateHit(TraceDatum.OutHits[0], Candidate))
 	{
-		ActiveGrapple = NewGrapple;
-		if (!ActiveGrapple->Implements<UGrapple>()) { return; }
-		IGrapple::Execute_OnActivate(ActiveGrapple, Cast<APawn>(OwnerRef), InteractRange, DetectionRadius);
+		UpdateActiveGrapple(Candidate.Actor.Get(), Candidate.Index);
+		PrefetchCandidates.Reset();
+		return;
 	}
+
+	NextPrefetchCandidate++;
+	TracePrefetchCandidate();
 }
 
-void UGrapplingHookComponent::LaunchOnGrapple()
+void UGrapplingHookComponent::HandleLanded(const FHitResult& Hit)
 {
-	if (!IsValid(ActiveGrapple)) { return; }
-	
+	EndFlight();
+}
+
+void UGrapplingHookComponent::EndFlight()
+{
+	if (!bIsLaunching) { return; }
+
+	// ActiveGrapple keeps what the prefetch found; the next search runs from the real location again
+	bIsLaunching = false;
+	LaunchedGrapple = nullptr;
+	LaunchedGrappleIndex = INDEX_NONE;
+	PrefetchCandidates.Reset();
+	PrefetchTrace = FTraceHandle();
+
+	if (UGameplayQuerySubsystem* QuerySubsystem{ UGameplayQuerySubsystem::Get(this) }) { QuerySubsystem->CancelQuery(DetectionQueryId); }
+	DetectionQueryId = 0;
+}
+
+void UGrapplingHookComponent::UpdateActiveGrapple(AActor* NewGrapple, int32 NewGrappleIndex)
+{
+	// Highlighting is sent once per frame from FlushGrappleNotifications, so a candidate that flips and flips back
+	// within a frame costs nothing
+	ActiveGrapple = IsValid(NewGrapple) ? NewGrapple : nullptr;
+	ActiveGrappleIndex = ActiveGrapple ? NewGrappleIndex : INDEX_NONE;
+}
+
+void UGrapplingHookComponent::FlushGrappleNotifications()
+{
+#if !UE_SERVER
+	if (NotifiedGrapple == ActiveGrapple && NotifiedGrappleIndex == ActiveGrappleIndex) { return; }
+
+	// Deactivate previous active grapple point 
+	if (NotifiedGrapple.IsValid())
+	{
+		IGrapple::NotifyDeactivate(NotifiedGrapple.Get(), NotifiedGrappleIndex);
+	}
+
+	// Activate the new active grapple point
+	NotifiedGrapple = ActiveGrapple;
+	NotifiedGrappleIndex = ActiveGrappleIndex;
+	if (IsValid(ActiveGrapple))
+	{
+		IGrapple::NotifyActivate(ActiveGrapple, ActiveGrappleIndex, Cast<APawn>(OwnerRef), InteractRange, DetectionRadius);
+	}
+#endif
+}
+
+bool UGrapplingHookComponent::ComputeLaunch(AActor* Grapple, int32 GrappleIndex, FVector& OutFlightVelocity, FVector& OutLandingLocation) const
+{
+	IGrapple* GrapplePoint{ Cast<IGrapple>(Grapple) };
+	if (!GrapplePoint) { return false; }
+
 	FVector CurrentLocation{ OwnerRef->GetActorLocation() };
-	FVector GrappleLocation{ ActiveGrapple->GetActorLocation() };
+	FVector GrappleLocation{ GrapplePoint->GetAnchorLocation(GrappleIndex) };
 	float DistanceToGrapple{ static_cast<float>(FVector::Distance(CurrentLocation, GrappleLocation)) };
 
-	if (DistanceToGrapple > InteractRange) { return; }
+	if (DistanceToGrapple > InteractRange) { return false; }
 
-	FVector LandingLocation;
-	IGrapple* GrapplePoint{ Cast<IGrapple>(ActiveGrapple) };
-	
-	if (!GrapplePoint) { return; }
-	
-	LandingLocation = GrapplePoint->GetLandingLocation();
+	OutLandingLocation = GrapplePoint->GetAnchorLandingLocation(GrappleIndex);
 
 	FVector LaunchVelocity;
 	bool bFoundVelocity = UGameplayStatics::SuggestProjectileVelocity_CustomArc(
 		GetWorld(),
 		LaunchVelocity,
 		CurrentLocation,
-		LandingLocation,
+		OutLandingLocation,
 		0.0f,
 		ArcParam
 	);
 
 
-	if (bFoundVelocity)
+	if (!bFoundVelocity) { return false; }
+
+	OutFlightVelocity = LaunchVelocity * LaunchModifier;
+	return OutFlightVelocity.SizeSquared() <= FMath::Square(MaxLaunchSpeed);
+}
+
+void UGrapplingHookComponent::LaunchOnGrapple()
+{
+	if (!IsValid(ActiveGrapple)) { return; }
+
+	UDefianceMovementComponent* MovementComp{ Cast<UDefianceMovementComponent>(OwnerRef->GetCharacterMovement()) };
+	if (!IsValid(MovementComp)) { return; }
+
+	// Checked here as well so a launch that cannot happen is never sent
+	FVector FlightVelocity, LandingLocation;
+	if (!ComputeLaunch(ActiveGrapple, ActiveGrappleIndex, FlightVelocity, LandingLocation)) { return; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::GrappleLaunch); }
+
+	// Sent with the next move, which launches on both sides; the server solves the arc from its own location
+	MovementComp->RequestGrappleLaunch(ActiveGrapple, ActiveGrappleIndex);
+}
+
+bool UGrapplingHookComponent::LaunchFromMove(AActor* Grapple, int32 GrappleIndex)
+{
+	FVector FlightVelocity, LandingLocation;
+	if (!IsValid(OwnerRef) || !ComputeLaunch(Grapple, GrappleIndex, FlightVelocity, LandingLocation))
 	{
-		UE_LOG(LogTemp, Warning, TEXT("%s"), *LaunchVelocity.ToString())
+		// The client predicted a launch we refuse; the move's position check corrects it
+		if (IsValid(OwnerRef) && OwnerRef->HasAuthority() && !OwnerRef->IsLocallyControlled())
+		{
+			if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordRejectedValidation(ENetAction::GrappleLaunch); }
+		}
+		return false;
 	}
 
+	// The velocity replaces the current one, so the arc is the same whatever the owner was doing. Being pending, it also
+	// replaces a launch the Blueprint applied earlier in the frame, so the owner is never launched twice
+	OwnerRef->LaunchCharacter(FlightVelocity, true, true);
+
+	// Replays reapply the launch but the flight was already predicted the first time the move ran
+	if (!OwnerRef->bClientUpdating) { StartFlight(Grapple, GrappleIndex, OwnerRef->GetActorLocation(), FlightVelocity, LandingLocation); }
+	return true;
+}
+
+void UGrapplingHookComponent::StartFlight(AActor* Grapple, int32 GrappleIndex, const FVector& LaunchLocation, const FVector& FlightVelocity, const FVector& LandingLocation)
+{
+	// The flight comes back down to the landing height after the time solved here
+	const float HalfGravityZ{ 0.5f * OwnerRef->GetCharacterMovement()->GetGravityZ() };
+	const float Discriminant{ static_cast<float>(FMath::Square(FlightVelocity.Z) - 4.0f * HalfGravityZ * (LaunchLocation.Z - LandingLocation.Z)) };
+	if (Discriminant < 0.0f || FMath::IsNearlyZero(HalfGravityZ)) { return; }
+
+	const float FlightTime{ (static_cast<float>(-FlightVelocity.Z) - FMath::Sqrt(Discriminant)) / (2.0f * HalfGravityZ) };
+	if (FlightTime <= 0.0f) { return; }
+
+	// Searches from the ground are out of date; the next ones run around the landing point
+	if (UGameplayQuerySubsystem* QuerySubsystem{ UGameplayQuerySubsystem::Get(this) }) { QuerySubsystem->CancelQuery(DetectionQueryId); }
+	DetectionQueryId = 0;
+
+	FlightLanding = LaunchLocation + FlightVelocity * FlightTime + FVector(0.0f, 0.0f, HalfGravityZ * FlightTime * FlightTime);
+	FlightEndTime = GetWorld()->GetTimeSeconds() + FlightTime + FlightEndMargin;
+	LaunchedGrapple = Grapple;
+	LaunchedGrappleIndex = GrappleIndex;
+	PrefetchCandidates.Reset();
+	bIsLaunching = true;
+}
+
+FVector UGrapplingHookComponent::GetActiveLandingLocation() const
+{
+	IGrapple* GrapplePoint{ Cast<IGrapple>(ActiveGrapple) };
+	if (!GrapplePoint) { return FVector::ZeroVector; }
+
+	return GrapplePoint->GetAnchorLandingLocation(ActiveGrappleIndex);
 }
 
+void UGrapplingHookComponent::SwingOnGrapple()
+{
+	if (!IsValid(ActiveGrapple)) { return; }
+
+	USwingComponent* SwingComp{ OwnerRef->FindComponentByClass<USwingComponent>() };
+	if (!IsValid(SwingComp)) { return; }
+
+	const IGrapple* GrapplePoint{ Cast<IGrapple>(ActiveGrapple) };
+	FVector GrappleLocation{ GrapplePoint ? GrapplePoint->GetAnchorLocation(ActiveGrappleIndex) : ActiveGrapple->GetActorLocation() };
+	if (FVector::Distance(OwnerRef->GetActorLocation(), GrappleLocation) > InteractRange) { return; }
+
+	SwingComp->StartSwing(GrappleLocation, EClimbableType::Rope);
+}
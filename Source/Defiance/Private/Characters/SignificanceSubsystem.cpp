@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/SignificanceSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/BaseAnimInstance_ABP.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<bool> CVarSignificanceEnabled(
+	TEXT("defiance.Significance.Enabled"),
+	true,
+	TEXT("Slows down the ticks of characters far from every player. Disable to compare tick times against full rate."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld SignificanceDumpCommand(
+	TEXT("defiance.Significance.Dump"),
+	TEXT("Prints the number of characters in each significance tier."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (USignificanceSubsystem* Significance{ USignificanceSubsystem::Get(World) }) { Significance->DumpStats(); }
+	}));
+
+
+USignificanceSubsystem* USignificanceSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<USignificanceSubsystem>() : nullptr;
+}
+
+TStatId USignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USignificanceSubsystem, STATGROUP_Tickables);
+}
+
+
+
+void USignificanceSubsystem::RegisterCharacter(ACharacter* Character)
+{
+	if (!IsValid(Character) || Characters.Contains(Character)) { return; }
+
+	Characters.Add(Character);
+	Tiers.Add(ESignificanceTier::High);
+}
+
+void USignificanceSubsystem::UnregisterCharacter(const ACharacter* Character)
+{
+	const int32 Index{ Characters.IndexOfByPredicate([Character](const TWeakObjectPtr<ACharacter>& Registered) { return Registered.Get() == Character; }) };
+	if (Index == INDEX_NONE) { return; }
+
+	Characters.RemoveAtSwap(Index);
+	Tiers.RemoveAtSwap(Index);
+}
+
+ESignificanceTier USignificanceSubsystem::GetTier(const ACharacter* Character) const
+{
+	const int32 Index{ Characters.IndexOfByPredicate([Character](const TWeakObjectPtr<ACharacter>& Registered) { return Registered.Get() == Character; }) };
+	return Index != INDEX_NONE ? Tiers[Index] : ESignificanceTier::High;
+}
+
+
+
+void USignificanceSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.0f) { return; }
+	TimeUntilUpdate = UpdateInterval;
+
+	// On a server these are all players, on a client only the local ones
+	ViewLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController{ It->Get() };
+		if (!IsValid(PlayerController)) { continue; }
+
+		FVector ViewLocation;
+		FRotator ViewRotation;
+		PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+		ViewLocations.Add(ViewLocation);
+	}
+
+	for (int32 i = Characters.Num() - 1; i >= 0; i--)
+	{
+		ACharacter* Character{ Characters[i].Get() };
+		if (!Character)
+		{
+			Characters.RemoveAtSwap(i);
+			Tiers.RemoveAtSwap(i);
+			continue;
+		}
+
+		const ESignificanceTier Tier{ ComputeTier(Character) };
+		if (Tier == Tiers[i]) { continue; }
+
+		Tiers[i] = Tier;
+		ApplyTier(Character, Tier);
+	}
+}
+
+ESignificanceTier USignificanceSubsystem::ComputeTier(const ACharacter* Character) const
+{
+	if (!CVarSignificanceEnabled.GetValueOnGameThread() || (Character->IsLocallyControlled() && Character->GetController<APlayerController>()))
+	{
+		return ESignificanceTier::High;
+	}
+
+	const FVector Location{ Character->GetActorLocation() };
+	double ClosestDistanceSquared{ TNumericLimits<double>::Max() };
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		ClosestDistanceSquared = FMath::Min(ClosestDistanceSquared, FVector::DistSquared(Location, ViewLocation));
+	}
+
+	if (ClosestDistanceSquared > FMath::Square(LowDistance)) { return ESignificanceTier::Low; }
+	if (ClosestDistanceSquared > FMath::Square(MediumDistance)) { return ESignificanceTier::Medium; }
+	return ESignificanceTier::High;
+}
+
+void USignificanceSubsystem::ApplyTier(ACharacter* Character, ESignificanceTier Tier) const
+{
+	const float TickInterval{ TierTickIntervals[static_cast<int32>(Tier)] };
+
+	Character->SetActorTickInterval(TickInterval);
+	Character->GetMesh()->SetComponentTickInterval(TickInterval);
+
+	// Foot placement stops tracing for the Low tier
+	if (UBaseAnimInstance_ABP* AnimInstance{ Cast<UBaseAnimInstance_ABP>(Character->GetMesh()->GetAnimInstance()) }) { AnimInstance->SetSignificanceTier(Tier); }
+
+	// Player movement on the server is driven by the client's moves, so only simulated movement may run slower
+	Character->GetCharacterMovement()->SetComponentTickInterval(Character->IsPlayerControlled() ? 0.0f : TickInterval);
+}
+
+void USignificanceSubsystem::DumpStats() const
+{
+	int32 Counts[static_cast<int32>(ESignificanceTier::MAX)]{};
+	for (const ESignificanceTier Tier : Tiers)
+	{
+		Counts[static_cast<int32>(Tier)]++;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("USignificanceSubsystem [DumpStats]: %d characters. High: %d, Medium: %d, Low: %d."),
+		Characters.Num(), Counts[0], Counts[1], Counts[2])
+}
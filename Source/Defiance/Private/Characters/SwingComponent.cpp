@@ -0,0 +1,202 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Characters/SwingComponent.h"
+#include "Characters/DefianceMovementComponent.h"
+#include "Network/NetTelemetrySubsystem.h"
+#include "GameFramework/Character.h"
+#include "Net/UnrealNetwork.h"
+
+
+// Sets default values for this component's properties
+USwingComponent::USwingComponent()
+{
+	// The swing is simulated by the movement component's moves
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicated(true);
+}
+
+void USwingComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME_CONDITION(USwingComponent, bIsSwinging, COND_SkipOwner);
+	DOREPLIFETIME(USwingComponent, SwingType);
+	DOREPLIFETIME(USwingComponent, SwingAnchor);
+}
+
+
+// Called when the game starts
+void USwingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OwnerRef = GetOwner<ACharacter>();
+	MovementComp = OwnerRef->GetCharacterMovement();
+
+	if (!Cast<UDefianceMovementComponent>(MovementComp))
+	{
+		UE_LOG(LogTemp, Error, TEXT("USwingComponent [BeginPlay]: The owner does not use UDefianceMovementComponent."))
+	}
+}
+
+
+
+void USwingComponent::SimulateSwing(float DeltaTime, const FVector& PumpInput, FVector& OutLocation, FQuat& OutRotation)
+{
+	const FVector3f PumpAcceleration{ PumpInput.GetClampedToMaxSize(1.0f) * PumpStrength };
+
+	// Fixed steps keep the swing independent of the move lengths; the accumulator is part of the saved state, so a replay
+	// steps at the same points as the original move
+	State.StepAccumulator += DeltaTime;
+	int32 Steps{ 0 };
+	while (State.StepAccumulator >= FixedStep && Steps < MaxStepsPerFrame)
+	{
+		State.Solver.Step(FixedStep, PumpAcceleration);
+		State.StepAccumulator -= FixedStep;
+		++Steps;
+	}
+
+	// Drop the backlog after a hitch instead of catching up over the next moves
+	if (Steps == MaxStepsPerFrame) { State.StepAccumulator = 0.0f; }
+
+	// Carry the end on by the time not stepped yet, so the character moves every frame
+	const FVector EndVelocity{ State.Solver.GetEndVelocity(FixedStep) };
+	const FVector EndLocation{ State.Solver.GetEndLocation() + EndVelocity * State.StepAccumulator };
+
+	// Hang from the hands and face along the swing
+	FVector Forward{ FVector::VectorPlaneProject(EndVelocity, FVector::UpVector).GetSafeNormal() };
+	if (Forward.IsNearlyZero()) { Forward = OwnerRef->GetActorForwardVector(); }
+	const FVector Up{ (State.Solver.GetAnchorLocation() - EndLocation).GetSafeNormal(UE_SMALL_NUMBER, FVector::UpVector) };
+
+	OutLocation = EndLocation - Up * HandHeight;
+	OutRotation = FRotationMatrix::MakeFromXZ(Forward, Up).ToQuat();
+}
+
+void USwingComponent::HandleSwingEnded()
+{
+	// Something else took the character out of the swing (a landing, a correction...)
+	State.Solver.Reset();
+	State.StepAccumulator = 0.0f;
+	bIsSwinging = false;
+}
+
+void USwingComponent::SyncToCharacter(const FVector& Location, const FVector& Velocity)
+{
+	const FVector HandLocation{ Location + OwnerRef->GetActorUpVector() * HandHeight };
+
+	// A correction can start the swing on the owner before it predicted it
+	if (!State.Solver.IsActive())
+	{
+		const int32 NumSegments{ (SwingType == EClimbableType::Rope) ? FMath::Max(RopeSegments, 1) : 1 };
+		State.Solver.Init(SwingAnchor, HandLocation, NumSegments, Velocity, FixedStep);
+		State.StepAccumulator = 0.0f;
+		bIsSwinging = true;
+		return;
+	}
+
+	State.Solver.SetEndState(HandLocation, Velocity, FixedStep);
+}
+
+void USwingComponent::RestoreSwingState(const FSwingState& SwingState)
+{
+	State = SwingState;
+	bIsSwinging = State.Solver.IsActive();
+}
+
+
+
+bool USwingComponent::IsWithinReach(const FVector& Location, const FVector& Anchor) const
+{
+	const FVector HandLocation{ Location + OwnerRef->GetActorUpVector() * HandHeight };
+	return FVector::DistSquared(HandLocation, Anchor) <= FMath::Square(MaxSwingLength);
+}
+
+void USwingComponent::StartSwing(FVector Anchor, EClimbableType Type)
+{
+	UDefianceMovementComponent* DefianceMovement{ Cast<UDefianceMovementComponent>(MovementComp) };
+	if (!IsValid(OwnerRef) || !IsValid(DefianceMovement) || bIsSwinging) { return; }
+
+	if (!IsWithinReach(OwnerRef->GetActorLocation(), Anchor)) { return; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Swing); }
+
+	// Sent with the next move, which starts the swing on both sides; the server uses its own location and velocity
+	DefianceMovement->RequestSwing(Anchor, Type);
+}
+
+void USwingComponent::StopSwing()
+{
+	if (!IsValid(OwnerRef) || !bIsSwinging) { return; }
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::Swing); }
+
+	if (!OwnerRef->HasAuthority()) { EndSwing(); }
+	SR_StopSwing();
+}
+
+void USwingComponent::Pump(FVector Direction)
+{
+	if (!bIsSwinging) { return; }
+
+	// Pumping is movement input, so it is saved, sent and replayed with the moves
+	OwnerRef->AddMovementInput(Direction.GetClampedToMaxSize(1.0f));
+}
+
+bool USwingComponent::BeginSwingFromMove(const FVector& Anchor, EClimbableType Type)
+{
+	if (!IsValid(OwnerRef) || !IsValid(MovementComp)) { return false; }
+
+	const FVector StartLocation{ OwnerRef->GetActorLocation() };
+	if (!IsWithinReach(StartLocation, Anchor))
+	{
+		// The client predicted a swing we refuse; the move's position check corrects it
+		if (OwnerRef->HasAuthority() && !OwnerRef->IsLocallyControlled())
+		{
+			if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordRejectedValidation(ENetAction::Swing); }
+		}
+		return false;
+	}
+
+	BeginSwing(Anchor, Type, StartLocation, MovementComp->Velocity);
+	return true;
+}
+
+void USwingComponent::SR_StopSwing_Implementation()
+{
+	if (!bIsSwinging) { return; }
+
+	EndSwing();
+}
+
+void USwingComponent::BeginSwing(const FVector& Anchor, EClimbableType Type, const FVector& StartLocation, const FVector& StartVelocity)
+{
+	UDefianceMovementComponent* DefianceMovement{ Cast<UDefianceMovementComponent>(MovementComp) };
+	if (!IsValid(DefianceMovement)) { return; }
+
+	const FVector HandLocation{ StartLocation + OwnerRef->GetActorUpVector() * HandHeight };
+	const int32 NumSegments{ (Type == EClimbableType::Rope) ? FMath::Max(RopeSegments, 1) : 1 };
+
+	State.Solver.Init(Anchor, HandLocation, NumSegments, StartVelocity, FixedStep);
+	State.StepAccumulator = 0.0f;
+
+	bIsSwinging = true;
+	SwingType = Type;
+	SwingAnchor = Anchor;
+
+	DefianceMovement->SetMovementMode(MOVE_Custom, static_cast<uint8>(ECustomMovementMode::CMOVE_Swinging));
+}
+
+void USwingComponent::EndSwing()
+{
+	const FVector ReleaseVelocity{ State.Solver.GetEndVelocity(FixedStep) };
+	HandleSwingEnded();
+
+	// Let go with the momentum of the swing
+	if (IsValid(MovementComp))
+	{
+		MovementComp->SetMovementMode(MOVE_Falling);
+		MovementComp->Velocity = ReleaseVelocity;
+	}
+}
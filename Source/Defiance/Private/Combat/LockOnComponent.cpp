@@ -3,6 +3,7 @@
 
 #include "Combat/LockOnComponent.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/PlayerController.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
 #include "Camera/CameraComponent.h"
@@ -10,6 +11,11 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Interfaces/Enemy.h"
+#include "Network/NetTelemetrySubsystem.h"
+#include "Network/RewindSubsystem.h"
+#include "Network/ActionValidationSubsystem.h"
+#include "Crowd/CrowdSubsystem.h"
+#include "Physics/GameplayQuerySubsystem.h"
 
 
 // Sets default values for this component's properties
@@ -18,6 +24,7 @@ ULockOnComponent::ULockOnComponent()
 	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
 	// off to improve performance if you don't need them.
 	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 
 	SetIsReplicated(true);
 
@@ -30,11 +37,11 @@ void ULockOnComponent::BeginPlay()
 	Super::BeginPlay();
 
 	OwnerRef = GetOwner<ACharacter>();
-	Controller = GetWorld()->GetFirstPlayerController();
 	MovementComp = OwnerRef->GetCharacterMovement();
 	CameraBoom = OwnerRef->FindComponentByClass<USpringArmComponent>();
 
-	
+	OwnerRef->ReceiveControllerChangedDelegate.AddDynamic(this, &ULockOnComponent::HandleControllerChanged);
+	HandleControllerChanged(OwnerRef, nullptr, OwnerRef->GetController());
 }
 
 void ULockOnComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -51,6 +58,9 @@ void ULockOnComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 void ULockOnComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	FlushTargetNotifications();
+
 	//bool OwnedLocally = OwnerRef->IsOwnedBy(UGameplayStatics::GetPlayerController(this, 0));
 	bool LocallyControlled{ OwnerRef->IsLocallyControlled() };
 	if (LocallyControlled) {
@@ -104,7 +114,7 @@ void ULockOnComponent::ToggleLockOn(float SphereRadious)
 	}
 	else
 	{
-		if (!StartLockOn(SphereRadious))
+		if (!RequestLockOn(SphereRadious, true))
 		{
 			ResetCamera();
 		}
@@ -113,99 +123,202 @@ void ULockOnComponent::ToggleLockOn(float SphereRadious)
 
 
 
-bool ULockOnComponent::StartLockOn(float SphereRadious)
+bool ULockOnComponent::StartLockOnSearch(float SphereRadious)
+{
+	return RequestLockOn(SphereRadious, false);
+}
+
+bool ULockOnComponent::RequestLockOn(float SphereRadious, bool bResetCameraOnMiss)
 {
-	// First detect valid targets within SphereRadious
-	//FHitResult OutResult;
+	UGameplayQuerySubsystem* QuerySubsystem{ UGameplayQuerySubsystem::Get(this) };
+	if (!QuerySubsystem) { return false; }
+
+	// Only the latest request counts
+	QuerySubsystem->CancelQuery(LockOnQueryId);
+
+	// First detect valid targets within SphereRadious. The player is waiting on the result, so it is never deferred
+	FGameplayQueryRequest Request;
+	Request.Shape = EGameplayQueryShape::Sphere;
+	Request.Start = OwnerRef->GetActorLocation();
+	Request.End = Request.Start;
+	Request.Radius = SphereRadious;
+	Request.Channel = ECollisionChannel::ECC_GameTraceChannel1;
+	Request.Params = FCollisionQueryParams{ FName{TEXT("Ignore Collision Params")}, false, OwnerRef };
+	Request.Priority = 10;
+	Request.DeadlineFrames = 0;
+	Request.OnComplete = FGameplayQueryDelegate::CreateUObject(this, &ULockOnComponent::HandleLockOnQuery, SphereRadious, bResetCameraOnMiss);
+
+	LockOnQueryId = QuerySubsystem->SubmitQuery(MoveTemp(Request));
+	return true;
+}
+
+void ULockOnComponent::HandleLockOnQuery(const TArray<FHitResult>& OutHit, float SphereRadious, bool bResetCameraOnMiss)
+{
+	LockOnQueryId = 0;
+
 	FVector CurrentLocation{ OwnerRef->GetActorLocation() };
-	FCollisionShape Sphere{ FCollisionShape::MakeSphere(SphereRadious) };
-	FCollisionQueryParams IgnoreParams{
-		FName{TEXT("Ignore Collision Params")},
-		false,
-		OwnerRef
+	bool bHasFoundTarget{ OutHit.ContainsByPredicate([](const FHitResult& Hit) { return Hit.bBlockingHit; }) };
+
+	// Nothing to lock onto
+	auto Miss = [this, bResetCameraOnMiss]()
+	{
+		if (bResetCameraOnMiss) { ResetCamera(); }
+		OnLockOnResultDelegate.Broadcast(nullptr);
 	};
-	TArray<FHitResult> OutHit;
-
-	bool bHasFoundTarget{ GetWorld()->SweepMultiByChannel(
-		OutHit,
-		CurrentLocation,
-		CurrentLocation,
-		FQuat::Identity,
-		ECollisionChannel::ECC_GameTraceChannel1,
-		Sphere,
-		IgnoreParams
-	) };
 
 	//UE_LOG(LogTemp, Warning, TEXT("LockOnComponent [StartLockOn]: Detected %d valid targets to lock on."), OutHit.Num())
 
-	if (!bHasFoundTarget) { return 0; }
+	// Crowd members that are not actors yet are candidates as well (only the server simulates the crowd; on clients
+	// every member within lock on range is already a promoted actor)
+	TArray<FCrowdLockOnCandidate> CrowdCandidates;
+	UCrowdSubsystem* Crowd{ UCrowdSubsystem::Get(this) };
+	if (Crowd) { Crowd->FindLockOnCandidates(CurrentLocation, SphereRadious, CrowdCandidates); }
+
+	if (!bHasFoundTarget && CrowdCandidates.Num() == 0) { return Miss(); }
 
 	// Among all valid targets find the best to lock onto	
 	UCameraComponent* OwnerCamera{ OwnerRef->FindComponentByClass<UCameraComponent>() };
+	if (!IsValid(OwnerCamera)) { return Miss(); }
+
 	float FOV{ OwnerCamera->FieldOfView };
 	FVector CameraForwardVector{ OwnerCamera->GetForwardVector() };
+	FVector CameraLocation{ OwnerCamera->GetComponentLocation() };
 	float LastTargetDistanceFromCameraView{ SphereRadious };
 	float TargetDistanceFromCameraView{ 0.f };
 	AActor* NewTarget{ nullptr };
+	FMassEntityHandle NewTargetEntity;
+
+	// Returns true if the location is in the players field of view and closer to the view center than the best so far
+	auto IsBetterCandidate = [&](const FVector& TargetLocation)
+	{
+		FVector CameraToTargetDirection{ (TargetLocation - CameraLocation).GetSafeNormal() };
+		if (FMath::RadiansToDegrees(acosf(FVector::DotProduct(CameraForwardVector, CameraToTargetDirection))) >= FOV / 2) { return false; }
 
-	for (int8 i = 0; i < OutHit.Num(); i++)
+		TargetDistanceFromCameraView = FMath::PointDistToLine(TargetLocation, CameraForwardVector, CameraLocation);
+		if (TargetDistanceFromCameraView >= LastTargetDistanceFromCameraView) { return false; }
+
+		LastTargetDistanceFromCameraView = TargetDistanceFromCameraView;
+		return true;
+	};
+
+	for (int32 i = 0; i < OutHit.Num(); i++)
 	{
 		AActor* CanditateTarget{ OutHit[i].GetActor() };
-		FVector CameraToTargetDirection{ CanditateTarget->GetActorLocation() - OwnerCamera->GetComponentLocation() };
-		CameraToTargetDirection = CameraToTargetDirection.GetSafeNormal();
+		if (IsValid(CanditateTarget) && IsBetterCandidate(CanditateTarget->GetActorLocation()))
+		{
+			NewTarget = CanditateTarget;
+			NewTargetEntity = FMassEntityHandle();
+		}
+	}
 
-		//Check if the candidate was in players field of view
-		if (FMath::RadiansToDegrees(acosf(FVector::DotProduct(CameraForwardVector, CameraToTargetDirection))) < FOV / 2)
+	for (const FCrowdLockOnCandidate& Candidate : CrowdCandidates)
+	{
+		if (IsBetterCandidate(Candidate.Location))
 		{
-			FVector TargetLocation = CanditateTarget->GetActorLocation();
-			FVector CameraLocation = OwnerCamera->GetComponentLocation();
-			FVector CameraDirection = OwnerCamera->GetComponentRotation().Vector();
-			TargetDistanceFromCameraView = FMath::PointDistToLine(TargetLocation, CameraDirection, CameraLocation);
-
-			if (TargetDistanceFromCameraView < LastTargetDistanceFromCameraView)
-			{
-				NewTarget = CanditateTarget;
-				LastTargetDistanceFromCameraView = TargetDistanceFromCameraView;
-			}
+			NewTarget = nullptr;
+			NewTargetEntity = Candidate.Entity;
 		}
 	}
+
+	// A crowd member has to be an actor to be locked onto
+	if (NewTargetEntity.IsSet() && Crowd)
+	{
+		NewTarget = Crowd->Promote(NewTargetEntity);
+	}
 	
 	// Check if the NewTarget is a valid target
-	if (!IsValid(NewTarget)) { return 0; }
-	if (!NewTarget->Implements<UEnemy>()) { return 0; }
+	if (!IsValid(NewTarget)) { return Miss(); }
+	if (!NewTarget->Implements<UEnemy>()) { return Miss(); }
 	
 	//UE_LOG(LogTemp, Warning, TEXT("LockOnComponent [StartLockOn]: Best candidate to lock on is %s."), *NewTarget->GetName())
 
 	// Perform all LockOn operations
-	Controller->SetIgnoreLookInput(true);
-	SR_UpdateLockOn(NewTarget);
+	SetLookInputLocked(true);
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::UpdateLockOn); }
+	SR_UpdateLockOn(NewTarget, URewindSubsystem::GetViewTime(this));
 	
+#if !UE_SERVER
 	bool LocallyControlled{ OwnerRef->IsLocallyControlled() };
 	if (LocallyControlled)
 	{
-		IEnemy::Execute_OnSelect(NewTarget);
+		SelectedTarget = NewTarget;
 	}
+#endif
 
-	return 1;
+	OnLockOnResultDelegate.Broadcast(NewTarget);
 }
 
 void ULockOnComponent::EndLockOn()
 {
+#if !UE_SERVER
 	bool LocallyControlled{ OwnerRef->IsLocallyControlled() };
 	if (LocallyControlled)
 	{
-		if (IsValid(CurrentTargetActor))
-		{
-			IEnemy::Execute_OnDeselect(CurrentTargetActor);
-		}
+		SelectedTarget = nullptr;
+	}
+#endif
+	SetLookInputLocked(false);
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::UpdateLockOn); }
+	SR_UpdateLockOn(nullptr, URewindSubsystem::GetViewTime(this));
+}
+
+
+void ULockOnComponent::HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController)
+{
+	// The controller rather than IsPlayerControlled, which waits on the player state replicating to clients
+	const bool bIsLocalPlayer{ OwnerRef->IsLocallyControlled() && OwnerRef->GetController<APlayerController>() };
+	if (bIsLocalPlayer) { Controller = OwnerRef->GetController<APlayerController>(); }
+	else
+	{
+		// The tick that would send the deselection is about to stop
+		SelectedTarget = nullptr;
+		FlushTargetNotifications();
+		SetLookInputLocked(false);
+		Controller = nullptr;
 	}
-	Controller->ResetIgnoreLookInput();
-	SR_UpdateLockOn(nullptr);
+
+	SetComponentTickEnabled(bIsLocalPlayer);
+}
+
+
+void ULockOnComponent::FlushTargetNotifications()
+{
+#if !UE_SERVER
+	// Selecting and deselecting within the same frame cancel out
+	if (NotifiedTarget == SelectedTarget) { return; }
+
+	if (NotifiedTarget.IsValid())
+	{
+		IEnemy::NotifyDeselect(NotifiedTarget.Get());
+	}
+
+	NotifiedTarget = SelectedTarget;
+	if (SelectedTarget.IsValid())
+	{
+		IEnemy::NotifySelect(SelectedTarget.Get());
+	}
+#endif
+}
+
+
+void ULockOnComponent::OnReleasedToPool()
+{
+	if (!IsValid(MovementComp)) { return; }
+
+	if (UGameplayQuerySubsystem* QuerySubsystem{ UGameplayQuerySubsystem::Get(this) }) { QuerySubsystem->CancelQuery(LockOnQueryId); }
+	LockOnQueryId = 0;
+
+	SelectedTarget = nullptr;
+	FlushTargetNotifications();
+
+	CurrentTargetActor = nullptr;
+	OnRep_CurrentTargetActor();
 }
 
 
 void ULockOnComponent::OnRep_CurrentTargetActor()
 {
+#if !UE_SERVER
 	if (OwnerRef->HasAuthority())
 	{
 		GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Green,
@@ -217,6 +330,7 @@ void ULockOnComponent::OnRep_CurrentTargetActor()
 		GEngine->AddOnScreenDebugMessage(-1, 10.0f, FColor::Yellow,
 			FString::Printf(TEXT("LockOnComponent [UpdateLockOn]: Client %d - updating LockOn Target"), ClientId));
 	}
+#endif
 	
 
 
@@ -237,32 +351,56 @@ void ULockOnComponent::OnRep_CurrentTargetActor()
 }
 
 
-void ULockOnComponent::SR_UpdateLockOn_Implementation(AActor* NewTarget)
+void ULockOnComponent::SR_UpdateLockOn_Implementation(AActor* NewTarget, double ClientTimeStamp)
+{
+	UActionValidationSubsystem* Validation{ UActionValidationSubsystem::Get(this) };
+	if (!Validation)
+	{
+		ApplyLockOn(NewTarget);
+		return;
+	}
+
+	// A new target is checked against the positions the client saw when it picked it; clearing needs no check
+	Validation->QueueAction(ENetAction::UpdateLockOn, OwnerRef,
+		FApplyActionDelegate::CreateUObject(this, &ULockOnComponent::ApplyLockOn, NewTarget),
+		NewTarget, ClientTimeStamp, BreakDistance + 200.0f,
+		FSimpleDelegate::CreateUObject(this, &ULockOnComponent::CL_LockOnRejected, NewTarget));
+}
+
+
+bool ULockOnComponent::SR_UpdateLockOn_Validate(AActor* NewTarget, double ClientTimeStamp)
+{
+	// Only malformed requests are refused here; the distance check runs in UActionValidationSubsystem
+	const URewindSubsystem* Rewind{ URewindSubsystem::Get(this) };
+	return Rewind ? Rewind->IsTimeStampPlausible(ClientTimeStamp) : FMath::IsFinite(ClientTimeStamp);
+}
+
+
+bool ULockOnComponent::ApplyLockOn(AActor* NewTarget)
 {
 	CurrentTargetActor = NewTarget;
 	OnRep_CurrentTargetActor();
+	return true;
 }
 
 
-bool ULockOnComponent::SR_UpdateLockOn_Validate(AActor* NewTarget)
+void ULockOnComponent::CL_LockOnRejected_Implementation(AActor* RejectedTarget)
 {
-	if (IsValid(NewTarget)) {
-		FVector CurrentLocation{ OwnerRef->GetActorLocation() };
-		FVector TargetLocation{ NewTarget->GetActorLocation() };
-		double TargetDistance{ FVector::Distance(CurrentLocation, TargetLocation) };
+	// A later request already replaced the rejected one
+	if (SelectedTarget.Get() != RejectedTarget) { return; }
 
-		if (TargetDistance <= (BreakDistance + 200.0f))
-		{
-			return true;
-		}
-		else
-		{
-			return false;
-		}
-	}
-	else
-	{
-		return true;
-	}
+	// Back to whatever the server has; the camera is released when that is no target at all
+	SelectedTarget = CurrentTargetActor;
+	SetLookInputLocked(IsValid(CurrentTargetActor));
+
+	OnLockOnResultDelegate.Broadcast(CurrentTargetActor);
 }
 
+
+void ULockOnComponent::SetLookInputLocked(bool bLocked)
+{
+	if (bLookInputLocked == bLocked || !IsValid(Controller)) { return; }
+
+	bLookInputLocked = bLocked;
+	Controller->SetIgnoreLookInput(bLocked);
+}
@@ -0,0 +1,213 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/MeleeComponent.h"
+#include "MemoryTags.h"
+#include "Combat/MeleeHitSubsystem.h"
+#include "Network/NetTelemetrySubsystem.h"
+#include "Network/RewindSubsystem.h"
+#include "Crowd/CrowdSubsystem.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Animation/AnimInstance.h"
+#include "Engine/AssetManager.h"
+
+
+// Sets default values for this component's properties
+UMeleeComponent::UMeleeComponent()
+{
+	// Hits are detected in one batch by UMeleeHitSubsystem
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicated(true);
+
+	for (const TCHAR* Path : { TEXT("/Game/AnimStarterPack/Hit_React_1.Hit_React_1"), TEXT("/Game/AnimStarterPack/Hit_React_2.Hit_React_2"),
+		TEXT("/Game/AnimStarterPack/Hit_React_3.Hit_React_3"), TEXT("/Game/AnimStarterPack/Hit_React_4.Hit_React_4") })
+	{
+		HitReactAnimations.Add(TSoftObjectPtr<UAnimSequenceBase>(FSoftObjectPath(Path)));
+	}
+}
+
+
+// Called when the game starts
+void UMeleeComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	OwnerRef = GetOwner<ACharacter>();
+	HitSubsystem = UMeleeHitSubsystem::Get(this);
+
+	if (!IsValid(OwnerRef))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UMeleeComponent [BeginPlay]: The owner is not a character."))
+		return;
+	}
+
+	if (!IsValid(HitSubsystem))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UMeleeComponent [BeginPlay]: The world has no melee hit subsystem."))
+		return;
+	}
+
+	HitSubsystem->RegisterHittable(this);
+
+#if !UE_SERVER
+	TArray<FSoftObjectPath> HitReactPaths;
+	for (const TSoftObjectPtr<UAnimSequenceBase>& Animation : HitReactAnimations)
+	{
+		if (!Animation.IsNull()) { HitReactPaths.Add(Animation.ToSoftObjectPath()); }
+	}
+
+	if (HitReactPaths.Num() > 0)
+	{
+		LLM_SCOPE_BYTAG(Defiance_Animation);
+		HitReactHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(HitReactPaths, FStreamableDelegate());
+	}
+#endif
+}
+
+void UMeleeComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (IsValid(HitSubsystem))
+	{
+		HitSubsystem->UnregisterHittable(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+
+bool UMeleeComponent::IsDetectingHits() const
+{
+	// Players detect their own hits for responsiveness and the server confirms them; AI is detected by the server
+	return IsValid(OwnerRef) && (OwnerRef->IsLocallyControlled() || (OwnerRef->HasAuthority() && !OwnerRef->IsPlayerControlled()));
+}
+
+void UMeleeComponent::BeginAttack()
+{
+	if (!IsDetectingHits() || !IsValid(HitSubsystem)) { return; }
+
+	AttackId++;
+	bIsAttacking = true;
+	HitVictims.Reset();
+	HitSubsystem->BeginAttack(this);
+
+	if (!OwnerRef->HasAuthority())
+	{
+		if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::MeleeAttack); }
+		SR_BeginAttack(AttackId);
+	}
+}
+
+void UMeleeComponent::EndAttack()
+{
+	if (!bIsAttacking || !IsValid(HitSubsystem)) { return; }
+
+	bIsAttacking = false;
+	HitSubsystem->EndAttack(this);
+
+	if (!OwnerRef->HasAuthority())
+	{
+		SR_EndAttack();
+	}
+}
+
+void UMeleeComponent::SR_BeginAttack_Implementation(uint8 NewAttackId)
+{
+	AttackId = NewAttackId;
+	bIsAttacking = true;
+	HitVictims.Reset();
+}
+
+void UMeleeComponent::SR_EndAttack_Implementation()
+{
+	bIsAttacking = false;
+}
+
+void UMeleeComponent::HandleHit(AActor* Victim, const FVector& HitLocation)
+{
+	if (OwnerRef->HasAuthority())
+	{
+		ApplyHit(Victim, HitLocation);
+		return;
+	}
+
+	// The hit was found against the poses on screen, so that is the moment the server rewinds to
+	const double ViewTime{ URewindSubsystem::GetViewTime(this) };
+
+	if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordActionRequest(OwnerRef, ENetAction::MeleeHit); }
+	SR_ConfirmHit(Victim, HitLocation, AttackId, ViewTime);
+}
+
+void UMeleeComponent::SR_ConfirmHit_Implementation(AActor* Victim, FVector_NetQuantize HitLocation, uint8 HitAttackId, double ClientTimeStamp)
+{
+	// Late or malformed reports are expected with lag, so they are dropped instead of failing validation
+	auto Reject = [this](const TCHAR* Reason)
+	{
+		if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) }) { Telemetry->RecordRejectedValidation(ENetAction::MeleeHit); }
+		UE_LOG(LogTemp, Verbose, TEXT("UMeleeComponent [SR_ConfirmHit]: Rejected hit, %s."), Reason)
+	};
+
+	if (!bIsAttacking || HitAttackId != AttackId) { Reject(TEXT("no matching attack")); return; }
+
+	const ACharacter* VictimCharacter{ Cast<ACharacter>(Victim) };
+	if (!IsValid(VictimCharacter) || Victim == OwnerRef || !Victim->FindComponentByClass<UMeleeComponent>()) { Reject(TEXT("invalid victim")); return; }
+	if (HitVictims.Contains(Victim)) { Reject(TEXT("victim already hit")); return; }
+
+	const double ServerTime{ URewindSubsystem::GetServerTime(this) };
+	if (!FMath::IsFinite(ClientTimeStamp) || FMath::Abs(ServerTime - ClientTimeStamp) > HitSubsystem->MaxHitAge) { Reject(TEXT("report too old")); return; }
+
+	// Rewind both characters to the moment the client saw the hit, as far back as the server allows
+	URewindSubsystem* Rewind{ URewindSubsystem::Get(this) };
+	const double RewindTime{ Rewind ? Rewind->ClampRewindTime(ClientTimeStamp) : ClientTimeStamp };
+	FRewindSample AttackerSample, VictimSample;
+	if (!Rewind || !Rewind->QueryCharacter(OwnerRef, RewindTime, AttackerSample) || !Rewind->QueryCharacter(Victim, RewindTime, VictimSample))
+	{
+		const UCapsuleComponent* Capsule{ VictimCharacter->GetCapsuleComponent() };
+		AttackerSample.Location = OwnerRef->GetActorLocation();
+		VictimSample.Location = Capsule->GetComponentLocation();
+		VictimSample.Rotation = Capsule->GetComponentQuat();
+		VictimSample.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+		VictimSample.CapsuleHalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	}
+
+	if (FVector::Distance(AttackerSample.Location, VictimSample.Location) > MaxHitReach) { Reject(TEXT("victim out of reach")); return; }
+
+	// The hit has to lie on the victim's capsule
+	const FVector Axis{ VictimSample.Rotation.GetUpVector() * FMath::Max(VictimSample.CapsuleHalfHeight - VictimSample.CapsuleRadius, 0.0f) };
+	const float DistanceToCapsule{ static_cast<float>(FMath::PointDistToSegment(HitLocation, VictimSample.Location - Axis, VictimSample.Location + Axis)) - VictimSample.CapsuleRadius };
+	if (DistanceToCapsule > HitTolerance) { Reject(TEXT("hit location away from the victim")); return; }
+
+	HitVictims.Add(Victim);
+	ApplyHit(Victim, HitLocation);
+}
+
+void UMeleeComponent::ApplyHit(AActor* Victim, const FVector& HitLocation)
+{
+	if (UCrowdSubsystem* Crowd{ UCrowdSubsystem::Get(this) }) { Crowd->ApplyDamageToActor(Victim, HitDamage); }
+
+	UMeleeComponent* VictimMelee{ Victim->FindComponentByClass<UMeleeComponent>() };
+	if (!IsValid(VictimMelee)) { return; }
+
+	VictimMelee->NM_ReceiveHit(OwnerRef, HitLocation);
+}
+
+void UMeleeComponent::NM_ReceiveHit_Implementation(AActor* Attacker, FVector_NetQuantize HitLocation)
+{
+	OnMeleeHitReceivedDelegate.Broadcast(Attacker, HitLocation);
+
+#if !UE_SERVER
+	if (HitReactAnimations.Num() == 0 || !IsValid(OwnerRef)) { return; }
+
+	UAnimInstance* AnimInstance{ OwnerRef->GetMesh()->GetAnimInstance() };
+	UAnimSequenceBase* HitReact{ HitReactAnimations[FMath::RandRange(0, HitReactAnimations.Num() - 1)].Get() };
+
+	// Skipped rather than loaded synchronously if the reaction has not streamed in yet
+	if (IsValid(AnimInstance) && IsValid(HitReact))
+	{
+		AnimInstance->PlaySlotAnimationAsDynamicMontage(HitReact, HitReactSlot);
+	}
+#endif
+}
@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Combat/MeleeHitSubsystem.h"
+#include "Combat/MeleeComponent.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+
+UMeleeHitSubsystem* UMeleeHitSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UMeleeHitSubsystem>() : nullptr;
+}
+
+TStatId UMeleeHitSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeleeHitSubsystem, STATGROUP_Tickables);
+}
+
+
+
+void UMeleeHitSubsystem::RegisterHittable(UMeleeComponent* Component)
+{
+	Hittables.AddUnique(Component);
+}
+
+void UMeleeHitSubsystem::UnregisterHittable(UMeleeComponent* Component)
+{
+	Hittables.RemoveSwap(Component);
+	ActiveAttackers.RemoveSwap(Component);
+}
+
+void UMeleeHitSubsystem::BeginAttack(UMeleeComponent* Component)
+{
+	if (!IsValid(Component)) { return; }
+
+	// Start sweeping from where the sockets are now, not from where the last attack ended
+	SampleSockets(Component, Component->PrevSocketLocations, Component->PrevComponentTransform);
+	ActiveAttackers.AddUnique(Component);
+}
+
+void UMeleeHitSubsystem::EndAttack(UMeleeComponent* Component)
+{
+	ActiveAttackers.RemoveSwap(Component);
+}
+
+void UMeleeHitSubsystem::SampleSockets(UMeleeComponent* Component, TArray<FVector>& OutComponentLocations, FTransform& OutComponentTransform)
+{
+	const USkeletalMeshComponent* Mesh{ Component->OwnerRef->GetMesh() };
+
+	OutComponentTransform = Mesh->GetComponentTransform();
+	OutComponentLocations.SetNumUninitialized(Component->TraceSockets.Num());
+	for (int32 i = 0; i < Component->TraceSockets.Num(); i++)
+	{
+		OutComponentLocations[i] = Mesh->GetSocketTransform(Component->TraceSockets[i], RTS_Component).GetLocation();
+	}
+}
+
+
+
+void UMeleeHitSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	RemoveStaleComponents();
+	GatherVictims();
+	GatherSweeps();
+
+	struct FPendingHit
+	{
+		UMeleeComponent* Attacker;
+		AActor* Victim;
+		FVector Location;
+	};
+	TArray<FPendingHit, TInlineAllocator<16>> PendingHits;
+
+	const int32 NumVictims{ Hittables.Num() };
+	for (const FMeleeSweep& Sweep : Sweeps)
+	{
+		UMeleeComponent* Attacker{ ActiveAttackers[Sweep.AttackerIndex] };
+
+		for (int32 v = 0; v < NumVictims; v++)
+		{
+			// Cheap box rejection before the segment distance
+			const float VictimRadius{ VictimRadii[v] };
+			const FVector3f VictimMin{ FVector3f::Min(VictimBottoms[v], VictimTops[v]) - FVector3f(VictimRadius) };
+			const FVector3f VictimMax{ FVector3f::Max(VictimBottoms[v], VictimTops[v]) + FVector3f(VictimRadius) };
+			if (Sweep.BoundsMax.X < VictimMin.X || Sweep.BoundsMin.X > VictimMax.X ||
+				Sweep.BoundsMax.Y < VictimMin.Y || Sweep.BoundsMin.Y > VictimMax.Y ||
+				Sweep.BoundsMax.Z < VictimMin.Z || Sweep.BoundsMin.Z > VictimMax.Z)
+			{
+				continue;
+			}
+
+			AActor* Victim{ Hittables[v]->GetOwner() };
+			if (Victim == Attacker->GetOwner()) { continue; }
+			if (Attacker->HitVictims.Contains(Victim)) { continue; }
+
+			FVector SweepPoint, VictimPoint;
+			FMath::SegmentDistToSegmentSafe(FVector(Sweep.Start), FVector(Sweep.End), FVector(VictimBottoms[v]), FVector(VictimTops[v]), SweepPoint, VictimPoint);
+
+			if (FVector::DistSquared(SweepPoint, VictimPoint) > FMath::Square(Sweep.Radius + VictimRadius)) { continue; }
+
+			// Every victim is hit at most once per attack, however many sockets and sub-steps overlap it
+			Attacker->HitVictims.Add(Victim);
+			PendingHits.Add(FPendingHit{ Attacker, Victim, VictimPoint + (SweepPoint - VictimPoint).GetSafeNormal() * VictimRadius });
+		}
+	}
+
+	// Dispatched after the batch, since handling a hit may end attacks
+	for (const FPendingHit& Hit : PendingHits)
+	{
+		if (IsValid(Hit.Attacker) && IsValid(Hit.Victim)) { Hit.Attacker->HandleHit(Hit.Victim, Hit.Location); }
+	}
+}
+
+void UMeleeHitSubsystem::RemoveStaleComponents()
+{
+	auto IsStale = [](const UMeleeComponent* Component) { return !IsValid(Component) || !IsValid(Component->OwnerRef); };
+
+	Hittables.RemoveAllSwap(IsStale, EAllowShrinking::No);
+	ActiveAttackers.RemoveAllSwap(IsStale, EAllowShrinking::No);
+}
+
+void UMeleeHitSubsystem::GatherVictims()
+{
+	const int32 NumVictims{ Hittables.Num() };
+	VictimBottoms.SetNumUninitialized(NumVictims, EAllowShrinking::No);
+	VictimTops.SetNumUninitialized(NumVictims, EAllowShrinking::No);
+	VictimRadii.SetNumUninitialized(NumVictims, EAllowShrinking::No);
+
+	for (int32 v = 0; v < NumVictims; v++)
+	{
+		const UCapsuleComponent* Capsule{ Hittables[v]->OwnerRef->GetCapsuleComponent() };
+		const FVector Center{ Capsule->GetComponentLocation() };
+		const FVector Axis{ Capsule->GetUpVector() * Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere() };
+
+		VictimBottoms[v] = FVector3f(Center - Axis);
+		VictimTops[v] = FVector3f(Center + Axis);
+		VictimRadii[v] = Capsule->GetScaledCapsuleRadius();
+	}
+}
+
+void UMeleeHitSubsystem::GatherSweeps()
+{
+	Sweeps.Reset();
+
+	for (int32 a = 0; a < ActiveAttackers.Num(); a++)
+	{
+		UMeleeComponent* Attacker{ ActiveAttackers[a] };
+
+		TArray<FVector> CurrentLocations;
+		FTransform CurrentTransform;
+		SampleSockets(Attacker, CurrentLocations, CurrentTransform);
+
+		const FTransform& PrevTransform{ Attacker->PrevComponentTransform };
+		const int32 NumSockets{ FMath::Min(CurrentLocations.Num(), Attacker->PrevSocketLocations.Num()) };
+
+		for (int32 s = 0; s < NumSockets; s++)
+		{
+			const FVector& PrevLocal{ Attacker->PrevSocketLocations[s] };
+			const FVector& CurrentLocal{ CurrentLocations[s] };
+			FVector StepStart{ PrevTransform.TransformPosition(PrevLocal) };
+
+			// Sub-step the socket in component space and the component in world space, so swings follow an arc
+			// around the character instead of cutting straight through it
+			const float Distance{ static_cast<float>(FVector::Distance(StepStart, CurrentTransform.TransformPosition(CurrentLocal))) };
+			const int32 Steps{ FMath::Clamp(FMath::CeilToInt(Distance / FMath::Max(Attacker->MaxSubStepDistance, 1.0f)), 1, FMath::Max(Attacker->MaxSubSteps, 1)) };
+
+			for (int32 Step = 1; Step <= Steps; Step++)
+			{
+				const float Alpha{ static_cast<float>(Step) / Steps };
+				FTransform StepTransform;
+				StepTransform.Blend(PrevTransform, CurrentTransform, Alpha);
+				const FVector StepEnd{ StepTransform.TransformPosition(FMath::Lerp(PrevLocal, CurrentLocal, Alpha)) };
+
+				FMeleeSweep& Sweep{ Sweeps.AddDefaulted_GetRef() };
+				Sweep.Start = FVector3f(StepStart);
+				Sweep.End = FVector3f(StepEnd);
+				Sweep.Radius = Attacker->TraceRadius;
+				Sweep.BoundsMin = FVector3f::Min(Sweep.Start, Sweep.End) - FVector3f(Sweep.Radius);
+				Sweep.BoundsMax = FVector3f::Max(Sweep.Start, Sweep.End) + FVector3f(Sweep.Radius);
+				Sweep.AttackerIndex = a;
+
+				StepStart = StepEnd;
+			}
+		}
+
+		Attacker->PrevSocketLocations = MoveTemp(CurrentLocations);
+		Attacker->PrevComponentTransform = CurrentTransform;
+	}
+}
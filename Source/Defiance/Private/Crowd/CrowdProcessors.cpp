@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Crowd/CrowdProcessors.h"
+#include "Crowd/CrowdFragments.h"
+#include "Crowd/CrowdSubsystem.h"
+#include "MassCommonFragments.h"
+#include "MassExecutionContext.h"
+
+
+namespace
+{
+	/** Returns the squared distance from Location to the closest player, or MAX_dbl without players */
+	double GetClosestPlayerDistSquared(const TArray<FVector>& PlayerLocations, const FVector& Location, FVector& OutPlayerLocation)
+	{
+		double ClosestDistSquared{ MAX_dbl };
+		for (const FVector& PlayerLocation : PlayerLocations)
+		{
+			const double DistSquared{ FVector::DistSquared(PlayerLocation, Location) };
+			if (DistSquared < ClosestDistSquared)
+			{
+				ClosestDistSquared = DistSquared;
+				OutPlayerLocation = PlayerLocation;
+			}
+		}
+		return ClosestDistSquared;
+	}
+}
+
+
+
+UCrowdBehaviorProcessor::UCrowdBehaviorProcessor()
+	: EntityQuery(*this)
+{
+	// The crowd is simulated by the server; clients only see the promoted actors
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+	ExecutionOrder.ExecuteBefore.Add(UCrowdMovementProcessor::StaticClass()->GetFName());
+}
+
+void UCrowdBehaviorProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FCrowdMovementFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FCrowdActorFragment>(EMassFragmentAccess::ReadOnly);
+}
+
+void UCrowdBehaviorProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const UCrowdSubsystem* Crowd{ UCrowdSubsystem::Get(EntityManager.GetWorld()) };
+	if (!Crowd) { return; }
+
+	const TArray<FVector>& PlayerLocations{ Crowd->GetPlayerLocations() };
+	const double AggroRadiusSquared{ FMath::Square(Crowd->AggroRadius) };
+	const float WanderRadius{ Crowd->WanderRadius };
+	const float DeltaTime{ Context.GetDeltaTimeSeconds() };
+
+	EntityQuery.ForEachEntityChunk(Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const TConstArrayView<FTransformFragment> Transforms{ ChunkContext.GetFragmentView<FTransformFragment>() };
+		const TArrayView<FCrowdMovementFragment> Movements{ ChunkContext.GetMutableFragmentView<FCrowdMovementFragment>() };
+		const TConstArrayView<FCrowdActorFragment> Actors{ ChunkContext.GetFragmentView<FCrowdActorFragment>() };
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); i++)
+		{
+			// Promoted members are driven by their actor
+			if (Actors[i].Actor.IsValid()) { continue; }
+
+			FCrowdMovementFragment& Movement{ Movements[i] };
+			const FVector Location{ Transforms[i].GetTransform().GetLocation() };
+
+			FVector PlayerLocation;
+			if (GetClosestPlayerDistSquared(PlayerLocations, Location, PlayerLocation) < AggroRadiusSquared)
+			{
+				Movement.Goal = PlayerLocation;
+			}
+			else
+			{
+				Movement.WanderTimeLeft -= DeltaTime;
+				if (Movement.WanderTimeLeft <= 0.0f)
+				{
+					FRandomStream Stream(static_cast<int32>(Movement.RandomSeed));
+					Movement.Goal = Movement.Home + FVector(Stream.GetUnitVector().GetSafeNormal2D() * Stream.FRandRange(0.0f, WanderRadius));
+					Movement.WanderTimeLeft = Stream.FRandRange(3.0f, 8.0f);
+					Movement.RandomSeed = Stream.GetCurrentSeed();
+				}
+			}
+
+			// Stop short of the goal instead of walking into the player
+			const FVector ToGoal{ FVector(Movement.Goal - Location) * FVector(1.0, 1.0, 0.0) };
+			Movement.Velocity = (ToGoal.SizeSquared() > FMath::Square(100.0)) ? ToGoal.GetSafeNormal() * Movement.MaxSpeed : FVector::ZeroVector;
+		}
+	});
+}
+
+
+
+UCrowdMovementProcessor::UCrowdMovementProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+}
+
+void UCrowdMovementProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FCrowdMovementFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FCrowdActorFragment>(EMassFragmentAccess::ReadOnly);
+}
+
+void UCrowdMovementProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const float DeltaTime{ Context.GetDeltaTimeSeconds() };
+
+	EntityQuery.ForEachEntityChunk(Context, [DeltaTime](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FTransformFragment> Transforms{ ChunkContext.GetMutableFragmentView<FTransformFragment>() };
+		const TConstArrayView<FCrowdMovementFragment> Movements{ ChunkContext.GetFragmentView<FCrowdMovementFragment>() };
+		const TConstArrayView<FCrowdActorFragment> Actors{ ChunkContext.GetFragmentView<FCrowdActorFragment>() };
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); i++)
+		{
+			if (Actors[i].Actor.IsValid()) { continue; }
+
+			const FVector& Velocity{ Movements[i].Velocity };
+			if (Velocity.IsNearlyZero()) { continue; }
+
+			FTransform& Transform{ Transforms[i].GetMutableTransform() };
+			Transform.AddToTranslation(Velocity * DeltaTime);
+			Transform.SetRotation(Velocity.ToOrientationQuat());
+		}
+	});
+}
+
+
+
+UCrowdSyncProcessor::UCrowdSyncProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::Server | EProcessorExecutionFlags::Standalone);
+	// Reads actors, so it runs on the game thread once they have moved
+	ProcessingPhase = EMassProcessingPhase::PostPhysics;
+	bRequiresGameThreadExecution = true;
+}
+
+void UCrowdSyncProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FCrowdActorFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FCrowdHealthFragment>(EMassFragmentAccess::ReadOnly);
+}
+
+void UCrowdSyncProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UCrowdSubsystem* Crowd{ UCrowdSubsystem::Get(EntityManager.GetWorld()) };
+	if (!Crowd) { return; }
+
+	Crowd->LockableEntities.Reset();
+	Crowd->LockableLocations.Reset();
+
+	const TArray<FVector>& PlayerLocations{ Crowd->GetPlayerLocations() };
+	const double PromoteDistSquared{ FMath::Square(Crowd->PromotionRadius) };
+	const double DemoteDistSquared{ FMath::Square(Crowd->PromotionRadius + Crowd->DemotionHysteresis) };
+
+	EntityQuery.ForEachEntityChunk(Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FTransformFragment> Transforms{ ChunkContext.GetMutableFragmentView<FTransformFragment>() };
+		const TConstArrayView<FCrowdActorFragment> Actors{ ChunkContext.GetFragmentView<FCrowdActorFragment>() };
+		const TConstArrayView<FCrowdHealthFragment> Healths{ ChunkContext.GetFragmentView<FCrowdHealthFragment>() };
+		const bool bLockable{ ChunkContext.DoesArchetypeHaveTag<FCrowdLockableTag>() };
+
+		for (int32 i = 0; i < ChunkContext.GetNumEntities(); i++)
+		{
+			const FMassEntityHandle Entity{ ChunkContext.GetEntity(i) };
+
+			// Killed as an entity, or its actor was destroyed by gameplay
+			if (Healths[i].Health <= 0.0f || Actors[i].Actor.IsStale())
+			{
+				Crowd->PendingDeaths.Add(Entity);
+				continue;
+			}
+
+			FTransform& Transform{ Transforms[i].GetMutableTransform() };
+			const AActor* Actor{ Actors[i].Actor.Get() };
+			if (Actor) { Transform = Actor->GetActorTransform(); }
+
+			FVector PlayerLocation;
+			const double ClosestDistSquared{ GetClosestPlayerDistSquared(PlayerLocations, Transform.GetLocation(), PlayerLocation) };
+
+			if (Actor)
+			{
+				if (ClosestDistSquared > DemoteDistSquared) { Crowd->PendingDemotions.Add(Entity); }
+				continue;
+			}
+
+			if (ClosestDistSquared < PromoteDistSquared) { Crowd->PendingPromotions.Add(Entity); }
+
+			if (bLockable)
+			{
+				Crowd->LockableEntities.Add(Entity);
+				Crowd->LockableLocations.Add(Transform.GetLocation());
+			}
+		}
+	});
+}
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Crowd/CrowdSpawner.h"
+#include "Crowd/CrowdSubsystem.h"
+
+
+// Sets default values
+ACrowdSpawner::ACrowdSpawner()
+{
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+// Called when the game starts or when spawned
+void ACrowdSpawner::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!HasAuthority()) { return; }
+
+	if (UCrowdSubsystem* Crowd{ UCrowdSubsystem::Get(this) })
+	{
+		Crowd->SpawnCrowd(Count, GetActorLocation(), Radius, Team, MaxSpeed, PromotedActorClass, bLockable);
+	}
+}
@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Crowd/CrowdSubsystem.h"
+#include "MemoryTags.h"
+#include "Crowd/CrowdFragments.h"
+#include "Characters/ActorPoolSubsystem.h"
+#include "MassEntitySubsystem.h"
+#include "MassEntityManager.h"
+#include "MassCommonFragments.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+
+
+UCrowdSubsystem* UCrowdSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UCrowdSubsystem>() : nullptr;
+}
+
+TStatId UCrowdSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCrowdSubsystem, STATGROUP_Tickables);
+}
+
+FMassEntityManager* UCrowdSubsystem::GetEntityManager() const
+{
+	UMassEntitySubsystem* EntitySubsystem{ GetWorld()->GetSubsystem<UMassEntitySubsystem>() };
+	return EntitySubsystem ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+}
+
+
+
+void UCrowdSubsystem::SpawnCrowd(int32 Count, const FVector& Center, float Radius, uint8 Team, float MaxSpeed, TSubclassOf<AActor> ActorClass, bool bLockable)
+{
+	LLM_SCOPE_BYTAG(Defiance_Crowd);
+
+	if (Count <= 0 || GetWorld()->GetNetMode() == NM_Client) { return; }
+
+	FMassEntityManager* EntityManager{ GetEntityManager() };
+	if (!EntityManager)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UCrowdSubsystem [SpawnCrowd]: Mass is not available in this world."))
+		return;
+	}
+
+	TArray<const UScriptStruct*, TInlineAllocator<6>> Composition{
+		FTransformFragment::StaticStruct(),
+		FCrowdTeamFragment::StaticStruct(),
+		FCrowdHealthFragment::StaticStruct(),
+		FCrowdMovementFragment::StaticStruct(),
+		FCrowdActorFragment::StaticStruct()
+	};
+	if (bLockable) { Composition.Add(FCrowdLockableTag::StaticStruct()); }
+
+	const FMassArchetypeHandle Archetype{ EntityManager->CreateArchetype(Composition) };
+
+	TArray<FMassEntityHandle> Entities;
+	TSharedRef<FMassEntityManager::FEntityCreationContext> CreationContext{ EntityManager->BatchCreateEntities(Archetype, Count, Entities) };
+
+	FRandomStream Stream(static_cast<int32>(GetTypeHash(Center)));
+	for (const FMassEntityHandle& Entity : Entities)
+	{
+		const FVector Location{ Center + FVector(Stream.GetUnitVector().GetSafeNormal2D() * Stream.FRandRange(0.0f, Radius)) };
+
+		EntityManager->GetFragmentDataChecked<FTransformFragment>(Entity).SetTransform(FTransform(Location));
+		EntityManager->GetFragmentDataChecked<FCrowdTeamFragment>(Entity).Team = Team;
+
+		FCrowdMovementFragment& Movement{ EntityManager->GetFragmentDataChecked<FCrowdMovementFragment>(Entity) };
+		Movement.Home = Location;
+		Movement.Goal = Location;
+		Movement.MaxSpeed = MaxSpeed;
+		Movement.RandomSeed = Stream.GetUnsignedInt();
+
+		EntityManager->GetFragmentDataChecked<FCrowdActorFragment>(Entity).ActorClass = ActorClass.Get();
+	}
+}
+
+
+
+void UCrowdSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (GetWorld()->GetNetMode() == NM_Client) { return; }
+
+	PlayerLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APawn* Pawn{ It->IsValid() ? (*It)->GetPawn() : nullptr };
+		if (IsValid(Pawn)) { PlayerLocations.Add(Pawn->GetActorLocation()); }
+	}
+
+	FMassEntityManager* EntityManager{ GetEntityManager() };
+	if (!EntityManager) { return; }
+
+	for (const FMassEntityHandle& Entity : PendingDeaths)
+	{
+		if (!EntityManager->IsEntityValid(Entity)) { continue; }
+
+		if (AActor* Actor{ EntityManager->GetFragmentDataChecked<FCrowdActorFragment>(Entity).Actor.Get() })
+		{
+			if (UActorPoolSubsystem* Pool{ UActorPoolSubsystem::Get(this) }) { Pool->Release(Actor); }
+		}
+
+		// The actor may already be gone, so the entry is found by its entity
+		for (TMap<TObjectKey<AActor>, FMassEntityHandle>::TIterator It = PromotedActors.CreateIterator(); It; ++It)
+		{
+			if (It.Value() == Entity) { It.RemoveCurrent(); }
+		}
+		EntityManager->DestroyEntity(Entity);
+	}
+
+	for (const FMassEntityHandle& Entity : PendingPromotions) { Promote(Entity); }
+	for (const FMassEntityHandle& Entity : PendingDemotions) { Demote(Entity); }
+
+	PendingDeaths.Reset();
+	PendingPromotions.Reset();
+	PendingDemotions.Reset();
+}
+
+AActor* UCrowdSubsystem::Promote(FMassEntityHandle Entity)
+{
+	FMassEntityManager* EntityManager{ GetEntityManager() };
+	if (!EntityManager || !EntityManager->IsEntityValid(Entity)) { return nullptr; }
+
+	FCrowdActorFragment& ActorFragment{ EntityManager->GetFragmentDataChecked<FCrowdActorFragment>(Entity) };
+	if (AActor* Actor{ ActorFragment.Actor.Get() }) { return Actor; }
+
+	UClass* ActorClass{ ActorFragment.ActorClass.Get() };
+	if (!ActorClass) { return nullptr; }
+
+	UActorPoolSubsystem* Pool{ UActorPoolSubsystem::Get(this) };
+	if (!Pool) { return nullptr; }
+
+	const FTransform& Transform{ EntityManager->GetFragmentDataChecked<FTransformFragment>(Entity).GetTransform() };
+	AActor* Actor{ Pool->Acquire(ActorClass, Transform) };
+	if (!IsValid(Actor)) { return nullptr; }
+
+	ActorFragment.Actor = Actor;
+	PromotedActors.Add(Actor, Entity);
+	return Actor;
+}
+
+void UCrowdSubsystem::Demote(FMassEntityHandle Entity)
+{
+	FMassEntityManager* EntityManager{ GetEntityManager() };
+	if (!EntityManager || !EntityManager->IsEntityValid(Entity)) { return; }
+
+	FCrowdActorFragment& ActorFragment{ EntityManager->GetFragmentDataChecked<FCrowdActorFragment>(Entity) };
+	AActor* Actor{ ActorFragment.Actor.Get() };
+	if (!Actor) { return; }
+
+	// The transform was copied from the actor this frame; carry on from there
+	FCrowdMovementFragment& Movement{ EntityManager->GetFragmentDataChecked<FCrowdMovementFragment>(Entity) };
+	Movement.Goal = Actor->GetActorLocation();
+	Movement.Velocity = FVector::ZeroVector;
+
+	PromotedActors.Remove(Actor);
+	ActorFragment.Actor = nullptr;
+	if (UActorPoolSubsystem* Pool{ UActorPoolSubsystem::Get(this) }) { Pool->Release(Actor); }
+}
+
+
+
+void UCrowdSubsystem::FindLockOnCandidates(const FVector& Origin, float Radius, TArray<FCrowdLockOnCandidate>& OutCandidates) const
+{
+	const double RadiusSquared{ FMath::Square(Radius) };
+	for (int32 i = 0; i < LockableLocations.Num(); i++)
+	{
+		if (FVector::DistSquared(Origin, LockableLocations[i]) <= RadiusSquared)
+		{
+			OutCandidates.Add(FCrowdLockOnCandidate{ LockableLocations[i], LockableEntities[i] });
+		}
+	}
+}
+
+FMassEntityHandle UCrowdSubsystem::FindEntityForActor(const AActor* Actor) const
+{
+	const FMassEntityHandle* Entity{ PromotedActors.Find(Actor) };
+	return Entity ? *Entity : FMassEntityHandle();
+}
+
+bool UCrowdSubsystem::ApplyDamageToActor(const AActor* Actor, float Damage)
+{
+	const FMassEntityHandle Entity{ FindEntityForActor(Actor) };
+	FMassEntityManager* EntityManager{ GetEntityManager() };
+	if (!Entity.IsSet() || !EntityManager || !EntityManager->IsEntityValid(Entity)) { return false; }
+
+	// Deaths are picked up by UCrowdSyncProcessor
+	EntityManager->GetFragmentDataChecked<FCrowdHealthFragment>(Entity).Health -= Damage;
+	return true;
+}
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/CharacterMemoryCommandlet.h"
+#include "Debug/CharacterMemoryReport.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+
+UCharacterMemoryCommandlet::UCharacterMemoryCommandlet()
+{
+	IsClient = false;
+	IsServer = true;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UCharacterMemoryCommandlet::Main(const FString& Params)
+{
+	int32 Count{ 50 };
+	FParse::Value(*Params, TEXT("Count="), Count);
+
+	FString ClassPath;
+	FParse::Value(*Params, TEXT("Class="), ClassPath);
+
+	UClass* CharacterClass{ FCharacterMemoryReport::LoadCharacterClass(ClassPath) };
+	if (!CharacterClass)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UCharacterMemoryCommandlet [Main]: Could not load the character class %s."), ClassPath.IsEmpty() ? FCharacterMemoryReport::DefaultCharacterClassPath : *ClassPath)
+		return 1;
+	}
+
+	// An empty game world that has begun play, so the characters run their BeginPlay like they would in a match
+	UWorld* World{ UWorld::CreateWorld(EWorldType::Game, false, TEXT("CharacterMemoryWorld")) };
+	FWorldContext& WorldContext{ GEngine->CreateNewWorldContext(EWorldType::Game) };
+	WorldContext.SetCurrentWorld(World);
+
+	const FURL URL;
+	World->SetGameMode(URL);
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+
+	FCharacterMemoryReport::Run(World, CharacterClass, Count, *GLog);
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	return 0;
+}
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/CharacterMemoryReport.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectHash.h"
+#include "HAL/IConsoleManager.h"
+
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice CharacterMemoryReportCommand(
+	TEXT("defiance.Memory.CharacterReport"),
+	TEXT("Spawns characters and prints the memory taken by each of their objects. Args: [Count=10] [ClassPath]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const int32 Count{ Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 10 };
+		FCharacterMemoryReport::Run(World, FCharacterMemoryReport::LoadCharacterClass(Args.Num() > 1 ? Args[1] : FString()), Count, Ar);
+	}));
+
+
+const TCHAR* FCharacterMemoryReport::DefaultCharacterClassPath{ TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C") };
+
+UClass* FCharacterMemoryReport::LoadCharacterClass(const FString& ClassPath)
+{
+	return LoadClass<ACharacter>(nullptr, ClassPath.IsEmpty() ? DefaultCharacterClassPath : *ClassPath);
+}
+
+
+
+namespace
+{
+	struct FObjectTypeSize
+	{
+		int32 Count{ 0 };
+
+		/** Size of the object and everything its properties allocate, as counted by FArchiveCountMem */
+		SIZE_T ObjectBytes{ 0 };
+
+		/** Extra resources reported by GetResourceSizeEx (render data, pose buffers, ...) */
+		SIZE_T ResourceBytes{ 0 };
+
+		/** Replicated properties; the server keeps a shadow copy of these for every connection the object replicates to */
+		SIZE_T ReplicatedBytes{ 0 };
+	};
+
+	SIZE_T GetReplicatedPropertiesSize(const UClass* Class)
+	{
+		SIZE_T Size{ 0 };
+		for (TFieldIterator<FProperty> It(Class); It; ++It)
+		{
+			if (It->HasAnyPropertyFlags(CPF_Net)) { Size += It->GetSize(); }
+		}
+		return Size;
+	}
+}
+
+void FCharacterMemoryReport::Run(UWorld* World, UClass* CharacterClass, int32 Count, FOutputDevice& Ar)
+{
+	if (!IsValid(World) || !CharacterClass || Count <= 0)
+	{
+		Ar.Logf(ELogVerbosity::Warning, TEXT("FCharacterMemoryReport [Run]: A world and a character class are needed."));
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	TArray<ACharacter*> Characters;
+	Characters.Reserve(Count);
+	for (int32 i = 0; i < Count; i++)
+	{
+		// Spread out far from gameplay so they do not push each other around
+		const FVector Location{ -50000.0 + 200.0 * (i % 20), -50000.0 + 200.0 * (i / 20), 0.0 };
+		if (ACharacter* Character{ World->SpawnActor<ACharacter>(CharacterClass, FTransform(Location), SpawnParams) })
+		{
+			Characters.Add(Character);
+		}
+	}
+
+	TMap<const UClass*, FObjectTypeSize> Sizes;
+	TMap<const UClass*, SIZE_T> ReplicatedSizes;
+	TArray<UObject*> Objects;
+	for (ACharacter* Character : Characters)
+	{
+		// Components, anim instances and anything else the character created are outered to it
+		Objects.Reset();
+		Objects.Add(Character);
+		GetObjectsWithOuter(Character, Objects, true);
+		if (AController* Controller{ Character->GetController() }) { Objects.Add(Controller); }
+
+		for (UObject* Object : Objects)
+		{
+			const UClass* Class{ Object->GetClass() };
+			FObjectTypeSize& Size{ Sizes.FindOrAdd(Class) };
+
+			FArchiveCountMem CountMem(Object);
+			Size.Count++;
+			Size.ObjectBytes += CountMem.GetMax();
+			Size.ResourceBytes += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+			if (!ReplicatedSizes.Contains(Class)) { ReplicatedSizes.Add(Class, GetReplicatedPropertiesSize(Class)); }
+			Size.ReplicatedBytes += ReplicatedSizes[Class];
+		}
+	}
+
+	Sizes.ValueSort([](const FObjectTypeSize& A, const FObjectTypeSize& B) { return A.ObjectBytes + A.ResourceBytes > B.ObjectBytes + B.ResourceBytes; });
+
+	const int32 NumCharacters{ FMath::Max(1, Characters.Num()) };
+	Ar.Logf(TEXT("FCharacterMemoryReport [Run]: %s, %d characters. Bytes per character:"), *CharacterClass->GetName(), Characters.Num());
+	Ar.Logf(TEXT("%-48s %8s %12s %12s %12s"), TEXT("Class"), TEXT("Count"), TEXT("Object"), TEXT("Resource"), TEXT("Replicated"));
+
+	FObjectTypeSize Total;
+	for (const TPair<const UClass*, FObjectTypeSize>& Size : Sizes)
+	{
+		Ar.Logf(TEXT("%-48s %8.1f %12llu %12llu %12llu"), *Size.Key->GetName(),
+			static_cast<float>(Size.Value.Count) / NumCharacters,
+			static_cast<uint64>(Size.Value.ObjectBytes / NumCharacters),
+			static_cast<uint64>(Size.Value.ResourceBytes / NumCharacters),
+			static_cast<uint64>(Size.Value.ReplicatedBytes / NumCharacters));
+
+		Total.Count += Size.Value.Count;
+		Total.ObjectBytes += Size.Value.ObjectBytes;
+		Total.ResourceBytes += Size.Value.ResourceBytes;
+		Total.ReplicatedBytes += Size.Value.ReplicatedBytes;
+	}
+
+	Ar.Logf(TEXT("%-48s %8.1f %12llu %12llu %12llu"), TEXT("Total"),
+		static_cast<float>(Total.Count) / NumCharacters,
+		static_cast<uint64>(Total.ObjectBytes / NumCharacters),
+		static_cast<uint64>(Total.ResourceBytes / NumCharacters),
+		static_cast<uint64>(Total.ReplicatedBytes / NumCharacters));
+	Ar.Logf(TEXT("Replicated bytes are held once more per connection on the server. Run with -llm and \"stat LLMFULL\" for the Defiance tag totals."));
+
+	for (ACharacter* Character : Characters)
+	{
+		if (IsValid(Character)) { Character->Destroy(); }
+	}
+}
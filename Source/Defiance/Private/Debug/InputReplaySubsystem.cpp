@@ -0,0 +1,400 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/InputReplaySubsystem.h"
+#include "Physics/GameplayQuerySubsystem.h"
+#include "MyInputConfigData.h"
+#include "InputAction.h"
+#include "EnhancedPlayerInput.h"
+#include "EnhancedInputSubsystems.h"
+#include "Engine/World.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CommandLine.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "HAL/IConsoleManager.h"
+
+
+static FAutoConsoleCommandWithWorldAndArgs InputRecordCommand(
+	TEXT("defiance.Input.Record"),
+	TEXT("Records the local player's input actions. Args: <Name> [InputConfigPath]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UInputReplaySubsystem* Replay{ UInputReplaySubsystem::Get(World) };
+		if (!Replay || Args.Num() == 0) { return; }
+
+		UMyInputConfigData* InputConfig{ LoadObject<UMyInputConfigData>(nullptr, Args.Num() > 1 ? *Args[1] : UInputReplaySubsystem::DefaultInputConfigPath) };
+		Replay->StartRecording(Args[0], InputConfig);
+	}));
+
+static FAutoConsoleCommandWithWorld InputStopRecordingCommand(
+	TEXT("defiance.Input.StopRecording"),
+	TEXT("Stops recording input and saves the file."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UInputReplaySubsystem* Replay{ UInputReplaySubsystem::Get(World) }) { Replay->StopRecording(); }
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs InputReplayCommand(
+	TEXT("defiance.Input.Replay"),
+	TEXT("Feeds a recording to the local player and logs frame times and query counts when done. Args: <Name>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UInputReplaySubsystem* Replay{ UInputReplaySubsystem::Get(World) };
+		if (Replay && Args.Num() > 0) { Replay->StartReplay(Args[0]); }
+	}));
+
+
+namespace
+{
+	constexpr uint32 InputReplayMagic{ 0x52494644 }; // "DFIR"
+	constexpr uint32 InputReplayVersion{ 1 };
+
+	int32 GetNumComponents(EInputActionValueType ValueType)
+	{
+		switch (ValueType)
+		{
+		case EInputActionValueType::Axis2D: return 2;
+		case EInputActionValueType::Axis3D: return 3;
+		default: return 1;
+		}
+	}
+
+	float GetPercentile(TArray<float> Values, float Percentile)
+	{
+		if (Values.Num() == 0) { return 0.0f; }
+
+		Values.Sort();
+		return Values[FMath::Clamp(FMath::FloorToInt32(Percentile * Values.Num()), 0, Values.Num() - 1)];
+	}
+
+	float GetAverage(const TArray<float>& Values)
+	{
+		if (Values.Num() == 0) { return 0.0f; }
+
+		double Sum{ 0.0 };
+		for (const float Value : Values) { Sum += Value; }
+		return static_cast<float>(Sum / Values.Num());
+	}
+}
+
+
+const TCHAR* UInputReplaySubsystem::DefaultInputConfigPath{ TEXT("/Game/ThirdPerson/Input/InputCofigData.InputCofigData") };
+
+UInputReplaySubsystem* UInputReplaySubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UInputReplaySubsystem>() : nullptr;
+}
+
+TStatId UInputReplaySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInputReplaySubsystem, STATGROUP_Tickables);
+}
+
+bool UInputReplaySubsystem::IsTickable() const
+{
+	return Mode != EMode::Idle || !PendingReplayName.IsEmpty();
+}
+
+FString UInputReplaySubsystem::GetReplayFilePath(const FString& Name)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("InputReplays"), Name + TEXT(".dfinput"));
+}
+
+UEnhancedInputLocalPlayerSubsystem* UInputReplaySubsystem::GetInputSubsystem() const
+{
+	APlayerController* PlayerController{ GetWorld()->GetFirstPlayerController() };
+	ULocalPlayer* LocalPlayer{ PlayerController ? PlayerController->GetLocalPlayer() : nullptr };
+	return LocalPlayer ? LocalPlayer->GetSubsystem<UEnhancedInputLocalPlayerSubsystem>() : nullptr;
+}
+
+void UInputReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	FString ReplayName;
+	if (InWorld.IsGameWorld() && FParse::Value(FCommandLine::Get(), TEXT("DefianceReplay="), ReplayName))
+	{
+		PendingReplayName = ReplayName;
+	}
+}
+
+
+
+bool UInputReplaySubsystem::StartRecording(const FString& Name, UMyInputConfigData* InputConfig)
+{
+	APlayerController* PlayerController{ GetWorld()->GetFirstPlayerController() };
+	APawn* Pawn{ PlayerController ? PlayerController->GetPawn() : nullptr };
+	if (Mode != EMode::Idle || !IsValid(InputConfig) || !IsValid(Pawn))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UInputReplaySubsystem [StartRecording]: Needs an input config and a local player with a pawn, and no recording or replay running."))
+		return false;
+	}
+
+	// Every input action of the config is recorded, so new actions are picked up without touching this code
+	Actions.Reset();
+	for (TFieldIterator<FObjectProperty> It(InputConfig->GetClass()); It; ++It)
+	{
+		if (!It->PropertyClass->IsChildOf(UInputAction::StaticClass())) { continue; }
+
+		UInputAction* Action{ Cast<UInputAction>(It->GetObjectPropertyValue_InContainer(InputConfig)) };
+		if (Action && Actions.Num() < MAX_uint8) { Actions.AddUnique(Action); }
+	}
+
+	Events.Reset();
+	FrameDeltas.Reset();
+	FilePath = GetReplayFilePath(Name);
+	StartTransform = Pawn->GetActorTransform();
+	StartControlRotation = PlayerController->GetControlRotation();
+
+	// Recorded so gameplay randomness repeats on replay
+	RandomSeed = static_cast<int32>(FPlatformTime::Cycles());
+	FMath::RandInit(RandomSeed);
+	FMath::SRandInit(RandomSeed);
+
+	StartFrame = GFrameCounter;
+	Mode = EMode::Recording;
+	return true;
+}
+
+void UInputReplaySubsystem::StopRecording()
+{
+	if (Mode != EMode::Recording) { return; }
+
+	Mode = EMode::Idle;
+	if (SaveFile())
+	{
+		UE_LOG(LogTemp, Display, TEXT("UInputReplaySubsystem [StopRecording]: Saved %d frames and %d events to %s."), FrameDeltas.Num(), Events.Num(), *FilePath)
+	}
+}
+
+bool UInputReplaySubsystem::StartReplay(const FString& Name, bool bInExitWhenDone)
+{
+	if (Mode != EMode::Idle) { return false; }
+
+	FilePath = GetReplayFilePath(Name);
+	if (!LoadFile())
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInputReplaySubsystem [StartReplay]: Could not load %s."), *FilePath)
+		if (bInExitWhenDone) { FPlatformMisc::RequestExit(false, TEXT("UInputReplaySubsystem")); }
+		return false;
+	}
+
+	APlayerController* PlayerController{ GetWorld()->GetFirstPlayerController() };
+	APawn* Pawn{ PlayerController ? PlayerController->GetPawn() : nullptr };
+	if (!IsValid(Pawn) || !GetInputSubsystem())
+	{
+		UE_LOG(LogTemp, Error, TEXT("UInputReplaySubsystem [StartReplay]: The local player has no pawn or no Enhanced Input."))
+		return false;
+	}
+
+	Pawn->SetActorTransform(StartTransform, false, nullptr, ETeleportType::ResetPhysics);
+	PlayerController->SetControlRotation(StartControlRotation);
+	FMath::RandInit(RandomSeed);
+	FMath::SRandInit(RandomSeed);
+
+	// Every frame runs with the delta time it had when recorded
+	bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+	SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+
+	GameThreadTimes.Reset(FrameDeltas.Num());
+	FrameTimes.Reset(FrameDeltas.Num());
+	LastFrameTime = FPlatformTime::Seconds();
+	if (UGameplayQuerySubsystem* Queries{ UGameplayQuerySubsystem::Get(this) })
+	{
+		StartQueriesRun = Queries->NumQueriesRun;
+		StartQueriesShared = Queries->NumQueriesShared;
+		StartQueriesDeferred = Queries->NumQueriesDeferred;
+	}
+
+	// Frame 0 is the next one; its input is injected by this frame's tick
+	StartFrame = GFrameCounter + 1;
+	NextEvent = 0;
+	bExitWhenDone = bInExitWhenDone;
+	Mode = EMode::Replaying;
+	return true;
+}
+
+
+
+void UInputReplaySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!PendingReplayName.IsEmpty())
+	{
+		APlayerController* PlayerController{ GetWorld()->GetFirstPlayerController() };
+		if (PlayerController && PlayerController->GetPawn())
+		{
+			StartReplay(PendingReplayName, true);
+			PendingReplayName.Reset();
+		}
+		return;
+	}
+
+	switch (Mode)
+	{
+	case EMode::Recording: TickRecording(); break;
+	case EMode::Replaying: TickReplay(); break;
+	default: break;
+	}
+}
+
+void UInputReplaySubsystem::TickRecording()
+{
+	APlayerController* PlayerController{ GetWorld()->GetFirstPlayerController() };
+	const UEnhancedPlayerInput* PlayerInput{ PlayerController ? Cast<UEnhancedPlayerInput>(PlayerController->PlayerInput) : nullptr };
+	if (!PlayerInput) { return; }
+
+	// Subsystems tick after the player controller, so this is the input processed during this frame
+	const uint32 Frame{ static_cast<uint32>(GFrameCounter - StartFrame) };
+	FrameDeltas.Add(static_cast<float>(FApp::GetDeltaTime()));
+
+	for (int32 i = 0; i < Actions.Num(); i++)
+	{
+		const FInputActionInstance* Instance{ PlayerInput->FindActionInstanceData(Actions[i]) };
+		if (!Instance || !Instance->GetValue().IsNonZero()) { continue; }
+
+		const FInputActionValue Value{ Instance->GetValue() };
+		Events.Add(FInputReplayEvent{ Frame, static_cast<uint8>(i), Value.GetValueType(), Value.Get<FVector>() });
+	}
+}
+
+void UInputReplaySubsystem::TickReplay()
+{
+	const double Now{ FPlatformTime::Seconds() };
+	if (GFrameCounter >= StartFrame)
+	{
+		GameThreadTimes.Add(static_cast<float>(FPlatformTime::ToMilliseconds(GGameThreadTime)));
+		FrameTimes.Add(static_cast<float>((Now - LastFrameTime) * 1000.0));
+	}
+	LastFrameTime = Now;
+
+	// Injected input is processed by the player controller on the next frame
+	const uint64 InjectFrame{ GFrameCounter + 1 - StartFrame };
+	if (InjectFrame >= static_cast<uint64>(FrameDeltas.Num()))
+	{
+		FinishReplay();
+		return;
+	}
+
+	FApp::SetFixedDeltaTime(FrameDeltas[InjectFrame]);
+
+	UEnhancedInputLocalPlayerSubsystem* InputSubsystem{ GetInputSubsystem() };
+	while (NextEvent < Events.Num() && Events[NextEvent].Frame <= InjectFrame)
+	{
+		const FInputReplayEvent& Event{ Events[NextEvent++] };
+		if (Event.Frame == InjectFrame && InputSubsystem && Actions.IsValidIndex(Event.ActionIndex) && Actions[Event.ActionIndex])
+		{
+			InputSubsystem->InjectInputForAction(Actions[Event.ActionIndex], FInputActionValue(Event.ValueType, Event.Value), {}, {});
+		}
+	}
+}
+
+void UInputReplaySubsystem::FinishReplay()
+{
+	Mode = EMode::Idle;
+	FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+
+	uint64 QueriesRun{ 0 };
+	uint64 QueriesShared{ 0 };
+	uint64 QueriesDeferred{ 0 };
+	if (UGameplayQuerySubsystem* Queries{ UGameplayQuerySubsystem::Get(this) })
+	{
+		QueriesRun = Queries->NumQueriesRun - StartQueriesRun;
+		QueriesShared = Queries->NumQueriesShared - StartQueriesShared;
+		QueriesDeferred = Queries->NumQueriesDeferred - StartQueriesDeferred;
+	}
+
+	// One line with fixed keys so runs of different builds can be compared by a script
+	UE_LOG(LogTemp, Display, TEXT("UInputReplaySubsystem [FinishReplay]: Result File=%s Frames=%d GameThreadAvgMs=%.3f GameThreadP95Ms=%.3f GameThreadMaxMs=%.3f FrameAvgMs=%.3f FrameP95Ms=%.3f QueriesRun=%llu QueriesShared=%llu QueriesDeferred=%llu"),
+		*FPaths::GetBaseFilename(FilePath), GameThreadTimes.Num(),
+		GetAverage(GameThreadTimes), GetPercentile(GameThreadTimes, 0.95f), GetPercentile(GameThreadTimes, 1.0f),
+		GetAverage(FrameTimes), GetPercentile(FrameTimes, 0.95f),
+		QueriesRun, QueriesShared, QueriesDeferred)
+
+	if (bExitWhenDone) { FPlatformMisc::RequestExit(false, TEXT("UInputReplaySubsystem")); }
+}
+
+
+
+void UInputReplaySubsystem::SerializeRecording(FArchive& Ar)
+{
+	uint32 Magic{ InputReplayMagic };
+	uint32 Version{ InputReplayVersion };
+	Ar << Magic << Version;
+	if (Ar.IsLoading() && (Magic != InputReplayMagic || Version != InputReplayVersion))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << RandomSeed << StartTransform << StartControlRotation;
+
+	// Actions are stored by path so a recording survives reordering the config
+	int32 NumActions{ Actions.Num() };
+	Ar << NumActions;
+	if (Ar.IsLoading()) { Actions.SetNum(FMath::Clamp(NumActions, 0, static_cast<int32>(MAX_uint8))); }
+	for (TObjectPtr<UInputAction>& Action : Actions)
+	{
+		FSoftObjectPath ActionPath{ Action.Get() };
+		Ar << ActionPath;
+		if (Ar.IsLoading()) { Action = Cast<UInputAction>(ActionPath.TryLoad()); }
+	}
+
+	Ar << FrameDeltas;
+
+	// Events are sorted by frame, so frames are stored as packed deltas and each value only as wide as its type
+	int32 NumEvents{ Events.Num() };
+	Ar << NumEvents;
+	if (Ar.IsLoading()) { Events.SetNum(FMath::Max(0, NumEvents)); }
+
+	uint32 PreviousFrame{ 0 };
+	for (FInputReplayEvent& Event : Events)
+	{
+		uint32 FrameDelta{ Event.Frame - PreviousFrame };
+		Ar.SerializeIntPacked(FrameDelta);
+		Event.Frame = PreviousFrame + FrameDelta;
+		PreviousFrame = Event.Frame;
+
+		uint8 ValueType{ static_cast<uint8>(Event.ValueType) };
+		Ar << Event.ActionIndex << ValueType;
+		Event.ValueType = static_cast<EInputActionValueType>(ValueType);
+
+		for (int32 i = 0; i < GetNumComponents(Event.ValueType); i++)
+		{
+			float Component{ static_cast<float>(Event.Value[i]) };
+			Ar << Component;
+			Event.Value[i] = Component;
+		}
+	}
+}
+
+bool UInputReplaySubsystem::SaveFile()
+{
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+	SerializeRecording(Writer);
+
+	return FFileHelper::SaveArrayToFile(Data, *FilePath);
+}
+
+bool UInputReplaySubsystem::LoadFile()
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath)) { return false; }
+
+	FMemoryReader Reader(Data);
+	SerializeRecording(Reader);
+	return !Reader.IsError();
+}
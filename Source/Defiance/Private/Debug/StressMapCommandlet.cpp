@@ -0,0 +1,231 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Debug/StressMapCommandlet.h"
+#include "Environment/GrapplePoint.h"
+#include "Environment/GrapplePointField.h"
+#include "Environment/ClimbGraphActor.h"
+#include "Environment/GrappleVisibilityActor.h"
+#include "Interfaces/Enemy.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerStart.h"
+#include "Math/RandomStream.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+
+const TCHAR* UStressMapCommandlet::DefaultGrapplePointClassPath{ TEXT("/Game/Evironment/Blueprints/BP_GrapplePoint.BP_GrapplePoint_C") };
+
+const TCHAR* UStressMapCommandlet::DefaultEnemyClassPath{ TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C") };
+
+UStressMapCommandlet::UStressMapCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+
+#if WITH_EDITOR
+namespace
+{
+	/** Nothing is placed this close to the player start, so the player never spawns inside geometry */
+	constexpr float ClearRadius{ 500.0f };
+
+	/** Edge length of the engine cube mesh */
+	constexpr float CubeSize{ 100.0f };
+
+	FVector RandomGroundLocation(FRandomStream& Random, float HalfExtent)
+	{
+		FVector Location;
+		do
+		{
+			Location = FVector(Random.FRandRange(-HalfExtent, HalfExtent), Random.FRandRange(-HalfExtent, HalfExtent), 0.0f);
+		} while (Location.SizeSquared2D() < FMath::Square(ClearRadius));
+
+		return Location;
+	}
+
+	AStaticMeshActor* SpawnBlock(UWorld* World, UStaticMesh* Mesh, const FVector& Location, const FRotator& Rotation, const FVector& Size, const TCHAR* Folder)
+	{
+		// The cube is centered on its origin; blocks stand on the floor
+		AStaticMeshActor* Block{ World->SpawnActor<AStaticMeshActor>(Location + FVector(0.0f, 0.0f, Size.Z * 0.5f), Rotation) };
+		Block->GetStaticMeshComponent()->SetMobility(EComponentMobility::Static);
+		Block->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+		Block->SetActorScale3D(Size / CubeSize);
+		Block->SetFolderPath(Folder);
+		return Block;
+	}
+}
+#endif
+
+int32 UStressMapCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	int32 Seed{ 1 };
+	float Density{ 10.0f };
+	float HalfExtent{ DefaultHalfExtent };
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+	FParse::Value(*Params, TEXT("Density="), Density);
+	FParse::Value(*Params, TEXT("Extent="), HalfExtent);
+	HalfExtent = FMath::Max(HalfExtent, ClearRadius * 2.0f);
+
+	int32 NumGrapplePoints{ FMath::RoundToInt32(BaseGrapplePoints * Density) };
+	int32 NumEnemies{ FMath::RoundToInt32(BaseEnemies * Density) };
+	int32 NumOccluders{ FMath::RoundToInt32(BaseOccluders * Density) };
+	int32 NumClimbables{ FMath::RoundToInt32(BaseClimbables * Density) };
+	FParse::Value(*Params, TEXT("GrapplePoints="), NumGrapplePoints);
+	FParse::Value(*Params, TEXT("Enemies="), NumEnemies);
+	FParse::Value(*Params, TEXT("Occluders="), NumOccluders);
+	FParse::Value(*Params, TEXT("Climbables="), NumClimbables);
+
+	FString PackageName{ FString::Printf(TEXT("/Game/Benchmarks/StressMap_%gx"), Density) };
+	FParse::Value(*Params, TEXT("Map="), PackageName);
+
+	FString GrapplePointClassPath{ DefaultGrapplePointClassPath };
+	FString EnemyClassPath{ DefaultEnemyClassPath };
+	FParse::Value(*Params, TEXT("GrappleClass="), GrapplePointClassPath);
+	FParse::Value(*Params, TEXT("EnemyClass="), EnemyClassPath);
+
+	// The Blueprint grapple point carries the collision on the Grapple channel; the native class still gets placed
+	// without it so the counts stay the same
+	UClass* GrapplePointClass{ LoadClass<AGrapplePoint>(nullptr, *GrapplePointClassPath) };
+	if (!GrapplePointClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UStressMapCommandlet [Main]: Could not load %s; placing AGrapplePoint."), *GrapplePointClassPath)
+		GrapplePointClass = AGrapplePoint::StaticClass();
+	}
+
+	UClass* EnemyClass{ LoadClass<APawn>(nullptr, *EnemyClassPath) };
+	if (!EnemyClass || !EnemyClass->ImplementsInterface(UEnemy::StaticClass()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UStressMapCommandlet [Main]: %s is not a pawn implementing IEnemy."), *EnemyClassPath)
+		return 1;
+	}
+
+	UStaticMesh* CubeMesh{ LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")) };
+	if (!CubeMesh || !FPackageName::IsValidLongPackageName(PackageName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UStressMapCommandlet [Main]: Invalid map name %s or missing engine cube mesh."), *PackageName)
+		return 1;
+	}
+
+	UPackage* Package{ CreatePackage(*PackageName) };
+	UWorld* World{ UWorld::CreateWorld(EWorldType::Editor, false, FName{ *FPackageName::GetShortName(PackageName) }, Package) };
+	World->SetFlags(RF_Public | RF_Standalone);
+
+	// Everything is drawn from one stream in a fixed order, so the seed alone decides the layout
+	FRandomStream Random{ Seed };
+
+	SpawnBlock(World, CubeMesh, FVector(0.0f, 0.0f, -CubeSize), FRotator::ZeroRotator, FVector(HalfExtent * 2.0f + 2000.0f, HalfExtent * 2.0f + 2000.0f, CubeSize), TEXT("StressMap"));
+	World->SpawnActor<APlayerStart>(FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator);
+
+	// Walls that block the visibility traces of lock on and grapple detection
+	for (int32 i = 0; i < NumOccluders; i++)
+	{
+		const FVector Size{ Random.FRandRange(200.0f, 1200.0f), Random.FRandRange(50.0f, 150.0f), Random.FRandRange(300.0f, 1200.0f) };
+		SpawnBlock(World, CubeMesh, RandomGroundLocation(Random, HalfExtent), FRotator(0.0f, Random.FRandRange(0.0f, 360.0f), 0.0f), Size, TEXT("StressMap/Occluders"));
+	}
+
+	// Blocks whose top edges are baked as ledges, and some thin bars to hang from
+	for (int32 i = 0; i < NumClimbables; i++)
+	{
+		const bool bHighBar{ Random.FRand() < 0.25f };
+		const FVector Size{ bHighBar ? FVector(Random.FRandRange(200.0f, 600.0f), 10.0f, 10.0f) : FVector(Random.FRandRange(300.0f, 800.0f), Random.FRandRange(300.0f, 800.0f), Random.FRandRange(200.0f, 600.0f)) };
+		FVector Location{ RandomGroundLocation(Random, HalfExtent) };
+		if (bHighBar) { Location.Z = Random.FRandRange(250.0f, 400.0f); }
+
+		AStaticMeshActor* Block{ SpawnBlock(World, CubeMesh, Location, FRotator(0.0f, Random.FRandRange(0.0f, 360.0f), 0.0f), Size, TEXT("StressMap/Climbables")) };
+		Block->Tags.Add(bHighBar ? FName{ TEXT("Climb.HighBar") } : FName{ TEXT("Climb.Ledge") });
+	}
+
+	// Grapple points hang above the ground with their landing spot a short way off. With -GrappleField they are all
+	// anchors of one field instead of separate actors, for comparing the two
+	AGrapplePointField* GrappleField{ nullptr };
+	if (FParse::Param(*Params, TEXT("GrappleField")))
+	{
+		GrappleField = World->SpawnActor<AGrapplePointField>(FVector::ZeroVector, FRotator::ZeroRotator);
+		GrappleField->SetFolderPath(TEXT("StressMap/GrapplePoints"));
+		GrappleField->FindComponentByClass<UInstancedStaticMeshComponent>()->SetStaticMesh(LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Sphere.Sphere")));
+	}
+
+	for (int32 i = 0; i < NumGrapplePoints; i++)
+	{
+		FVector Location{ RandomGroundLocation(Random, HalfExtent) };
+		Location.Z = Random.FRandRange(600.0f, 1500.0f);
+
+		const FVector LandingDirection{ FVector(1.0f, 0.0f, 0.0f).RotateAngleAxis(Random.FRandRange(0.0f, 360.0f), FVector::UpVector) };
+		const FVector LandingOffset{ LandingDirection * Random.FRandRange(150.0f, 400.0f) - FVector(0.0f, 0.0f, Location.Z - 100.0f) };
+		if (GrappleField)
+		{
+			GrappleField->AddAnchor(Location, LandingOffset, GrappleField->DefaultMinDistance);
+			continue;
+		}
+
+		AGrapplePoint* GrapplePoint{ World->SpawnActor<AGrapplePoint>(GrapplePointClass, Location, FRotator::ZeroRotator) };
+		GrapplePoint->LandingLocation = LandingOffset;
+		GrapplePoint->SetFolderPath(TEXT("StressMap/GrapplePoints"));
+	}
+
+	// Lock on targets, possessed by AI when the map starts
+	for (int32 i = 0; i < NumEnemies; i++)
+	{
+		const FVector Location{ RandomGroundLocation(Random, HalfExtent) + FVector(0.0f, 0.0f, 100.0f) };
+		APawn* Enemy{ World->SpawnActor<APawn>(EnemyClass, Location, FRotator(0.0f, Random.FRandRange(0.0f, 360.0f), 0.0f)) };
+		if (!Enemy) { continue; }
+
+		Enemy->AutoPossessPlayer = EAutoReceiveInput::Disabled;
+		Enemy->AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+		Enemy->SetFolderPath(TEXT("StressMap/Enemies"));
+	}
+
+	// Climb graphs and grapple visibility are baked per cell of the default bounds (from the floor up), like they would be
+	// placed by hand
+	const float CellSize{ 4000.0f };
+	const int32 NumCells{ FMath::CeilToInt32(HalfExtent * 2.0f / CellSize) };
+	int32 NumEdges{ 0 };
+	for (int32 Y = 0; Y < NumCells; Y++)
+	{
+		for (int32 X = 0; X < NumCells; X++)
+		{
+			const FVector CellCenter{ -HalfExtent + (X + 0.5f) * CellSize, -HalfExtent + (Y + 0.5f) * CellSize, 1000.0f };
+			AClimbGraphActor* ClimbGraph{ World->SpawnActor<AClimbGraphActor>(CellCenter, FRotator::ZeroRotator) };
+			ClimbGraph->SetFolderPath(TEXT("StressMap/ClimbGraphs"));
+			ClimbGraph->BakeClimbGraph();
+			NumEdges += ClimbGraph->Edges.Num();
+
+			AGrappleVisibilityActor* GrappleVisibility{ World->SpawnActor<AGrappleVisibilityActor>(CellCenter, FRotator::ZeroRotator) };
+			GrappleVisibility->SetFolderPath(TEXT("StressMap/GrappleVisibility"));
+			GrappleVisibility->BakeVisibility();
+		}
+	}
+
+	const FString FileName{ FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetMapPackageExtension()) };
+	FSavePackageArgs SaveArgs;
+	SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+	SaveArgs.SaveFlags = SAVE_NoError;
+	const bool bSaved{ UPackage::SavePackage(Package, World, *FileName, SaveArgs) };
+
+	World->DestroyWorld(false);
+
+	if (!bSaved)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UStressMapCommandlet [Main]: Could not save %s."), *FileName)
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("UStressMapCommandlet [Main]: Saved %s (Seed=%d Density=%g): %d grapple points, %d enemies, %d occluders, %d climbables, %d climb edges in %d graphs."),
+		*PackageName, Seed, Density, NumGrapplePoints, NumEnemies, NumOccluders, NumClimbables, NumEdges, NumCells * NumCells)
+	return 0;
+#else
+	UE_LOG(LogTemp, Error, TEXT("UStressMapCommandlet [Main]: Maps can only be generated by the editor."))
+	return 1;
+#endif
+}
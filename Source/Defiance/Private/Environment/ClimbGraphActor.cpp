@@ -0,0 +1,341 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Environment/ClimbGraphActor.h"
+#include "Environment/ClimbGraphSubsystem.h"
+#include "Components/BoxComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+
+// Sets default values
+AClimbGraphActor::AClimbGraphActor()
+{
+	// The graph is static data; it never needs to tick
+	PrimaryActorTick.bCanEverTick = false;
+
+	Bounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bounds"));
+	Bounds->SetBoxExtent(FVector(2000.0f, 2000.0f, 1000.0f));
+	Bounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bounds->SetMobility(EComponentMobility::Static);
+	RootComponent = Bounds;
+}
+
+// Called when the game starts or when spawned
+void AClimbGraphActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UClimbGraphSubsystem* ClimbGraphSubsystem{ GetWorld()->GetSubsystem<UClimbGraphSubsystem>() })
+	{
+		ClimbGraphSubsystem->RegisterGraph(this);
+	}
+}
+
+void AClimbGraphActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UClimbGraphSubsystem* ClimbGraphSubsystem{ GetWorld()->GetSubsystem<UClimbGraphSubsystem>() })
+	{
+		ClimbGraphSubsystem->UnregisterGraph(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+FBox AClimbGraphActor::GetGraphBounds() const
+{
+	return Bounds->Bounds.GetBox();
+}
+
+
+template<typename VisitorType>
+void AClimbGraphActor::ForEachEdgeInBox(const FVector& Min, const FVector& Max, VisitorType&& Visitor) const
+{
+	if (GridSize.X <= 0 || GridSize.Y <= 0) { return; }
+
+	const float CellSize{ GetBucketSize() };
+	const int32 MinX{ FMath::Clamp(FMath::FloorToInt32((Min.X - GridOrigin.X) / CellSize), 0, GridSize.X - 1) };
+	const int32 MinY{ FMath::Clamp(FMath::FloorToInt32((Min.Y - GridOrigin.Y) / CellSize), 0, GridSize.Y - 1) };
+	const int32 MaxX{ FMath::Clamp(FMath::FloorToInt32((Max.X - GridOrigin.X) / CellSize), 0, GridSize.X - 1) };
+	const int32 MaxY{ FMath::Clamp(FMath::FloorToInt32((Max.Y - GridOrigin.Y) / CellSize), 0, GridSize.Y - 1) };
+
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			const int32 Bucket{ Y * GridSize.X + X };
+			for (int32 i = BucketOffsets[Bucket]; i < BucketOffsets[Bucket + 1]; i++)
+			{
+				Visitor(BucketEdges[i]);
+			}
+		}
+	}
+}
+
+int32 AClimbGraphActor::FindNearestEdge(const FVector& Location, float Radius, float& OutAlpha, float& OutDistance) const
+{
+	int32 NearestEdge{ INDEX_NONE };
+	OutDistance = Radius;
+	OutAlpha = 0.0f;
+
+	ForEachEdgeInBox(Location - FVector(Radius), Location + FVector(Radius), [&](int32 EdgeIndex)
+	{
+		const FClimbEdge& Edge{ Edges[EdgeIndex] };
+		const FVector Start{ Edge.Start };
+		const FVector End{ Edge.End };
+		const FVector ClosestPoint{ FMath::ClosestPointOnSegment(Location, Start, End) };
+		const float Distance{ static_cast<float>(FVector::Distance(Location, ClosestPoint)) };
+
+		if (Distance < OutDistance)
+		{
+			const float Length{ Edge.GetLength() };
+			NearestEdge = EdgeIndex;
+			OutDistance = Distance;
+			OutAlpha = (Length > UE_KINDA_SMALL_NUMBER) ? static_cast<float>(FVector::Distance(Start, ClosestPoint)) / Length : 0.0f;
+		}
+	});
+
+	return NearestEdge;
+}
+
+int32 AClimbGraphActor::FindJumpTarget(const FVector& From, const FVector& Direction, float MaxDistance, int32 ExcludedEdge, float& OutAlpha, float& OutScore) const
+{
+	int32 BestEdge{ INDEX_NONE };
+	OutScore = TNumericLimits<float>::Max();
+	OutAlpha = 0.0f;
+
+	ForEachEdgeInBox(From - FVector(MaxDistance), From + FVector(MaxDistance), [&](int32 EdgeIndex)
+	{
+		if (EdgeIndex == ExcludedEdge) { return; }
+
+		const FClimbEdge& Edge{ Edges[EdgeIndex] };
+		const FVector Start{ Edge.Start };
+		const FVector End{ Edge.End };
+		const FVector ClosestPoint{ FMath::ClosestPointOnSegment(From, Start, End) };
+		const FVector ToEdge{ ClosestPoint - From };
+		const float Distance{ static_cast<float>(ToEdge.Size()) };
+
+		if (Distance > MaxDistance || Distance < UE_KINDA_SMALL_NUMBER) { return; }
+
+		// Only accept edges roughly in the requested direction; prefer close and well aligned ones
+		const float Alignment{ static_cast<float>(FVector::DotProduct(ToEdge / Distance, Direction)) };
+		if (Alignment < 0.5f) { return; }
+
+		const float Score{ Distance * (2.0f - Alignment) };
+		if (Score < OutScore)
+		{
+			const float Length{ Edge.GetLength() };
+			BestEdge = EdgeIndex;
+			OutScore = Score;
+			OutAlpha = (Length > UE_KINDA_SMALL_NUMBER) ? static_cast<float>(FVector::Distance(Start, ClosestPoint)) / Length : 0.0f;
+		}
+	});
+
+	return BestEdge;
+}
+
+
+
+#if WITH_EDITOR
+void AClimbGraphActor::BakeClimbGraph()
+{
+	UWorld* World{ GetWorld() };
+	if (!IsValid(World)) { return; }
+
+	Modify();
+	Edges.Reset();
+
+	const FBox GraphBounds{ GetGraphBounds() };
+	const UEnum* ClimbableTypeEnum{ StaticEnum<EClimbableType>() };
+
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		AActor* Actor{ *It };
+		if (Actor == this) { continue; }
+
+		TArray<UStaticMeshComponent*> MeshComponents;
+		Actor->GetComponents<UStaticMeshComponent>(MeshComponents);
+
+		for (UStaticMeshComponent* MeshComponent : MeshComponents)
+		{
+			if (MeshComponent->Mobility != EComponentMobility::Static) { continue; }
+			if (!MeshComponent->Bounds.GetBox().Intersect(GraphBounds)) { continue; }
+
+			// Geometry opts in with a "Climb.<Type>" tag on either the component or its actor
+			for (int32 i = 0; i < ClimbableTypeEnum->NumEnums() - 1; i++)
+			{
+				const FName Tag{ *FString::Printf(TEXT("Climb.%s"), *ClimbableTypeEnum->GetNameStringByIndex(i)) };
+				if (MeshComponent->ComponentHasTag(Tag) || Actor->ActorHasTag(Tag))
+				{
+					AddEdgesFromComponent(MeshComponent, static_cast<EClimbableType>(ClimbableTypeEnum->GetValueByIndex(i)));
+					break;
+				}
+			}
+		}
+	}
+
+	// Edges are referenced by 16 bit indices over the network
+	if (Edges.Num() >= MAX_uint16)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("AClimbGraphActor [BakeClimbGraph]: %s has too many edges; split it into smaller cells."), *GetName())
+		Edges.SetNum(MAX_uint16 - 1);
+	}
+
+	LinkEdges();
+	BuildGrid();
+
+	// The id comes from the actor's GUID, which survives renames and cell moves, so rebaking keeps the same id. Graphs
+	// that are loaded are checked for collisions; one in an unloaded cell is reported by the subsystem when both register.
+	TSet<uint16> UsedIds;
+	for (TActorIterator<AClimbGraphActor> It(World); It; ++It)
+	{
+		if (*It != this) { UsedIds.Add(It->GraphId); }
+	}
+
+	const uint16 PreferredId{ static_cast<uint16>(GetTypeHash(GetActorGuid()) & 0xFFFF) };
+	GraphId = PreferredId;
+	for (int32 Probe = 1; UsedIds.Contains(GraphId); Probe++)
+	{
+		if (Probe > MAX_uint16)
+		{
+			UE_LOG(LogTemp, Error, TEXT("AClimbGraphActor [BakeClimbGraph]: Every graph id is in use; %s keeps a duplicate id."), *GetName())
+			GraphId = PreferredId;
+			break;
+		}
+		GraphId = static_cast<uint16>(PreferredId + Probe);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("AClimbGraphActor [BakeClimbGraph]: Baked %d edges into %dx%d buckets for %s."), Edges.Num(), GridSize.X, GridSize.Y, *GetName())
+}
+
+void AClimbGraphActor::AddEdgesFromComponent(UStaticMeshComponent* MeshComponent, EClimbableType Type)
+{
+	const UStaticMesh* StaticMesh{ MeshComponent->GetStaticMesh() };
+	if (!IsValid(StaticMesh)) { return; }
+
+	const FTransform& Transform{ MeshComponent->GetComponentTransform() };
+	const FBox LocalBox{ StaticMesh->GetBoundingBox() };
+	const FVector LocalCenter{ LocalBox.GetCenter() };
+
+	// Bars and ropes are a single segment along the longest axis of the mesh
+	if (Type == EClimbableType::HighBar || Type == EClimbableType::Rope)
+	{
+		const FVector Extent{ LocalBox.GetExtent() * Transform.GetScale3D().GetAbs() };
+		const FVector LocalAxis{ (Extent.X >= Extent.Y && Extent.X >= Extent.Z) ? FVector::XAxisVector : (Extent.Y >= Extent.Z) ? FVector::YAxisVector : FVector::ZAxisVector };
+		const FVector LocalExtent{ LocalAxis * LocalBox.GetExtent() };
+
+		FClimbEdge Edge;
+		Edge.Type = Type;
+		Edge.Start = FVector3f(Transform.TransformPosition(LocalCenter - LocalExtent));
+		Edge.End = FVector3f(Transform.TransformPosition(LocalCenter + LocalExtent));
+		Edge.Normal = FVector3f(Transform.TransformVectorNoScale(FVector::CrossProduct(LocalAxis, FVector::UpVector).GetSafeNormal()));
+		Edges.Add(Edge);
+		return;
+	}
+
+	// Ledges only come from meshes whose top face is level
+	if (Transform.GetUnitAxis(EAxis::Z).Z < 0.9f) { return; }
+
+	const FVector TopCorners[4]{
+		FVector(LocalBox.Min.X, LocalBox.Min.Y, LocalBox.Max.Z),
+		FVector(LocalBox.Max.X, LocalBox.Min.Y, LocalBox.Max.Z),
+		FVector(LocalBox.Max.X, LocalBox.Max.Y, LocalBox.Max.Z),
+		FVector(LocalBox.Min.X, LocalBox.Max.Y, LocalBox.Max.Z)
+	};
+	const FVector TopCenter{ Transform.TransformPosition(FVector(LocalCenter.X, LocalCenter.Y, LocalBox.Max.Z)) };
+
+	UWorld* World{ GetWorld() };
+	const FCollisionShape Capsule{ FCollisionShape::MakeCapsule(AscentCapsule.X, AscentCapsule.Y) };
+
+	for (int32 i = 0; i < 4; i++)
+	{
+		FClimbEdge Edge;
+		Edge.Type = Type;
+		Edge.Start = FVector3f(Transform.TransformPosition(TopCorners[i]));
+		Edge.End = FVector3f(Transform.TransformPosition(TopCorners[(i + 1) % 4]));
+
+		const FVector Midpoint{ Edge.GetPoint(0.5f) };
+		Edge.Normal = FVector3f((Midpoint - TopCenter).GetSafeNormal2D());
+
+		// Check once here whether a character fits on top, so ascending never needs a runtime probe
+		const FVector StandLocation{ Midpoint - FVector(Edge.Normal) * (AscentCapsule.X + 10.0f) + FVector::UpVector * (AscentCapsule.Y + 2.0f) };
+		Edge.bCanAscend = (Type == EClimbableType::Ledge) && !World->OverlapBlockingTestByChannel(StandLocation, FQuat::Identity, ECC_Pawn, Capsule);
+
+		Edges.Add(Edge);
+	}
+}
+
+void AClimbGraphActor::LinkEdges()
+{
+	const float CornerCos{ FMath::Cos(FMath::DegreesToRadians(CornerAngle)) };
+
+	for (int32 i = 0; i < Edges.Num(); i++)
+	{
+		for (int32 j = 0; j < Edges.Num(); j++)
+		{
+			if (i == j || Edges[i].Type != Edges[j].Type) { continue; }
+			if (FVector3f::Distance(Edges[i].End, Edges[j].Start) > WeldTolerance) { continue; }
+
+			const FVector3f DirectionI{ (Edges[i].End - Edges[i].Start).GetSafeNormal() };
+			const FVector3f DirectionJ{ (Edges[j].End - Edges[j].Start).GetSafeNormal() };
+			const EClimbTransition Transition{ (FVector3f::DotProduct(DirectionI, DirectionJ) < CornerCos) ? EClimbTransition::Corner : EClimbTransition::None };
+
+			Edges[i].NextEdge = j;
+			Edges[i].NextTransition = Transition;
+			Edges[j].PrevEdge = i;
+			Edges[j].PrevTransition = Transition;
+		}
+	}
+}
+
+void AClimbGraphActor::BuildGrid()
+{
+	const FBox GraphBounds{ GetGraphBounds() };
+	const float CellSize{ GetBucketSize() };
+	GridOrigin = GraphBounds.Min;
+	GridSize = FIntPoint(
+		FMath::Max(1, FMath::CeilToInt32(GraphBounds.GetSize().X / CellSize)),
+		FMath::Max(1, FMath::CeilToInt32(GraphBounds.GetSize().Y / CellSize))
+	);
+
+	auto GetBucketRange = [this, CellSize](const FClimbEdge& Edge, FIntPoint& OutMin, FIntPoint& OutMax)
+	{
+		const FVector Min{ FVector::Min(FVector(Edge.Start), FVector(Edge.End)) - GridOrigin };
+		const FVector Max{ FVector::Max(FVector(Edge.Start), FVector(Edge.End)) - GridOrigin };
+		OutMin = FIntPoint(FMath::Clamp(FMath::FloorToInt32(Min.X / CellSize), 0, GridSize.X - 1), FMath::Clamp(FMath::FloorToInt32(Min.Y / CellSize), 0, GridSize.Y - 1));
+		OutMax = FIntPoint(FMath::Clamp(FMath::FloorToInt32(Max.X / CellSize), 0, GridSize.X - 1), FMath::Clamp(FMath::FloorToInt32(Max.Y / CellSize), 0, GridSize.Y - 1));
+	};
+
+	// Count the edges per bucket, turn the counts into offsets, then fill
+	BucketOffsets.Init(0, GridSize.X * GridSize.Y + 1);
+	for (const FClimbEdge& Edge : Edges)
+	{
+		FIntPoint Min, Max;
+		GetBucketRange(Edge, Min, Max);
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			for (int32 X = Min.X; X <= Max.X; X++) { BucketOffsets[Y * GridSize.X + X + 1]++; }
+		}
+	}
+
+	for (int32 i = 1; i < BucketOffsets.Num(); i++)
+	{
+		BucketOffsets[i] += BucketOffsets[i - 1];
+	}
+
+	BucketEdges.SetNumUninitialized(BucketOffsets.Last());
+	TArray<int32> FillCursor{ BucketOffsets };
+	for (int32 EdgeIndex = 0; EdgeIndex < Edges.Num(); EdgeIndex++)
+	{
+		FIntPoint Min, Max;
+		GetBucketRange(Edges[EdgeIndex], Min, Max);
+		for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+		{
+			for (int32 X = Min.X; X <= Max.X; X++) { BucketEdges[FillCursor[Y * GridSize.X + X]++] = EdgeIndex; }
+		}
+	}
+}
+#endif
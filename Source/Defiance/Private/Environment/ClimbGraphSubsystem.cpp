@@ -0,0 +1,121 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Environment/ClimbGraphSubsystem.h"
+#include "Environment/ClimbGraphActor.h"
+
+
+void UClimbGraphSubsystem::RegisterGraph(AClimbGraphActor* Graph)
+{
+	if (!IsValid(Graph)) { return; }
+
+	if (Graphs.Contains(Graph->GraphId))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UClimbGraphSubsystem [RegisterGraph]: %s uses the same graph id as another loaded graph. Rebake it."), *Graph->GetName())
+	}
+	Graphs.Add(Graph->GraphId, Graph);
+}
+
+void UClimbGraphSubsystem::UnregisterGraph(AClimbGraphActor* Graph)
+{
+	if (!IsValid(Graph)) { return; }
+
+	const TWeakObjectPtr<AClimbGraphActor>* Registered{ Graphs.Find(Graph->GraphId) };
+	if (Registered && Registered->Get() == Graph)
+	{
+		Graphs.Remove(Graph->GraphId);
+	}
+}
+
+
+
+const FClimbEdge* UClimbGraphSubsystem::GetEdge(FClimbEdgeHandle Handle) const
+{
+	if (!Handle.IsValid()) { return nullptr; }
+
+	const TWeakObjectPtr<AClimbGraphActor>* Graph{ Graphs.Find(Handle.GraphId) };
+	if (!Graph || !Graph->IsValid()) { return nullptr; }
+
+	const TArray<FClimbEdge>& Edges{ (*Graph)->Edges };
+	return Edges.IsValidIndex(Handle.EdgeIndex) ? &Edges[Handle.EdgeIndex] : nullptr;
+}
+
+FClimbEdgeHandle UClimbGraphSubsystem::FindNearestEdge(const FVector& Location, float Radius, float& OutAlpha) const
+{
+	FClimbEdgeHandle Result;
+	float BestDistance{ Radius };
+	const FBox QueryBox{ Location - FVector(Radius), Location + FVector(Radius) };
+
+	for (const TPair<uint16, TWeakObjectPtr<AClimbGraphActor>>& Graph : Graphs)
+	{
+		if (!Graph.Value.IsValid() || !Graph.Value->GetGraphBounds().Intersect(QueryBox)) { continue; }
+
+		float Alpha, Distance;
+		const int32 EdgeIndex{ Graph.Value->FindNearestEdge(Location, BestDistance, Alpha, Distance) };
+		if (EdgeIndex != INDEX_NONE)
+		{
+			Result.GraphId = Graph.Key;
+			Result.EdgeIndex = static_cast<uint16>(EdgeIndex);
+			BestDistance = Distance;
+			OutAlpha = Alpha;
+		}
+	}
+
+	return Result;
+}
+
+FClimbEdgeHandle UClimbGraphSubsystem::FindJumpTarget(const FVector& From, const FVector& Direction, float MaxDistance, FClimbEdgeHandle ExcludedEdge, float& OutAlpha) const
+{
+	FClimbEdgeHandle Result;
+	float BestScore{ TNumericLimits<float>::Max() };
+	const FBox QueryBox{ From - FVector(MaxDistance), From + FVector(MaxDistance) };
+
+	for (const TPair<uint16, TWeakObjectPtr<AClimbGraphActor>>& Graph : Graphs)
+	{
+		if (!Graph.Value.IsValid() || !Graph.Value->GetGraphBounds().Intersect(QueryBox)) { continue; }
+
+		const int32 Excluded{ (ExcludedEdge.IsValid() && ExcludedEdge.GraphId == Graph.Key) ? static_cast<int32>(ExcludedEdge.EdgeIndex) : INDEX_NONE };
+		float Alpha, Score;
+		const int32 EdgeIndex{ Graph.Value->FindJumpTarget(From, Direction, MaxDistance, Excluded, Alpha, Score) };
+		if (EdgeIndex != INDEX_NONE && Score < BestScore)
+		{
+			Result.GraphId = Graph.Key;
+			Result.EdgeIndex = static_cast<uint16>(EdgeIndex);
+			BestScore = Score;
+			OutAlpha = Alpha;
+		}
+	}
+
+	return Result;
+}
+
+FClimbEdgeHandle UClimbGraphSubsystem::GetNeighbour(FClimbEdgeHandle Handle, bool bForward, EClimbTransition& OutTransition) const
+{
+	FClimbEdgeHandle Result;
+	OutTransition = EClimbTransition::None;
+
+	const FClimbEdge* Edge{ GetEdge(Handle) };
+	if (!Edge) { return Result; }
+
+	const int32 Neighbour{ bForward ? Edge->NextEdge : Edge->PrevEdge };
+	if (Neighbour == INDEX_NONE) { return Result; }
+
+	Result.GraphId = Handle.GraphId;
+	Result.EdgeIndex = static_cast<uint16>(Neighbour);
+	OutTransition = bForward ? Edge->NextTransition : Edge->PrevTransition;
+	return Result;
+}
+
+EClimbStance UClimbGraphSubsystem::GetStanceForType(EClimbableType Type)
+{
+	switch (Type)
+	{
+	case EClimbableType::HighBar:
+	case EClimbableType::Rope:
+		return EClimbStance::Swinging;
+	case EClimbableType::Grab:
+		return EClimbStance::Narrow;
+	default:
+		return EClimbStance::Hanging;
+	}
+}
@@ -4,39 +4,26 @@
 #include "Environment/GrapplePoint.h"
 #include "GameFramework/Character.h"
 #include "Characters/GrapplingHookComponent.h"
+#include "Environment/GrappleReachability.h"
+#include "BasicSupportLibrary.h"
 
 
 // Sets default values
 AGrapplePoint::AGrapplePoint()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
+	// The indicator layer draws the grapple point, so nothing here changes per frame
+	PrimaryActorTick.bCanEverTick = false;
 
 }
 
 // Called when the game starts or when spawned
 void AGrapplePoint::BeginPlay()
 {
-	Super::BeginPlay();
-	
-	//PlayerPawnRef = GetWorld()->GetFirstPlayerController()->GetPawn();
-	
-	
-}
-
-// Called every frame
-void AGrapplePoint::Tick(float DeltaTime)
-{
-	Super::Tick(DeltaTime);
-
-	if (bIsActive) { UpdateDistanceToPlayer(); }
-}
+	// Before the components begin play, so the old per-point widget is never created
+	UBasicSupportLibrary::DisableWidgetComponents(this);
 
-void AGrapplePoint::UpdateDistanceToPlayer()
-{
-	FVector PlayerLocation{ PlayerPawnRef->GetActorLocation() };
-	FVector CurrentLocation{ GetActorLocation() };
-	DistanceToPlayer = static_cast<float>(FVector::Distance(CurrentLocation, PlayerLocation));
+	Super::BeginPlay();
 }
 
 void AGrapplePoint::ActivateGrapplePoint(APawn* PlayerPawn, float InteractRange, float DetectionRange)
@@ -57,8 +44,32 @@ void AGrapplePoint::DeactivateGrapplePoint()
 	bIsActive = false;
 }
 
+void AGrapplePoint::OnActivate_Implementation(const APawn* PlayerPawn, float InteractRange, float DetectionRange)
+{
+	ActivateGrapplePoint(const_cast<APawn*>(PlayerPawn), InteractRange, DetectionRange);
+}
+
+void AGrapplePoint::OnDeactivate_Implementation()
+{
+	DeactivateGrapplePoint();
+}
+
 FVector AGrapplePoint::GetLandingLocation()
 {
 	return  GetActorLocation() + LandingLocation;
 }
 
+bool AGrapplePoint::IsReachableFrom(const FVector& Location, int32 Index) const
+{
+	if (ReachabilityRange <= 0.0f) { return true; }
+
+	return (ReachabilityMask & FGrappleReachability::GetSampleMask(GetActorLocation(), Location, MinDistanceToPlayer, ReachabilityRange)) != 0;
+}
+
+#if WITH_EDITOR
+void AGrapplePoint::BakeReachability()
+{
+	AActor* Self{ this };
+	FGrappleReachability::Bake(GetWorld(), MakeArrayView(&Self, 1));
+}
+#endif
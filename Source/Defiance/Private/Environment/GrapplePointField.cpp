@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Environment/GrapplePointField.h"
+#include "Environment/GrappleReachability.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "UI/TargetIndicatorSubsystem.h"
+
+
+// Sets default values
+AGrapplePointField::AGrapplePointField()
+{
+	// Anchors are static; nothing to update per frame
+	PrimaryActorTick.bCanEverTick = false;
+
+	Anchors = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Anchors"));
+	Anchors->SetMobility(EComponentMobility::Static);
+	Anchors->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	Anchors->SetCollisionResponseToAllChannels(ECR_Ignore);
+	Anchors->SetCollisionResponseToChannel(ECC_GameTraceChannel2, ECR_Overlap);
+	Anchors->SetCollisionResponseToChannel(ECC_Visibility, ECR_Block);
+	Anchors->SetCanEverAffectNavigation(false);
+	Anchors->NumCustomDataFloats = 1;
+	RootComponent = Anchors;
+}
+
+void AGrapplePointField::OnConstruction(const FTransform& Transform)
+{
+	Super::OnConstruction(Transform);
+
+	const int32 NumAnchors{ GetNumAnchors() };
+	while (LandingOffsets.Num() < NumAnchors) { LandingOffsets.Add(FVector3f(DefaultLandingOffset)); }
+	while (MinDistances.Num() < NumAnchors) { MinDistances.Add(DefaultMinDistance); }
+	LandingOffsets.SetNum(NumAnchors);
+	MinDistances.SetNum(NumAnchors);
+
+	// Masks baked for another set of anchors mean nothing
+	if (ReachabilityMasks.Num() != NumAnchors)
+	{
+		ReachabilityMasks.Reset();
+		ReachabilityRange = 0.0f;
+	}
+}
+
+void AGrapplePointField::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+	if (!InstanceIndexUpdatedHandle.IsValid())
+	{
+		InstanceIndexUpdatedHandle = FInstancedStaticMeshDelegates::OnInstanceIndexUpdated.AddUObject(this, &AGrapplePointField::HandleInstanceIndexUpdated);
+	}
+}
+
+void AGrapplePointField::PostUnregisterAllComponents()
+{
+	FInstancedStaticMeshDelegates::OnInstanceIndexUpdated.Remove(InstanceIndexUpdatedHandle);
+	InstanceIndexUpdatedHandle.Reset();
+
+	Super::PostUnregisterAllComponents();
+}
+
+void AGrapplePointField::HandleInstanceIndexUpdated(UInstancedStaticMeshComponent* Component, TArrayView<const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData> IndexUpdates)
+{
+	if (Component != Anchors) { return; }
+
+	using EUpdateType = FInstancedStaticMeshDelegates::EInstanceIndexUpdateType;
+	using FUpdateData = FInstancedStaticMeshDelegates::FInstanceIndexUpdateData;
+
+	const bool bMovesData{ IndexUpdates.ContainsByPredicate([](const FUpdateData& Update) { return Update.Type == EUpdateType::Removed || Update.Type == EUpdateType::Cleared; }) };
+	if (!bMovesData) { return; }
+
+	Modify();
+
+	// Removals come with the relocation of every instance they moved, in the order to apply them
+	const bool bHasMasks{ ReachabilityMasks.Num() == LandingOffsets.Num() };
+	int32 NumRemoved{ 0 };
+	for (const FUpdateData& Update : IndexUpdates)
+	{
+		switch (Update.Type)
+		{
+		case EUpdateType::Removed:
+			NumRemoved++;
+			if (ActiveAnchor == Update.Index) { ActiveAnchor = INDEX_NONE; }
+			break;
+
+		case EUpdateType::Relocated:
+			if (ActiveAnchor == Update.OldIndex) { ActiveAnchor = Update.Index; }
+			if (!LandingOffsets.IsValidIndex(Update.OldIndex) || !LandingOffsets.IsValidIndex(Update.Index) || !MinDistances.IsValidIndex(Update.OldIndex)) { break; }
+
+			LandingOffsets[Update.Index] = LandingOffsets[Update.OldIndex];
+			MinDistances[Update.Index] = MinDistances[Update.OldIndex];
+			if (bHasMasks) { ReachabilityMasks[Update.Index] = ReachabilityMasks[Update.OldIndex]; }
+			break;
+
+		case EUpdateType::Cleared:
+			LandingOffsets.Reset();
+			MinDistances.Reset();
+			ReachabilityMasks.Reset();
+			ReachabilityRange = 0.0f;
+			ActiveAnchor = INDEX_NONE;
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	LandingOffsets.SetNum(FMath::Max(LandingOffsets.Num() - NumRemoved, 0));
+	MinDistances.SetNum(FMath::Max(MinDistances.Num() - NumRemoved, 0));
+	if (bHasMasks) { ReachabilityMasks.SetNum(LandingOffsets.Num()); }
+}
+
+int32 AGrapplePointField::AddAnchor(const FVector& Location, const FVector& LandingOffset, float MinDistance)
+{
+	const int32 Index{ Anchors->AddInstance(FTransform(Location), true) };
+	LandingOffsets.SetNum(Index + 1);
+	MinDistances.SetNum(Index + 1);
+	LandingOffsets[Index] = FVector3f(LandingOffset);
+	MinDistances[Index] = MinDistance;
+	return Index;
+}
+
+int32 AGrapplePointField::GetNumAnchors() const
+{
+	return Anchors->GetInstanceCount();
+}
+
+
+
+FVector AGrapplePointField::GetLandingLocation()
+{
+	return GetAnchorLandingLocation(ActiveAnchor);
+}
+
+int32 AGrapplePointField::GetAnchorIndex(const FHitResult& Hit) const
+{
+	return Hit.GetComponent() == Anchors ? Hit.Item : INDEX_NONE;
+}
+
+FVector AGrapplePointField::GetAnchorLocation(int32 Index) const
+{
+	FTransform InstanceTransform;
+	if (!Anchors->GetInstanceTransform(Index, InstanceTransform, true)) { return GetActorLocation(); }
+
+	return InstanceTransform.GetLocation();
+}
+
+FVector AGrapplePointField::GetAnchorLandingLocation(int32 Index)
+{
+	if (!LandingOffsets.IsValidIndex(Index)) { return GetAnchorLocation(Index); }
+
+	return GetAnchorLocation(Index) + FVector(LandingOffsets[Index]);
+}
+
+bool AGrapplePointField::IsReachableFrom(const FVector& Location, int32 Index) const
+{
+	if (ReachabilityRange <= 0.0f || !ReachabilityMasks.IsValidIndex(Index) || !MinDistances.IsValidIndex(Index)) { return true; }
+
+	return (ReachabilityMasks[Index] & FGrappleReachability::GetSampleMask(GetAnchorLocation(Index), Location, MinDistances[Index], ReachabilityRange)) != 0;
+}
+
+void AGrapplePointField::OnActivateAnchor(int32 Index, const APawn* PlayerPawnRef, float InteractRange, float DetectionRange)
+{
+	SetAnchorHighlighted(ActiveAnchor, false);
+	ActiveAnchor = Index;
+	SetAnchorHighlighted(ActiveAnchor, true);
+
+	if (UTargetIndicatorSubsystem* Indicators{ UTargetIndicatorSubsystem::Get(this) }) { Indicators->SetActiveGrapple(this, InteractRange, DetectionRange, Index); }
+}
+
+void AGrapplePointField::OnDeactivateAnchor(int32 Index)
+{
+	if (UTargetIndicatorSubsystem* Indicators{ UTargetIndicatorSubsystem::Get(this) }) { Indicators->ClearActiveGrapple(this, Index); }
+
+	if (ActiveAnchor != Index) { return; }
+
+	SetAnchorHighlighted(ActiveAnchor, false);
+	ActiveAnchor = INDEX_NONE;
+}
+
+void AGrapplePointField::SetAnchorHighlighted(int32 Index, bool bHighlighted)
+{
+	if (Index == INDEX_NONE || Index >= GetNumAnchors()) { return; }
+
+	Anchors->SetCustomDataValue(Index, 0, bHighlighted ? 1.0f : 0.0f, true);
+}
+
+#if WITH_EDITOR
+void AGrapplePointField::BakeReachability()
+{
+	AActor* Self{ this };
+	FGrappleReachability::Bake(GetWorld(), MakeArrayView(&Self, 1));
+}
+#endif
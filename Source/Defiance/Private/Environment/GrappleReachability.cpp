@@ -0,0 +1,249 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Environment/GrappleReachability.h"
+#include "Environment/GrapplePoint.h"
+#include "Environment/GrapplePointField.h"
+#include "Characters/GrapplingHookComponent.h"
+#include "../../DefianceGameMode.h"
+#include "../../DefianceCharacter.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Components/CapsuleComponent.h"
+#include "Async/ParallelFor.h"
+#if WITH_EDITOR
+#include "GameMapsSettings.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/SimpleConstructionScript.h"
+#include "Engine/SCS_Node.h"
+#include "Engine/InheritableComponentHandler.h"
+#endif
+
+
+uint32 FGrappleReachability::GetSampleMask(const FVector& GrappleLocation, const FVector& Location, float MinDistance, float Range)
+{
+	const FVector2D Offset{ FVector2D(Location - GrappleLocation) };
+	const float Yaw{ FMath::RadiansToDegrees(FMath::Atan2(static_cast<float>(Offset.Y), static_cast<float>(Offset.X))) };
+	const int32 Sector{ FMath::FloorToInt32(FRotator::ClampAxis(Yaw) / (360.0f / NumSectors)) % NumSectors };
+
+	const float Distance{ static_cast<float>(Offset.Size()) };
+	if (Distance > Range)
+	{
+		uint32 SectorMask{ 0 };
+		for (int32 Ring = 0; Ring < NumRings; Ring++) { SectorMask |= 1u << (Ring * NumSectors + Sector); }
+		return SectorMask;
+	}
+
+	const float RingWidth{ FMath::Max(Range - MinDistance, 1.0f) / NumRings };
+	const int32 Ring{ FMath::Clamp(FMath::FloorToInt32((Distance - MinDistance) / RingWidth), 0, NumRings - 1) };
+	return 1u << (Ring * NumSectors + Sector);
+}
+
+
+
+#if WITH_EDITOR
+namespace
+{
+	/** Straight segments each arc is swept in */
+	constexpr int32 ArcSegments{ 16 };
+
+	/** The end of the arc touches the landing surface, so the sweep stops just short of it */
+	constexpr float LandingTimeFraction{ 0.95f };
+
+	/** How far below an approach position the ground is searched for */
+	constexpr float GroundSearchDepth{ 3000.0f };
+
+	/** Returns the player pawn class of the world's game mode, or of the project's default game mode */
+	UClass* FindPlayerPawnClass(const UWorld* World)
+	{
+		const AWorldSettings* WorldSettings{ World->GetWorldSettings() };
+		UClass* GameModeClass{ WorldSettings ? WorldSettings.DefaultGameMode.Get() : nullptr };
+		if (!GameModeClass) { GameModeClass = LoadClass<AGameModeBase>(nullptr, *UGameMapsSettings::GetGlobalDefaultGameMode()); }
+		if (!GameModeClass) { return nullptr; }
+
+		// Defiance game modes only reference the pawn softly
+		const ADefianceGameMode* DefianceGameMode{ Cast<ADefianceGameMode>(GameModeClass->GetDefaultObject()) };
+		if (DefianceGameMode && !DefianceGameMode->SoftDefaultPawnClass.IsNull()) { return DefianceGameMode->SoftDefaultPawnClass.LoadSynchronous(); }
+
+		return GameModeClass->GetDefaultObject<AGameModeBase>()->DefaultPawnClass;
+	}
+
+	/** Returns the grappling hook of the pawn class as it is configured, including components only its Blueprint adds */
+	const UGrapplingHookComponent* FindGrapplingHookTemplate(UClass* PawnClass)
+	{
+		if (const UGrapplingHookComponent* NativeComponent{ PawnClass->GetDefaultObject<AActor>()->FindComponentByClass<UGrapplingHookComponent>() }) { return NativeComponent; }
+
+		UBlueprintGeneratedClass* MostDerivedClass{ Cast<UBlueprintGeneratedClass>(PawnClass) };
+		for (UBlueprintGeneratedClass* BlueprintClass = MostDerivedClass; BlueprintClass; BlueprintClass = Cast<UBlueprintGeneratedClass>(BlueprintClass->GetSuperClass()))
+		{
+			if (!BlueprintClass->SimpleConstructionScript) { continue; }
+
+			for (USCS_Node* Node : BlueprintClass->SimpleConstructionScript->GetAllNodes())
+			{
+				UGrapplingHookComponent* Template{ Cast<UGrapplingHookComponent>(Node->ComponentTemplate) };
+				if (!Template) { continue; }
+
+				// Child Blueprints keep their changes to an inherited component apart from the parent's template
+				const FComponentKey Key{ Node };
+				for (UBlueprintGeneratedClass* ChildClass = MostDerivedClass; ChildClass != BlueprintClass; ChildClass = Cast<UBlueprintGeneratedClass>(ChildClass->GetSuperClass()))
+				{
+					UInheritableComponentHandler* Overrides{ ChildClass->GetInheritableComponentHandler() };
+					if (UGrapplingHookComponent* Override{ Overrides ? Cast<UGrapplingHookComponent>(Overrides->GetOverridenComponentTemplate(Key)) : nullptr }) { return Override; }
+				}
+				return Template;
+			}
+		}
+
+		return nullptr;
+	}
+}
+
+FGrappleReachability::FBakeSettings FGrappleReachability::GetPlayerBakeSettings(const UWorld* World)
+{
+	UClass* PawnClass{ IsValid(World) ? FindPlayerPawnClass(World) : nullptr };
+	if (!PawnClass || !PawnClass->IsChildOf<ACharacter>())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FGrappleReachability [GetPlayerBakeSettings]: No character pawn class found; baking with the ADefianceCharacter defaults."))
+		PawnClass = ADefianceCharacter::StaticClass();
+	}
+
+	const UGrapplingHookComponent* GrapplingHook{ FindGrapplingHookTemplate(PawnClass) };
+	if (!GrapplingHook) { GrapplingHook = GetDefault<UGrapplingHookComponent>(); }
+
+	const UCapsuleComponent* Capsule{ PawnClass->GetDefaultObject<ACharacter>()->GetCapsuleComponent() };
+
+	FBakeSettings Settings;
+	Settings.CapsuleRadius = Capsule->GetScaledCapsuleRadius();
+	Settings.CapsuleHalfHeight = Capsule->GetScaledCapsuleHalfHeight();
+	Settings.InteractRange = GrapplingHook->InteractRange;
+	Settings.DetectionRadius = GrapplingHook->DetectionRadius;
+	Settings.ArcParam = GrapplingHook->ArcParam;
+	Settings.LaunchModifier = GrapplingHook->LaunchModifier;
+	return Settings;
+}
+
+void FGrappleReachability::Bake(UWorld* World, TArrayView<AActor* const> Grapples, const FBakeSettings& Settings)
+{
+	if (!IsValid(World)) { return; }
+
+	// Single points and field anchors are flattened into one list so they share the parallel pass
+	struct FAnchor
+	{
+		AActor* Owner;
+		FVector Location;
+		FVector LandingLocation;
+		float MinDistance;
+	};
+
+	TArray<FAnchor> Anchors;
+	for (AActor* Grapple : Grapples)
+	{
+		if (AGrapplePoint* GrapplePoint{ Cast<AGrapplePoint>(Grapple) })
+		{
+			Anchors.Add(FAnchor{ GrapplePoint, GrapplePoint->GetActorLocation(), GrapplePoint->GetLandingLocation(), GrapplePoint->MinDistanceToPlayer });
+		}
+		else if (AGrapplePointField* Field{ Cast<AGrapplePointField>(Grapple) })
+		{
+			for (int32 Index = 0; Index < Field->GetNumAnchors(); Index++)
+			{
+				Anchors.Add(FAnchor{ Field, Field->GetAnchorLocation(Index), Field->GetAnchorLandingLocation(Index), Field->MinDistances.IsValidIndex(Index) ? Field->MinDistances[Index] : Field->DefaultMinDistance });
+			}
+		}
+	}
+
+	static_assert(NumSectors * NumRings <= 32, "ReachabilityMask holds 32 samples");
+	const int32 NumSamples{ Anchors.Num() * NumSectors * NumRings };
+	const float GravityZ{ World->GetGravityZ() };
+	const FCollisionShape Capsule{ FCollisionShape::MakeCapsule(Settings.CapsuleRadius, Settings.CapsuleHalfHeight) };
+
+	TArray<bool> Reachable;
+	Reachable.SetNumZeroed(NumSamples);
+
+	// Every sample only reads the physics scene, so they are all traced in parallel
+	ParallelFor(NumSamples, [&](int32 i)
+	{
+		const FAnchor& Anchor{ Anchors[i / (NumSectors * NumRings)] };
+
+		const int32 Bit{ i % (NumSectors * NumRings) };
+		const int32 Sector{ Bit % NumSectors };
+		const int32 Ring{ Bit / NumSectors };
+
+		const FVector& LandingLocation{ Anchor.LandingLocation };
+		const float RingWidth{ FMath::Max(Settings.InteractRange - Anchor.MinDistance, 1.0f) / NumRings };
+		const float Distance{ Anchor.MinDistance + (Ring + 0.5f) * RingWidth };
+		const FVector Direction{ FVector::ForwardVector.RotateAngleAxis((Sector + 0.5f) * 360.0f / NumSectors, FVector::UpVector) };
+
+		FCollisionQueryParams Params{ FName{ TEXT("GrappleReachability") }, false, Anchor.Owner };
+
+		// The player stands on whatever is below the sample
+		const FVector SampleLocation{ Anchor.Location + Direction * Distance };
+		FHitResult GroundHit;
+		if (!World->LineTraceSingleByChannel(GroundHit, SampleLocation, SampleLocation - FVector(0.0f, 0.0f, GroundSearchDepth), ECC_Pawn, Params)) { return; }
+
+		const FVector Start{ GroundHit.ImpactPoint + FVector(0.0f, 0.0f, Settings.CapsuleHalfHeight + 2.0f) };
+		if (World->OverlapBlockingTestByChannel(Start, FQuat::Identity, ECC_Pawn, Capsule, Params)) { return; }
+
+		FVector LaunchVelocity;
+		if (!UGameplayStatics::SuggestProjectileVelocity_CustomArc(World, LaunchVelocity, Start, LandingLocation, GravityZ, Settings.ArcParam)) { return; }
+		LaunchVelocity *= Settings.LaunchModifier;
+
+		// The modified launch no longer ends exactly on the landing location; the flight lasts until it comes back
+		// down to its height
+		const float A{ 0.5f * GravityZ };
+		const float B{ static_cast<float>(LaunchVelocity.Z) };
+		const float C{ static_cast<float>(Start.Z - LandingLocation.Z) };
+		const float Discriminant{ B * B - 4.0f * A * C };
+		if (Discriminant < 0.0f || FMath::IsNearlyZero(A)) { return; }
+
+		const float FlightTime{ (-B - FMath::Sqrt(Discriminant)) / (2.0f * A) };
+		if (FlightTime <= 0.0f) { return; }
+
+		FVector Previous{ Start };
+		for (int32 Segment = 1; Segment <= ArcSegments; Segment++)
+		{
+			const float Time{ FlightTime * LandingTimeFraction * Segment / ArcSegments };
+			const FVector Next{ Start + LaunchVelocity * Time + FVector(0.0f, 0.0f, A * Time * Time) };
+			if (World->SweepTestByChannel(Previous, Next, FQuat::Identity, ECC_Pawn, Capsule, Params)) { return; }
+			Previous = Next;
+		}
+
+		Reachable[i] = true;
+	});
+
+	// Masks are written back per owner; a field gets one per anchor, in order
+	TMap<AGrapplePointField*, int32> FieldAnchors;
+	for (int32 AnchorIndex = 0; AnchorIndex < Anchors.Num(); AnchorIndex++)
+	{
+		uint32 Mask{ 0 };
+		for (int32 Bit = 0; Bit < NumSectors * NumRings; Bit++)
+		{
+			if (Reachable[AnchorIndex * NumSectors * NumRings + Bit]) { Mask |= 1u << Bit; }
+		}
+
+		AActor* Owner{ Anchors[AnchorIndex].Owner };
+		if (AGrapplePointField* Field{ Cast<AGrapplePointField>(Owner) })
+		{
+			int32& NumWritten{ FieldAnchors.FindOrAdd(Field) };
+			if (NumWritten == 0)
+			{
+				Field->Modify();
+				Field->ReachabilityMasks.SetNumZeroed(Field->GetNumAnchors());
+				Field->ReachabilityRange = Settings.InteractRange;
+			}
+			Field->ReachabilityMasks[NumWritten++] = Mask;
+		}
+		else if (AGrapplePoint* GrapplePoint{ Cast<AGrapplePoint>(Owner) })
+		{
+			GrapplePoint->Modify();
+			GrapplePoint->ReachabilityMask = Mask;
+			GrapplePoint->ReachabilityRange = Settings.InteractRange;
+		}
+
+		if (Mask == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FGrappleReachability [Bake]: %s cannot be reached from any direction at %s."), *Owner->GetName(), *Anchors[AnchorIndex].Location.ToString())
+		}
+	}
+}
+#endif
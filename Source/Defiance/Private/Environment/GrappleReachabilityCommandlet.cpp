@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Environment/GrappleReachabilityCommandlet.h"
+#include "Environment/GrappleReachability.h"
+#include "Environment/GrapplePoint.h"
+#include "Environment/GrapplePointField.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#if WITH_EDITOR
+#include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/WorldPartitionEditorLoaderAdapter.h"
+#include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
+#endif
+
+
+UGrappleReachabilityCommandlet::UGrappleReachabilityCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+}
+
+int32 UGrappleReachabilityCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogTemp, Error, TEXT("UGrappleReachabilityCommandlet [Main]: Missing -Map=."))
+		return 1;
+	}
+
+	UPackage* MapPackage{ LoadPackage(nullptr, *MapName, LOAD_None) };
+	UWorld* World{ MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr };
+	if (!World)
+	{
+		UE_LOG(LogTemp, Error, TEXT("UGrappleReachabilityCommandlet [Main]: Could not load the map %s."), *MapName)
+		return 1;
+	}
+
+	// The sweeps need the collision of the level, but nothing has to simulate
+	World->AddToRoot();
+	World->WorldType = EWorldType::Editor;
+	FWorldContext& WorldContext{ GEngine->CreateNewWorldContext(EWorldType::Editor) };
+	WorldContext.SetCurrentWorld(World);
+	if (!World->bIsWorldInitialized)
+	{
+		World->InitWorld(UWorld::InitializationValues()
+			.ShouldSimulatePhysics(false)
+			.EnableTraceCollision(true)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.AllowAudioPlayback(false));
+	}
+	World->UpdateWorldComponents(true, false);
+
+	if (UWorldPartition* WorldPartition{ World->GetWorldPartition() })
+	{
+		UWorldPartitionEditorLoaderAdapter* LoaderAdapter{ WorldPartition->CreateEditorLoaderAdapter<FLoaderAdapterShape>(World, FBox(FVector(-HALF_WORLD_MAX), FVector(HALF_WORLD_MAX)), TEXT("GrappleReachability")) };
+		LoaderAdapter->GetLoaderAdapter()->Load();
+	}
+
+	TArray<AActor*> GrapplePoints;
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		if (It->IsA<AGrapplePoint>() || It->IsA<AGrapplePointField>()) { GrapplePoints.Add(*It); }
+	}
+
+	const double StartTime{ FPlatformTime::Seconds() };
+	FGrappleReachability::Bake(World, GrapplePoints);
+	const double BakeTime{ FPlatformTime::Seconds() - StartTime };
+
+	// With external actors each grapple point lives in its own package, otherwise they are all in the map
+	TSet<UPackage*> Packages;
+	for (AActor* GrapplePoint : GrapplePoints) { Packages.Add(GrapplePoint->GetPackage()); }
+
+	int32 NumFailed{ 0 };
+	for (UPackage* Package : Packages)
+	{
+		UWorld* PackageWorld{ UWorld::FindWorldInPackage(Package) };
+		const FString FileName{ FPackageName::LongPackageNameToFilename(Package->GetName(), PackageWorld ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension()) };
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+		if (!UPackage::SavePackage(Package, PackageWorld, *FileName, SaveArgs))
+		{
+			UE_LOG(LogTemp, Error, TEXT("UGrappleReachabilityCommandlet [Main]: Could not save %s; is it checked out?"), *FileName)
+			NumFailed++;
+		}
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("UGrappleReachabilityCommandlet [Main]: Baked %d grapple points and fields in %.2fs, saved %d packages."),
+		GrapplePoints.Num(), BakeTime, Packages.Num() - NumFailed)
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	return NumFailed == 0 ? 0 : 1;
+#else
+	UE_LOG(LogTemp, Error, TEXT("UGrappleReachabilityCommandlet [Main]: Reachability can only be baked by the editor."))
+	return 1;
+#endif
+}
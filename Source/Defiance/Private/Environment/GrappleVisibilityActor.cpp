@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Environment/GrappleVisibilityActor.h"
+#include "MemoryTags.h"
+#include "Environment/GrappleVisibilitySubsystem.h"
+#include "Environment/GrapplePointField.h"
+#include "Environment/GrappleReachability.h"
+#include "Interfaces/Grapple.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+
+// Sets default values
+AGrappleVisibilityActor::AGrappleVisibilityActor()
+{
+	// The set is static data; it never needs to tick
+	PrimaryActorTick.bCanEverTick = false;
+
+	Bounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bounds"));
+	Bounds->SetBoxExtent(FVector(2000.0f, 2000.0f, 1000.0f));
+	Bounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bounds->SetMobility(EComponentMobility::Static);
+	RootComponent = Bounds;
+}
+
+// Called when the game starts or when spawned
+void AGrappleVisibilityActor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ResolvePoints();
+
+	if (UGrappleVisibilitySubsystem* VisibilitySubsystem{ GetWorld()->GetSubsystem<UGrappleVisibilitySubsystem>() })
+	{
+		VisibilitySubsystem->RegisterVisibilitySet(this);
+	}
+}
+
+void AGrappleVisibilityActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UGrappleVisibilitySubsystem* VisibilitySubsystem{ GetWorld()->GetSubsystem<UGrappleVisibilitySubsystem>() })
+	{
+		VisibilitySubsystem->UnregisterVisibilitySet(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+
+FBox AGrappleVisibilityActor::GetVisibilityBounds() const
+{
+	return Bounds->Bounds.GetBox();
+}
+
+void AGrappleVisibilityActor::ResolvePoints()
+{
+	LLM_SCOPE_BYTAG(Defiance_Grapple);
+
+	// Points that streamed out keep their old keys, which no loaded actor can match
+	PointIndices.Reset();
+
+	for (int32 i = 0; i < GrapplePoints.Num(); i++)
+	{
+		if (AActor* GrapplePoint{ GrapplePoints[i].Get() }) { PointIndices.Add(GrapplePoint, i); }
+	}
+}
+
+EGrappleVisibility AGrappleVisibilityActor::GetVisibility(const FVector& Location, const AActor* GrapplePoint) const
+{
+	if (WordsPerCell == 0 || !GetVisibilityBounds().IsInsideOrOn(Location)) { return EGrappleVisibility::Unknown; }
+
+	const int32* PointIndex{ PointIndices.Find(GrapplePoint) };
+	if (!PointIndex) { return EGrappleVisibility::Unknown; }
+
+	const FVector LocalLocation{ (Location - GridOrigin) / CellSize };
+	const int32 X{ FMath::Clamp(FMath::FloorToInt32(LocalLocation.X), 0, GridSize.X - 1) };
+	const int32 Y{ FMath::Clamp(FMath::FloorToInt32(LocalLocation.Y), 0, GridSize.Y - 1) };
+	const int32 Z{ FMath::Clamp(FMath::FloorToInt32(LocalLocation.Z), 0, GridSize.Z - 1) };
+	const int32 Cell{ (Z * GridSize.Y + Y) * GridSize.X + X };
+
+	const uint32 Word{ CellBits[Cell * WordsPerCell + *PointIndex / 32] };
+	return (Word & (1u << (*PointIndex % 32))) ? EGrappleVisibility::PotentiallyVisible : EGrappleVisibility::Hidden;
+}
+
+
+
+#if WITH_EDITOR
+void AGrappleVisibilityActor::BakeVisibility()
+{
+	UWorld* World{ GetWorld() };
+	if (!IsValid(World)) { return; }
+
+	Modify();
+
+	// Points further than the player's detection radius from the cell are never candidates, so they are left out of the set
+	const float Range{ FGrappleReachability::GetPlayerBakeSettings(World).DetectionRadius };
+	const FBox VisibilityBounds{ GetVisibilityBounds() };
+	const FBox PointBounds{ VisibilityBounds.ExpandBy(Range) };
+
+	TArray<AActor*> Points;
+	GrapplePoints.Reset();
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		// Field anchors are told apart by the runtime trace itself and are not part of the set
+		if (It->Implements<UGrapple>() && !It->IsA<AGrapplePointField>() && PointBounds.IsInsideOrOn(It->GetActorLocation()))
+		{
+			Points.Add(*It);
+			GrapplePoints.Add(*It);
+		}
+	}
+
+	GridOrigin = VisibilityBounds.Min;
+	const FVector Size{ VisibilityBounds.GetSize() };
+	GridSize = FIntVector(
+		FMath::Max(1, FMath::CeilToInt32(Size.X / CellSize.X)),
+		FMath::Max(1, FMath::CeilToInt32(Size.Y / CellSize.Y)),
+		FMath::Max(1, FMath::CeilToInt32(Size.Z / CellSize.Z)));
+	WordsPerCell = FMath::DivideAndRoundUp(Points.Num(), 32);
+
+	const int32 NumCells{ GridSize.X * GridSize.Y * GridSize.Z };
+	CellBits.Reset();
+	CellBits.SetNumZeroed(NumCells * WordsPerCell);
+
+	// The camera can be anywhere in a cell; its center and inset corners stand in for all of it
+	TArray<FVector, TInlineAllocator<9>> SampleOffsets{ FVector(0.5f) };
+	for (int32 Corner = 0; Corner < 8; Corner++)
+	{
+		SampleOffsets.Add(FVector((Corner & 1) ? 0.9f : 0.1f, (Corner & 2) ? 0.9f : 0.1f, (Corner & 4) ? 0.9f : 0.1f));
+	}
+
+	const float CellRadius{ static_cast<float>(CellSize.Size() * 0.5f) };
+
+	// Only static geometry is baked; characters and other movable blockers would bake in wherever they stood
+	FCollisionQueryParams Params{ FName{ TEXT("GrappleVisibility") }, false };
+	Params.MobilityType = EQueryMobilityType::Static;
+
+	// Cells only write their own words, so they are all traced in parallel
+	ParallelFor(NumCells, [&](int32 Cell)
+	{
+		const FIntVector Coordinates{ Cell % GridSize.X, (Cell / GridSize.X) % GridSize.Y, Cell / (GridSize.X * GridSize.Y) };
+		const FVector CellMin{ GridOrigin + FVector(Coordinates) * CellSize };
+		const FVector CellCenter{ CellMin + CellSize * 0.5f };
+
+		for (int32 Point = 0; Point < Points.Num(); Point++)
+		{
+			const FVector PointLocation{ Points[Point]->GetActorLocation() };
+			if (FVector::Distance(CellCenter, PointLocation) > Range + CellRadius) { continue; }
+
+			// Same test as the detection at runtime: the point itself must be the first thing hit. A movable point is
+			// skipped by the static trace, so reaching it unblocked counts as well
+			for (const FVector& SampleOffset : SampleOffsets)
+			{
+				FHitResult Hit;
+				World->LineTraceSingleByChannel(Hit, CellMin + SampleOffset * CellSize, PointLocation, ECC_Visibility, Params);
+				if (!Hit.bBlockingHit || Hit.GetActor() == Points[Point])
+				{
+					CellBits[Cell * WordsPerCell + Point / 32] |= 1u << (Point % 32);
+					break;
+				}
+			}
+		}
+	});
+
+	ResolvePoints();
+
+	UE_LOG(LogTemp, Log, TEXT("AGrappleVisibilityActor [BakeVisibility]: Baked %d grapple points into %dx%dx%d cells for %s."), Points.Num(), GridSize.X, GridSize.Y, GridSize.Z, *GetName())
+}
+#endif
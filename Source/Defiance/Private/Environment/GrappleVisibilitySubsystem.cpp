@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Environment/GrappleVisibilitySubsystem.h"
+#include "Interfaces/Grapple.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+
+
+void UGrappleVisibilitySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UGrappleVisibilitySubsystem::HandleLevelAddedToWorld);
+}
+
+void UGrappleVisibilitySubsystem::Deinitialize()
+{
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	Super::Deinitialize();
+}
+
+void UGrappleVisibilitySubsystem::HandleLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World != GetWorld() || !Level) { return; }
+
+	const bool bHasGrapples{ Level->Actors.ContainsByPredicate([](const AActor* Actor) { return Actor && Actor->Implements<UGrapple>(); }) };
+	if (!bHasGrapples) { return; }
+
+	for (const TWeakObjectPtr<AGrappleVisibilityActor>& VisibilitySet : VisibilitySets)
+	{
+		if (VisibilitySet.IsValid()) { VisibilitySet->ResolvePoints(); }
+	}
+}
+
+
+void UGrappleVisibilitySubsystem::RegisterVisibilitySet(AGrappleVisibilityActor* VisibilitySet)
+{
+	if (!IsValid(VisibilitySet)) { return; }
+
+	VisibilitySets.AddUnique(VisibilitySet);
+}
+
+void UGrappleVisibilitySubsystem::UnregisterVisibilitySet(AGrappleVisibilityActor* VisibilitySet)
+{
+	VisibilitySets.Remove(VisibilitySet);
+}
+
+EGrappleVisibility UGrappleVisibilitySubsystem::GetVisibility(const FVector& Location, const AActor* GrapplePoint) const
+{
+	// Sets do not overlap, so the first one that knows the point answers
+	for (const TWeakObjectPtr<AGrappleVisibilityActor>& VisibilitySet : VisibilitySets)
+	{
+		if (!VisibilitySet.IsValid()) { continue; }
+
+		const EGrappleVisibility Visibility{ VisibilitySet->GetVisibility(Location, GrapplePoint) };
+		if (Visibility != EGrappleVisibility::Unknown) { return Visibility; }
+	}
+
+	return EGrappleVisibility::Unknown;
+}
@@ -2,5 +2,48 @@
 
 
 #include "Interfaces/Enemy.h"
+#include "UI/TargetIndicatorSubsystem.h"
+#include "BasicSupportLibrary.h"
 
 // Add default functionality here for any IEnemy functions that are not pure virtual.
+
+void IEnemy::OnSelect_Implementation()
+{
+}
+
+void IEnemy::OnDeselect_Implementation()
+{
+}
+
+void IEnemy::NotifySelect(UObject* Target)
+{
+	// The indicator is fed here so Blueprints overriding the event cannot leave it out
+	AActor* TargetActor{ Cast<AActor>(Target) };
+	if (UTargetIndicatorSubsystem* Indicators{ UTargetIndicatorSubsystem::Get(TargetActor) }) { Indicators->SetLockOnTarget(TargetActor); }
+
+	IEnemy* NativeEnemy{ Cast<IEnemy>(Target) };
+	if (NativeEnemy && !UBasicSupportLibrary::IsEventOverriddenInBlueprint(Target, GET_FUNCTION_NAME_CHECKED(IEnemy, OnSelect)))
+	{
+		NativeEnemy->OnSelect_Implementation();
+	}
+	else if (IsValid(Target) && Target->Implements<UEnemy>())
+	{
+		Execute_OnSelect(Target);
+	}
+}
+
+void IEnemy::NotifyDeselect(UObject* Target)
+{
+	AActor* TargetActor{ Cast<AActor>(Target) };
+	if (UTargetIndicatorSubsystem* Indicators{ UTargetIndicatorSubsystem::Get(TargetActor) }) { Indicators->ClearLockOnTarget(TargetActor); }
+
+	IEnemy* NativeEnemy{ Cast<IEnemy>(Target) };
+	if (NativeEnemy && !UBasicSupportLibrary::IsEventOverriddenInBlueprint(Target, GET_FUNCTION_NAME_CHECKED(IEnemy, OnDeselect)))
+	{
+		NativeEnemy->OnDeselect_Implementation();
+	}
+	else if (IsValid(Target) && Target->Implements<UEnemy>())
+	{
+		Execute_OnDeselect(Target);
+	}
+}
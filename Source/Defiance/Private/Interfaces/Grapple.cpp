@@ -2,5 +2,66 @@
 
 
 #include "Interfaces/Grapple.h"
+#include "UI/TargetIndicatorSubsystem.h"
+#include "BasicSupportLibrary.h"
 
 // Add default functionality here for any IGrapple functions that are not pure virtual.
+
+void IGrapple::OnActivate_Implementation(const APawn* PlayerPawnRef, float InteractRange, float DetectionRange)
+{
+}
+
+void IGrapple::OnDeactivate_Implementation()
+{
+}
+
+FVector IGrapple::GetAnchorLocation(int32 Index) const
+{
+	const AActor* Self{ Cast<AActor>(_getUObject()) };
+	return Self ? Self->GetActorLocation() : FVector::ZeroVector;
+}
+
+void IGrapple::NotifyActivate(UObject* Grapple, int32 Index, const APawn* PlayerPawnRef, float InteractRange, float DetectionRange)
+{
+	IGrapple* NativeGrapple{ Cast<IGrapple>(Grapple) };
+	if (NativeGrapple && Index != INDEX_NONE)
+	{
+		NativeGrapple->OnActivateAnchor(Index, PlayerPawnRef, InteractRange, DetectionRange);
+		return;
+	}
+
+	// The indicator is fed here so Blueprints overriding the event cannot leave it out
+	AActor* GrappleActor{ Cast<AActor>(Grapple) };
+	if (UTargetIndicatorSubsystem* Indicators{ UTargetIndicatorSubsystem::Get(GrappleActor) }) { Indicators->SetActiveGrapple(GrappleActor, InteractRange, DetectionRange); }
+
+	if (NativeGrapple && !UBasicSupportLibrary::IsEventOverriddenInBlueprint(Grapple, GET_FUNCTION_NAME_CHECKED(IGrapple, OnActivate)))
+	{
+		NativeGrapple->OnActivate_Implementation(PlayerPawnRef, InteractRange, DetectionRange);
+	}
+	else if (IsValid(Grapple) && Grapple->Implements<UGrapple>())
+	{
+		Execute_OnActivate(Grapple, PlayerPawnRef, InteractRange, DetectionRange);
+	}
+}
+
+void IGrapple::NotifyDeactivate(UObject* Grapple, int32 Index)
+{
+	IGrapple* NativeGrapple{ Cast<IGrapple>(Grapple) };
+	if (NativeGrapple && Index != INDEX_NONE)
+	{
+		NativeGrapple->OnDeactivateAnchor(Index);
+		return;
+	}
+
+	AActor* GrappleActor{ Cast<AActor>(Grapple) };
+	if (UTargetIndicatorSubsystem* Indicators{ UTargetIndicatorSubsystem::Get(GrappleActor) }) { Indicators->ClearActiveGrapple(GrappleActor); }
+
+	if (NativeGrapple && !UBasicSupportLibrary::IsEventOverriddenInBlueprint(Grapple, GET_FUNCTION_NAME_CHECKED(IGrapple, OnDeactivate)))
+	{
+		NativeGrapple->OnDeactivate_Implementation();
+	}
+	else if (IsValid(Grapple) && Grapple->Implements<UGrapple>())
+	{
+		Execute_OnDeactivate(Grapple);
+	}
+}
@@ -0,0 +1,6 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Interfaces/Poolable.h"
+
+// Add default functionality here for any IPoolable functions that are not pure virtual.
@@ -0,0 +1,13 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MemoryTags.h"
+
+
+LLM_DEFINE_TAG(Defiance);
+LLM_DEFINE_TAG(Defiance_LockOn, "LockOn", "Defiance");
+LLM_DEFINE_TAG(Defiance_Grapple, "Grapple", "Defiance");
+LLM_DEFINE_TAG(Defiance_CommonActions, "CommonActions", "Defiance");
+LLM_DEFINE_TAG(Defiance_Animation, "Animation", "Defiance");
+LLM_DEFINE_TAG(Defiance_Network, "Network", "Defiance");
+LLM_DEFINE_TAG(Defiance_Crowd, "Crowd", "Defiance");
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Network/ActionValidationSubsystem.h"
+#include "MemoryTags.h"
+#include "Network/RewindSubsystem.h"
+#include "Network/NetTelemetrySubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/PlayerState.h"
+#include "Async/ParallelFor.h"
+
+
+UActionValidationSubsystem* UActionValidationSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UActionValidationSubsystem>() : nullptr;
+}
+
+TStatId UActionValidationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UActionValidationSubsystem, STATGROUP_Tickables);
+}
+
+bool UActionValidationSubsystem::IsTickable() const
+{
+	return Actions.Num() > 0;
+}
+
+
+
+void UActionValidationSubsystem::QueueAction(ENetAction Action, ACharacter* Requester, FApplyActionDelegate&& Apply, const AActor* Target, double ClientTimeStamp, float MaxDistance, FSimpleDelegate&& Reject)
+{
+	LLM_SCOPE_BYTAG(Defiance_Network);
+
+	// A client cannot make the server rewind further than it allows
+	const URewindSubsystem* Rewind{ URewindSubsystem::Get(this) };
+
+	Actions.Add(Action);
+	Requesters.Add(Requester);
+	Targets.Add(Target);
+	TimeStamps.Add(Rewind ? Rewind->ClampRewindTime(ClientTimeStamp) : ClientTimeStamp);
+	MaxDistances.Add(MaxDistance);
+	ApplyDelegates.Add(MoveTemp(Apply));
+	RejectDelegates.Add(MoveTemp(Reject));
+}
+
+void UActionValidationSubsystem::ResetQueue()
+{
+	Actions.Reset();
+	Requesters.Reset();
+	Targets.Reset();
+	TimeStamps.Reset();
+	MaxDistances.Reset();
+	ApplyDelegates.Reset();
+	RejectDelegates.Reset();
+}
+
+
+
+void UActionValidationSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int32 NumRequests{ Actions.Num() };
+	if (NumRequests == 0) { return; }
+
+	// Gather on the game thread: histories can be added and removed between frames, so pointers are only taken now
+	URewindSubsystem* Rewind{ URewindSubsystem::Get(this) };
+	RequesterHistories.SetNumUninitialized(NumRequests);
+	TargetHistories.SetNumUninitialized(NumRequests);
+	RequesterLocations.SetNumUninitialized(NumRequests);
+	TargetLocations.SetNumUninitialized(NumRequests);
+	HasTargets.SetNumUninitialized(NumRequests);
+	Accepted.SetNumUninitialized(NumRequests);
+
+	for (int32 i = 0; i < NumRequests; i++)
+	{
+		const ACharacter* Requester{ Requesters[i].Get() };
+		const AActor* Target{ Targets[i].Get() };
+
+		RequesterHistories[i] = Rewind && Requester ? Rewind->GetHistory(Requester) : nullptr;
+		TargetHistories[i] = Rewind && Target ? Rewind->GetHistory(Target) : nullptr;
+		RequesterLocations[i] = Requester ? Requester->GetActorLocation() : FVector::ZeroVector;
+		TargetLocations[i] = Target ? Target->GetActorLocation() : FVector::ZeroVector;
+		HasTargets[i] = Target != nullptr;
+
+		// A request whose requester left, or whose target disappeared, has nothing left to apply to
+		Accepted[i] = Requester && (Target || Targets[i].IsExplicitlyNull());
+	}
+
+	// Only reads the arrays above and writes its own entry of Accepted; weak pointers are never resolved off the game thread
+	ParallelFor(NumRequests, [this](int32 i)
+	{
+		if (!Accepted[i] || MaxDistances[i] <= 0.0f || !HasTargets[i]) { return; }
+
+		FRewindSample Sample;
+		const FVector RequesterLocation{ RequesterHistories[i] && RequesterHistories[i]->Query(TimeStamps[i], Sample) ? Sample.Location : RequesterLocations[i] };
+		const FVector TargetLocation{ TargetHistories[i] && TargetHistories[i]->Query(TimeStamps[i], Sample) ? Sample.Location : TargetLocations[i] };
+
+		Accepted[i] = FVector::DistSquared(RequesterLocation, TargetLocation) <= FMath::Square(MaxDistances[i]);
+	},
+	NumRequests < MinParallelRequests ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	// Order by player, then by arrival
+	ApplyOrder.SetNumUninitialized(NumRequests);
+	for (int32 i = 0; i < NumRequests; i++) { ApplyOrder[i] = i; }
+
+	auto GetPlayerId = [this](int32 Index)
+	{
+		const ACharacter* Requester{ Requesters[Index].Get() };
+		const APlayerState* PlayerState{ Requester ? Requester->GetPlayerState() : nullptr };
+		return PlayerState ? PlayerState->GetPlayerId() : MAX_int32;
+	};
+	ApplyOrder.StableSort([&GetPlayerId](int32 A, int32 B) { return GetPlayerId(A) < GetPlayerId(B); });
+
+	// Applying can send RPCs or change replicated state, which may queue new requests; those are handled next frame
+	TArray<ENetAction> FrameActions{ MoveTemp(Actions) };
+	TArray<FApplyActionDelegate> FrameApplyDelegates{ MoveTemp(ApplyDelegates) };
+	TArray<FSimpleDelegate> FrameRejectDelegates{ MoveTemp(RejectDelegates) };
+	ResetQueue();
+
+	UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(this) };
+	for (const int32 Index : ApplyOrder)
+	{
+		// The pass validated every request against the state at the start of the frame; the apply checks what changed since
+		const bool bApplied{ Accepted[Index] && FrameApplyDelegates[Index].IsBound() && FrameApplyDelegates[Index].Execute() };
+		if (bApplied) { continue; }
+
+		if (Telemetry) { Telemetry->RecordRejectedValidation(FrameActions[Index]); }
+		FrameRejectDelegates[Index].ExecuteIfBound();
+	}
+}
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Network/NetTelemetrySubsystem.h"
+#include "Engine/World.h"
+#include "Engine/NetConnection.h"
+#include "Engine/ActorChannel.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<float> CVarNetTelemetryCorrectionBudget(
+	TEXT("defiance.NetTelemetry.CorrectionBudget"),
+	30.0f,
+	TEXT("Maximum client corrections per minute before the telemetry reports the session as over budget."),
+	ECVF_Default);
+
+static FAutoConsoleCommandWithWorld NetTelemetryDumpCommand(
+	TEXT("defiance.NetTelemetry.Dump"),
+	TEXT("Prints the network correction telemetry gathered since the last reset."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(World) }) { Telemetry->DumpStats(); }
+	}));
+
+static FAutoConsoleCommandWithWorld NetTelemetryResetCommand(
+	TEXT("defiance.NetTelemetry.Reset"),
+	TEXT("Resets the network correction telemetry counters."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(World) }) { Telemetry->ResetStats(); }
+	}));
+
+
+void UNetTelemetrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	ResetStats();
+}
+
+UNetTelemetrySubsystem* UNetTelemetrySubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UNetTelemetrySubsystem>() : nullptr;
+}
+
+
+
+void UNetTelemetrySubsystem::RecordActionRequest(AActor* Owner, ENetAction Action)
+{
+	if (!IsValid(Owner)) { return; }
+
+	FNetActionStats& ActionStats{ GetMutableStats(Action) };
+	ActionStats.Requests++;
+	LastActions.Add(Owner, FLastAction{ Action, GetWorld()->GetTimeSeconds() });
+
+	// Sample how many reliable bunches are still waiting for an ack on the owner's channel
+	UNetConnection* Connection{ Owner->GetNetConnection() };
+	if (Connection == nullptr) { return; }
+
+	UActorChannel* Channel{ Connection->FindActorChannelRef(Owner) };
+	if (Channel == nullptr) { return; }
+
+	ActionStats.MaxReliableQueueDepth = FMath::Max(ActionStats.MaxReliableQueueDepth, Channel->NumOutRec);
+}
+
+void UNetTelemetrySubsystem::RecordCorrection(const AActor* Owner)
+{
+	ENetAction Action{ ENetAction::None };
+
+	if (const FLastAction* LastAction{ LastActions.Find(Owner) })
+	{
+		if (GetWorld()->GetTimeSeconds() - LastAction->Time <= AttributionWindow)
+		{
+			Action = LastAction->Action;
+		}
+	}
+
+	GetMutableStats(Action).Corrections++;
+}
+
+void UNetTelemetrySubsystem::RecordRejectedValidation(ENetAction Action)
+{
+	GetMutableStats(Action).RejectedValidations++;
+}
+
+
+
+float UNetTelemetrySubsystem::GetCorrectionsPerMinute() const
+{
+	int32 TotalCorrections{ 0 };
+	for (const FNetActionStats& ActionStats : Stats)
+	{
+		TotalCorrections += ActionStats.Corrections;
+	}
+
+	const double ElapsedMinutes{ (GetWorld()->GetTimeSeconds() - StartTime) / 60.0 };
+	if (ElapsedMinutes <= UE_SMALL_NUMBER) { return 0.0f; }
+
+	return static_cast<float>(TotalCorrections / ElapsedMinutes);
+}
+
+bool UNetTelemetrySubsystem::IsWithinCorrectionBudget() const
+{
+	return GetCorrectionsPerMinute() <= CVarNetTelemetryCorrectionBudget.GetValueOnGameThread();
+}
+
+void UNetTelemetrySubsystem::ResetStats()
+{
+	for (FNetActionStats& ActionStats : Stats)
+	{
+		ActionStats = FNetActionStats();
+	}
+	LastActions.Reset();
+	StartTime = GetWorld()->GetTimeSeconds();
+}
+
+void UNetTelemetrySubsystem::DumpStats() const
+{
+	const UEnum* ActionEnum{ StaticEnum<ENetAction>() };
+
+	UE_LOG(LogTemp, Log, TEXT("NetTelemetrySubsystem [DumpStats]: %.2f corrections/min (budget %.2f) over %.1f s"),
+		GetCorrectionsPerMinute(), CVarNetTelemetryCorrectionBudget.GetValueOnGameThread(), GetWorld()->GetTimeSeconds() - StartTime)
+
+	for (int32 i = 0; i < Stats.Num(); i++)
+	{
+		const FNetActionStats& ActionStats{ Stats[i] };
+		UE_LOG(LogTemp, Log, TEXT("    %-14s requests %5d | corrections %5d | rejected %5d | max reliable queue %3d"),
+			*ActionEnum->GetNameStringByIndex(i), ActionStats.Requests, ActionStats.Corrections,
+			ActionStats.RejectedValidations, ActionStats.MaxReliableQueueDepth)
+	}
+
+	if (!IsWithinCorrectionBudget())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("NetTelemetrySubsystem [DumpStats]: Corrections per minute exceed the budget."))
+	}
+}
@@ -0,0 +1,254 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Network/RewindSubsystem.h"
+#include "MemoryTags.h"
+#include "Characters/CommonActionsComponent.h"
+#include "Combat/MeleeComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+
+
+void FRewindHistory::Init(int32 InCapacity)
+{
+	const int32 Capacity{ FMath::Max(InCapacity, 2) };
+
+	Times.SetNumZeroed(Capacity);
+	Locations.SetNumZeroed(Capacity);
+	Rotations.SetNumZeroed(Capacity);
+	CapsuleRadii.SetNumZeroed(Capacity);
+	CapsuleHalfHeights.SetNumZeroed(Capacity);
+	Flags.SetNumZeroed(Capacity);
+	Head = 0;
+	Count = 0;
+}
+
+void FRewindHistory::Record(double Time, const FVector& Location, const FQuat& Rotation, float CapsuleRadius, float CapsuleHalfHeight, ERewindFlags InFlags)
+{
+	Times[Head] = Time;
+	Locations[Head] = Location;
+	Rotations[Head] = FQuat4f(Rotation);
+	CapsuleRadii[Head] = CapsuleRadius;
+	CapsuleHalfHeights[Head] = CapsuleHalfHeight;
+	Flags[Head] = InFlags;
+
+	Head = (Head + 1 == Times.Num()) ? 0 : Head + 1;
+	Count = FMath::Min(Count + 1, Times.Num());
+}
+
+bool FRewindHistory::Query(double Time, FRewindSample& OutSample) const
+{
+	if (Count == 0) { return false; }
+
+	// First sample at or after Time
+	int32 Low{ 0 };
+	int32 High{ Count };
+	while (Low < High)
+	{
+		const int32 Mid{ (Low + High) / 2 };
+		if (Times[GetPhysicalIndex(Mid)] < Time) { Low = Mid + 1; }
+		else { High = Mid; }
+	}
+
+	const int32 After{ GetPhysicalIndex(FMath::Min(Low, Count - 1)) };
+	const int32 Before{ GetPhysicalIndex(FMath::Max(Low - 1, 0)) };
+
+	const double Span{ Times[After] - Times[Before] };
+	const float Alpha{ Span > UE_DOUBLE_SMALL_NUMBER ? static_cast<float>(FMath::Clamp((Time - Times[Before]) / Span, 0.0, 1.0)) : 1.0f };
+
+	OutSample.Time = FMath::Clamp(Time, Times[GetPhysicalIndex(0)], Times[GetPhysicalIndex(Count - 1)]);
+	OutSample.Location = FMath::Lerp(Locations[Before], Locations[After], static_cast<double>(Alpha));
+	OutSample.Rotation = FQuat(FQuat4f::Slerp(Rotations[Before], Rotations[After], Alpha));
+	OutSample.CapsuleRadius = FMath::Lerp(CapsuleRadii[Before], CapsuleRadii[After], Alpha);
+	OutSample.CapsuleHalfHeight = FMath::Lerp(CapsuleHalfHeights[Before], CapsuleHalfHeights[After], Alpha);
+	// Actions are discrete; take them from whichever sample is closer
+	OutSample.Flags = (Alpha < 0.5f) ? Flags[Before] : Flags[After];
+	return true;
+}
+
+
+
+URewindSubsystem* URewindSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<URewindSubsystem>() : nullptr;
+}
+
+double URewindSubsystem::GetServerTime(const UObject* WorldContextObject)
+{
+	const UWorld* World{ IsValid(WorldContextObject) ? WorldContextObject->GetWorld() : nullptr };
+	if (!IsValid(World)) { return 0.0; }
+
+	const AGameStateBase* GameState{ World->GetGameState() };
+	return IsValid(GameState) ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+double URewindSubsystem::GetViewTime(const UObject* WorldContextObject)
+{
+	const UWorld* World{ IsValid(WorldContextObject) ? WorldContextObject->GetWorld() : nullptr };
+	if (!IsValid(World) || World->GetNetMode() != NM_Client) { return GetServerTime(WorldContextObject); }
+
+	const APlayerController* PlayerController{ World->GetFirstPlayerController() };
+	const APlayerState* PlayerState{ PlayerController ? PlayerController->PlayerState.Get() : nullptr };
+	const double OneWayTrip{ PlayerState ? PlayerState->GetPingInMilliseconds() * 0.0005 : 0.0 };
+
+	// Simulated characters are smoothed towards their replicated poses; the smoothing time is the delay it adds
+	const UCharacterMovementComponent* MovementDefaults{ GetDefault<UCharacterMovementComponent>() };
+	const ACharacter* Character{ PlayerController ? PlayerController->GetPawn<ACharacter>() : nullptr };
+	const UCharacterMovementComponent* Movement{ Character ? Character->GetCharacterMovement() : MovementDefaults };
+	const double InterpolationDelay{ Movement->NetworkSmoothingMode == ENetworkSmoothingMode::Disabled ? 0.0 : Movement->NetworkSimulatedSmoothLocationTime };
+
+	// The game state's clock is already corrected for the trip and estimates the server's present; the poses on screen
+	// left the server one trip before they arrived and are shown InterpolationDelay after that
+	return GetServerTime(WorldContextObject) - OneWayTrip - InterpolationDelay;
+}
+
+bool URewindSubsystem::IsTimeStampPlausible(double ClientTimeStamp) const
+{
+	if (!FMath::IsFinite(ClientTimeStamp)) { return false; }
+
+	const double Now{ GetWorld()->GetTimeSeconds() };
+	return ClientTimeStamp <= Now + MaxTimeStampError && ClientTimeStamp >= Now - HistoryLength - MaxTimeStampError;
+}
+
+double URewindSubsystem::ClampRewindTime(double ClientTimeStamp) const
+{
+	const double Now{ GetWorld()->GetTimeSeconds() };
+	return FMath::Clamp(ClientTimeStamp, Now - MaxRewindTime, Now);
+}
+
+TStatId URewindSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(URewindSubsystem, STATGROUP_Tickables);
+}
+
+bool URewindSubsystem::IsTickable() const
+{
+	return Characters.Num() > 0;
+}
+
+
+
+void URewindSubsystem::RegisterCharacter(ACharacter* Character)
+{
+	LLM_SCOPE_BYTAG(Defiance_Network);
+
+	if (!IsValid(Character) || !Character->HasAuthority()) { return; }
+	if (CharacterIndices.Contains(MakeWeakObjectPtr<const AActor>(Character))) { return; }
+
+	CharacterIndices.Add(MakeWeakObjectPtr<const AActor>(Character), Characters.Num());
+	Characters.Add(FRecordedCharacter{
+		Character,
+		Character->GetCharacterMovement(),
+		Character->FindComponentByClass<UCommonActionsComponent>(),
+		Character->FindComponentByClass<UMeleeComponent>() });
+	Histories.AddDefaulted_GetRef().Init(FMath::CeilToInt(HistoryLength * RecordRate) + 1);
+}
+
+void URewindSubsystem::UnregisterCharacter(const ACharacter* Character)
+{
+	const int32* Index{ CharacterIndices.Find(MakeWeakObjectPtr<const AActor>(Character)) };
+	if (Index) { RemoveCharacterAt(*Index); }
+}
+
+void URewindSubsystem::RemoveCharacterAt(int32 Index)
+{
+	// Keyed by the weak pointer itself, which still finds the entry of a character that is gone
+	CharacterIndices.Remove(TWeakObjectPtr<const AActor>(Characters[Index].Character));
+
+	Characters.RemoveAtSwap(Index);
+	Histories.RemoveAtSwap(Index);
+
+	// The last character took the removed one's place
+	if (Characters.IsValidIndex(Index))
+	{
+		CharacterIndices.Add(TWeakObjectPtr<const AActor>(Characters[Index].Character), Index);
+	}
+}
+
+const FRewindHistory* URewindSubsystem::GetHistory(const AActor* Actor) const
+{
+	const int32* Index{ CharacterIndices.Find(MakeWeakObjectPtr(Actor)) };
+	return Index ? &Histories[*Index] : nullptr;
+}
+
+bool URewindSubsystem::QueryCharacter(const AActor* Actor, double Time, FRewindSample& OutSample) const
+{
+	const FRewindHistory* History{ GetHistory(Actor) };
+	return History && History->Query(Time, OutSample);
+}
+
+FVector URewindSubsystem::GetLocationAtTime(const AActor* Actor, double Time) const
+{
+	FRewindSample Sample;
+	if (QueryCharacter(Actor, Time, Sample)) { return Sample.Location; }
+
+	return IsValid(Actor) ? Actor->GetActorLocation() : FVector::ZeroVector;
+}
+
+
+
+void URewindSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Time{ GetWorld()->GetTimeSeconds() };
+
+	for (int32 i = Characters.Num() - 1; i >= 0; i--)
+	{
+		const FRecordedCharacter& Recorded{ Characters[i] };
+		const ACharacter* Character{ Recorded.Character.Get() };
+
+		// A character destroyed without ending play never unregistered
+		if (!Character)
+		{
+			RemoveCharacterAt(i);
+			continue;
+		}
+
+		const UCapsuleComponent* Capsule{ Character->GetCapsuleComponent() };
+
+		Histories[i].Record(
+			Time,
+			Capsule->GetComponentLocation(),
+			Capsule->GetComponentQuat(),
+			Capsule->GetScaledCapsuleRadius(),
+			Capsule->GetScaledCapsuleHalfHeight(),
+			GetFlags(Recorded));
+	}
+}
+
+ERewindFlags URewindSubsystem::GetFlags(const FRecordedCharacter& Recorded) const
+{
+	ERewindFlags Flags{ ERewindFlags::None };
+
+	if (const UCharacterMovementComponent* Movement{ Recorded.MovementComp.Get() })
+	{
+		if (Movement->IsCrouching()) { Flags |= ERewindFlags::Crouching; }
+		if (Movement->IsFalling()) { Flags |= ERewindFlags::Falling; }
+		if (Movement->MovementMode == MOVE_Custom)
+		{
+			if (Movement->CustomMovementMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Climbing)) { Flags |= ERewindFlags::Climbing; }
+			if (Movement->CustomMovementMode == static_cast<uint8>(ECustomMovementMode::CMOVE_Swinging)) { Flags |= ERewindFlags::Swinging; }
+		}
+	}
+
+	if (const UCommonActionsComponent* CommonActions{ Recorded.CommonActionsComp.Get() })
+	{
+		if (CommonActions->bIsCrouching) { Flags |= ERewindFlags::Crouching; }
+		if (CommonActions->bIsDodging) { Flags |= ERewindFlags::Dodging; }
+		if (CommonActions->bIsRolling) { Flags |= ERewindFlags::Rolling; }
+	}
+
+	const UMeleeComponent* Melee{ Recorded.MeleeComp.Get() };
+	if (Melee && Melee->bIsAttacking) { Flags |= ERewindFlags::Attacking; }
+
+	return Flags;
+}
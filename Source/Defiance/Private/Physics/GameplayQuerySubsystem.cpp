@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Physics/GameplayQuerySubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+
+DECLARE_CYCLE_STAT(TEXT("Gameplay Queries"), STAT_GameplayQueries, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Queries Run"), STAT_GameplayQueriesRun, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Queries Shared"), STAT_GameplayQueriesShared, STATGROUP_Game);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Gameplay Queries Deferred"), STAT_GameplayQueriesDeferred, STATGROUP_Game);
+
+static TAutoConsoleVariable<float> CVarGameplayQueryBudget(
+	TEXT("defiance.Query.BudgetMicroseconds"),
+	500.0f,
+	TEXT("Time per frame spent on queued gameplay queries before the ones that can wait are moved to the next frame."),
+	ECVF_Default);
+
+
+UGameplayQuerySubsystem* UGameplayQuerySubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UGameplayQuerySubsystem>() : nullptr;
+}
+
+TStatId UGameplayQuerySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGameplayQuerySubsystem, STATGROUP_Tickables);
+}
+
+
+
+uint32 UGameplayQuerySubsystem::SubmitQuery(FGameplayQueryRequest&& Request)
+{
+	const uint32 QueryId{ NextQueryId++ };
+	if (NextQueryId == 0) { NextQueryId = 1; }
+
+	PendingQueries.Add(FPendingQuery{ MoveTemp(Request), QueryId, 0 });
+	return QueryId;
+}
+
+void UGameplayQuerySubsystem::CancelQuery(uint32 QueryId)
+{
+	if (QueryId == 0) { return; }
+
+	PendingQueries.RemoveAll([QueryId](const FPendingQuery& Query) { return Query.Id == QueryId; });
+
+	// A callback may cancel a query that is further down this frame's list
+	for (FPendingQuery& Query : RunningQueries)
+	{
+		if (Query.Id == QueryId) { Query.Id = 0; }
+	}
+}
+
+bool UGameplayQuerySubsystem::IsQueryPending(uint32 QueryId) const
+{
+	auto HasId = [QueryId](const FPendingQuery& Query) { return Query.Id == QueryId; };
+	return QueryId != 0 && (PendingQueries.ContainsByPredicate(HasId) || RunningQueries.ContainsByPredicate(HasId));
+}
+
+
+
+void UGameplayQuerySubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (PendingQueries.Num() == 0) { return; }
+
+	SCOPE_CYCLE_COUNTER(STAT_GameplayQueries);
+
+	RunningQueries = MoveTemp(PendingQueries);
+	PendingQueries.Reset();
+
+	// Queries past their deadline go first, then the highest priorities; the sort is stable so ties keep submission order
+	RunningQueries.StableSort([](const FPendingQuery& A, const FPendingQuery& B)
+	{
+		const bool bIsAOverdue{ A.FramesWaited >= A.Request.DeadlineFrames };
+		const bool bIsBOverdue{ B.FramesWaited >= B.Request.DeadlineFrames };
+		if (bIsAOverdue != bIsBOverdue) { return bIsAOverdue; }
+		return A.Request.Priority > B.Request.Priority;
+	});
+
+	const uint64 StartCycles{ FPlatformTime::Cycles64() };
+	const double BudgetMicroseconds{ CVarGameplayQueryBudget.GetValueOnGameThread() };
+
+	TArray<FHitResult> Hits;
+	for (int32 i = 0; i < RunningQueries.Num(); i++)
+	{
+		// Cancelled, or already answered by an identical query
+		if (RunningQueries[i].Id == 0) { continue; }
+
+		const bool bIsOverdue{ RunningQueries[i].FramesWaited >= RunningQueries[i].Request.DeadlineFrames };
+		const double ElapsedMicroseconds{ FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0 };
+		if (!bIsOverdue && ElapsedMicroseconds >= BudgetMicroseconds)
+		{
+			RunningQueries[i].FramesWaited++;
+			PendingQueries.Add(MoveTemp(RunningQueries[i]));
+			RunningQueries[i].Id = 0;
+			INC_DWORD_STAT(STAT_GameplayQueriesDeferred);
+			NumQueriesDeferred++;
+			continue;
+		}
+
+		Hits.Reset();
+		RunQuery(RunningQueries[i].Request, Hits);
+		INC_DWORD_STAT(STAT_GameplayQueriesRun);
+		NumQueriesRun++;
+
+		// Callbacks can cancel queries, so the ones sharing these hits are collected before any of them is called
+		TArray<int32, TInlineAllocator<8>> Receivers{ i };
+		for (int32 j = i + 1; j < RunningQueries.Num(); j++)
+		{
+			if (RunningQueries[j].Id != 0 && CanShareResults(RunningQueries[i].Request, RunningQueries[j].Request))
+			{
+				Receivers.Add(j);
+				INC_DWORD_STAT(STAT_GameplayQueriesShared);
+				NumQueriesShared++;
+			}
+		}
+
+		for (const int32 Receiver : Receivers)
+		{
+			if (RunningQueries[Receiver].Id == 0) { continue; }
+
+			RunningQueries[Receiver].Id = 0;
+			RunningQueries[Receiver].Request.OnComplete.ExecuteIfBound(Hits);
+		}
+	}
+
+	RunningQueries.Reset();
+}
+
+void UGameplayQuerySubsystem::RunQuery(const FGameplayQueryRequest& Request, TArray<FHitResult>& OutHits) const
+{
+	switch (Request.Shape)
+	{
+	case EGameplayQueryShape::Line:
+		GetWorld()->LineTraceMultiByChannel(OutHits, Request.Start, Request.End, Request.Channel, Request.Params);
+		break;
+
+	case EGameplayQueryShape::Sphere:
+		GetWorld()->SweepMultiByChannel(OutHits, Request.Start, Request.End, FQuat::Identity, Request.Channel,
+			FCollisionShape::MakeSphere(Request.Radius), Request.Params);
+		break;
+	}
+}
+
+bool UGameplayQuerySubsystem::CanShareResults(const FGameplayQueryRequest& A, const FGameplayQueryRequest& B)
+{
+	return A.Shape == B.Shape
+		&& A.Channel == B.Channel
+		&& FMath::IsNearlyEqual(A.Radius, B.Radius)
+		&& A.Start.Equals(B.Start, ShareTolerance)
+		&& A.End.Equals(B.End, ShareTolerance)
+		&& A.Params.bTraceComplex == B.Params.bTraceComplex
+		&& A.Params.GetIgnoredActors() == B.Params.GetIgnoredActors()
+		&& A.Params.GetIgnoredComponents() == B.Params.GetIgnoredComponents();
+}
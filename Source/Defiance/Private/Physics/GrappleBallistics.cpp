@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Physics/GrappleBallistics.h"
+#include "Math/VectorRegister.h"
+#include "Math/RandomStream.h"
+#include "Kismet/GameplayStatics.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+
+static FAutoConsoleCommandWithWorldAndArgs GrappleBallisticsBenchmarkCommand(
+	TEXT("defiance.Grapple.BallisticsBenchmark"),
+	TEXT("Times the batched reachability check against solving every arc with SuggestProjectileVelocity_CustomArc. Args: [Candidates=50] [Iterations=10000]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 NumCandidates{ Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 50 };
+		const int32 Iterations{ Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 10000 };
+
+		FRandomStream Random{ 1 };
+		TArray<float> X, Y, Z;
+		for (int32 i = 0; i < NumCandidates; i++)
+		{
+			X.Add(Random.FRandRange(-1000.0f, 1000.0f));
+			Y.Add(Random.FRandRange(-1000.0f, 1000.0f));
+			Z.Add(Random.FRandRange(-300.0f, 800.0f));
+		}
+
+		TArray<bool> Reachable;
+		Reachable.SetNumZeroed(NumCandidates);
+		const FVector LaunchModifier{ 1.6, 1.6, 1.2 };
+
+		double StartTime{ FPlatformTime::Seconds() };
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			FGrappleBallistics::ComputeReachable(FVector::ZeroVector, X, Y, Z, -980.0f, 0.3f, LaunchModifier, 2500.0f, Reachable);
+		}
+		const double BatchMicroseconds{ (FPlatformTime::Seconds() - StartTime) * 1.0e6 / Iterations };
+
+		int32 NumSolved{ 0 };
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			for (int32 i = 0; i < NumCandidates; i++)
+			{
+				FVector LaunchVelocity;
+				NumSolved += UGameplayStatics::SuggestProjectileVelocity_CustomArc(World, LaunchVelocity, FVector::ZeroVector, FVector(X[i], Y[i], Z[i]), -980.0f, 0.3f) ? 1 : 0;
+			}
+		}
+		const double ScalarMicroseconds{ (FPlatformTime::Seconds() - StartTime) * 1.0e6 / Iterations };
+
+		int32 NumReachable{ 0 };
+		for (const bool bReachable : Reachable) { NumReachable += bReachable ? 1 : 0; }
+
+		UE_LOG(LogTemp, Display, TEXT("FGrappleBallistics [Benchmark]: %d candidates, %d reachable. Batch %.2f us, one arc at a time %.2f us (%d solved)."),
+			NumCandidates, NumReachable, BatchMicroseconds, ScalarMicroseconds, NumSolved / Iterations)
+	}));
+
+
+void FGrappleBallistics::ComputeReachable(
+	const FVector& Start,
+	TConstArrayView<float> TargetX,
+	TConstArrayView<float> TargetY,
+	TConstArrayView<float> TargetZ,
+	float GravityZ,
+	float ArcParam,
+	const FVector& LaunchModifier,
+	float MaxLaunchSpeed,
+	TArrayView<bool> OutReachable)
+{
+	const int32 NumTargets{ OutReachable.Num() };
+	check(TargetX.Num() == NumTargets && TargetY.Num() == NumTargets && TargetZ.Num() == NumTargets);
+
+	// For a launch direction L = Lerp(Up, Dir, ArcParam) at angle Theta above the horizon, a target at horizontal
+	// distance H and height Dz needs Speed² = G H² / (2 cos²Theta (H tanTheta - Dz)). It is reachable when that is
+	// positive and the speed after LaunchModifier does not exceed MaxLaunchSpeed. Everything stays squared, so each
+	// target costs two square roots and no trigonometry.
+	const VectorRegister4Float Gravity{ VectorSetFloat1(-GravityZ) };
+	const VectorRegister4Float Arc{ VectorSetFloat1(ArcParam) };
+	const VectorRegister4Float OneMinusArc{ VectorSetFloat1(1.0f - ArcParam) };
+	const VectorRegister4Float ModifierX{ VectorSetFloat1(static_cast<float>(FMath::Square(LaunchModifier.X))) };
+	const VectorRegister4Float ModifierY{ VectorSetFloat1(static_cast<float>(FMath::Square(LaunchModifier.Y))) };
+	const VectorRegister4Float ModifierZ{ VectorSetFloat1(static_cast<float>(FMath::Square(LaunchModifier.Z))) };
+	const VectorRegister4Float MaxSpeedSquared{ VectorSetFloat1(FMath::Square(MaxLaunchSpeed)) };
+	const VectorRegister4Float Two{ VectorSetFloat1(2.0f) };
+	const VectorRegister4Float MinDistance{ VectorSetFloat1(UE_KINDA_SMALL_NUMBER) };
+
+	for (int32 First = 0; First < NumTargets; First += 4)
+	{
+		// The last batch is padded with a target straight ahead, which is never read back
+		alignas(16) float X[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
+		alignas(16) float Y[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
+		alignas(16) float Z[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
+		const int32 NumInBatch{ FMath::Min(4, NumTargets - First) };
+		for (int32 Lane = 0; Lane < NumInBatch; Lane++)
+		{
+			X[Lane] = TargetX[First + Lane] - static_cast<float>(Start.X);
+			Y[Lane] = TargetY[First + Lane] - static_cast<float>(Start.Y);
+			Z[Lane] = TargetZ[First + Lane] - static_cast<float>(Start.Z);
+		}
+
+		const VectorRegister4Float Dx{ VectorLoadAligned(X) };
+		const VectorRegister4Float Dy{ VectorLoadAligned(Y) };
+		const VectorRegister4Float Dz{ VectorLoadAligned(Z) };
+
+		const VectorRegister4Float HorizontalSquared{ VectorMultiplyAdd(Dx, Dx, VectorMultiply(Dy, Dy)) };
+		const VectorRegister4Float DistanceSquared{ VectorMultiplyAdd(Dz, Dz, HorizontalSquared) };
+		const VectorRegister4Float Horizontal{ VectorSqrt(HorizontalSquared) };
+		const VectorRegister4Float Distance{ VectorMax(VectorSqrt(DistanceSquared), MinDistance) };
+
+		// Launch direction, not normalized: horizontal length and height
+		const VectorRegister4Float LaunchHorizontal{ VectorMax(VectorDivide(VectorMultiply(Arc, Horizontal), Distance), MinDistance) };
+		const VectorRegister4Float LaunchUp{ VectorAdd(OneMinusArc, VectorDivide(VectorMultiply(Arc, Dz), Distance)) };
+		const VectorRegister4Float LaunchSquared{ VectorMultiplyAdd(LaunchUp, LaunchUp, VectorMultiply(LaunchHorizontal, LaunchHorizontal)) };
+
+		// 2 cos²Theta (H tanTheta - Dz), with cos²Theta = LaunchHorizontal² / LaunchSquared and tanTheta = LaunchUp / LaunchHorizontal
+		const VectorRegister4Float CosSquared{ VectorDivide(VectorMultiply(LaunchHorizontal, LaunchHorizontal), LaunchSquared) };
+		const VectorRegister4Float Rise{ VectorSubtract(VectorDivide(VectorMultiply(Horizontal, LaunchUp), LaunchHorizontal), Dz) };
+		const VectorRegister4Float Denominator{ VectorMultiply(Two, VectorMultiply(CosSquared, Rise)) };
+		const VectorRegister4Float SpeedSquared{ VectorDivide(VectorMultiply(Gravity, HorizontalSquared), Denominator) };
+
+		// Squared length of the modified velocity: Speed² / |L|² * (Arc² (Dx² Mx² + Dy² My²) / Distance² + LaunchUp² Mz²)
+		const VectorRegister4Float ArcOverDistance{ VectorDivide(Arc, Distance) };
+		const VectorRegister4Float HorizontalModified{ VectorMultiply(VectorMultiply(ArcOverDistance, ArcOverDistance), VectorMultiplyAdd(VectorMultiply(Dx, Dx), ModifierX, VectorMultiply(VectorMultiply(Dy, Dy), ModifierY))) };
+		const VectorRegister4Float ModifiedSquared{ VectorMultiply(VectorDivide(SpeedSquared, LaunchSquared), VectorMultiplyAdd(VectorMultiply(LaunchUp, LaunchUp), ModifierZ, HorizontalModified)) };
+
+		const VectorRegister4Float Reachable{ VectorBitwiseAnd(VectorCompareGT(Denominator, VectorZeroFloat()), VectorCompareLE(ModifiedSquared, MaxSpeedSquared)) };
+		const int32 Mask{ VectorMaskBits(Reachable) };
+		for (int32 Lane = 0; Lane < NumInBatch; Lane++)
+		{
+			OutReachable[First + Lane] = (Mask & (1 << Lane)) != 0;
+		}
+	}
+}
@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Physics/RopeSolver.h"
+
+
+void FRopeSolver::Init(const FVector& Anchor, const FVector& End, int32 NumSegments, const FVector& EndVelocity, float FixedDeltaTime)
+{
+	NumSegments = FMath::Max(NumSegments, 1);
+	const int32 NumParticles{ NumSegments + 1 };
+
+	Origin = Anchor;
+	const FVector3f LocalEnd{ End - Anchor };
+	SegmentLength = LocalEnd.Size() / NumSegments;
+
+	PosX.SetNumUninitialized(NumParticles);
+	PosY.SetNumUninitialized(NumParticles);
+	PosZ.SetNumUninitialized(NumParticles);
+	PrevX.SetNumUninitialized(NumParticles);
+	PrevY.SetNumUninitialized(NumParticles);
+	PrevZ.SetNumUninitialized(NumParticles);
+	InvMass.SetNumUninitialized(NumParticles);
+
+	// Lay the particles out on a straight line; velocity ramps up along the chain so the end keeps the character's momentum
+	for (int32 i = 0; i < NumParticles; i++)
+	{
+		const float Alpha{ static_cast<float>(i) / NumSegments };
+		const FVector3f Position{ LocalEnd * Alpha };
+		const FVector3f PreviousPosition{ Position - FVector3f(EndVelocity) * Alpha * FixedDeltaTime };
+
+		PosX[i] = Position.X;
+		PosY[i] = Position.Y;
+		PosZ[i] = Position.Z;
+		PrevX[i] = PreviousPosition.X;
+		PrevY[i] = PreviousPosition.Y;
+		PrevZ[i] = PreviousPosition.Z;
+		InvMass[i] = (i == 0) ? 0.0f : 1.0f;
+	}
+}
+
+void FRopeSolver::Reset()
+{
+	PosX.Reset();
+	PosY.Reset();
+	PosZ.Reset();
+	PrevX.Reset();
+	PrevY.Reset();
+	PrevZ.Reset();
+	InvMass.Reset();
+}
+
+void FRopeSolver::Step(float FixedDeltaTime, const FVector3f& EndAcceleration)
+{
+	if (!IsActive()) { return; }
+
+	Integrate(FixedDeltaTime, EndAcceleration);
+
+	for (int32 Iteration = 0; Iteration < ConstraintIterations; Iteration++)
+	{
+		SolveDistanceConstraints(0);
+		SolveDistanceConstraints(1);
+	}
+}
+
+FVector FRopeSolver::GetEndLocation() const
+{
+	if (!IsActive()) { return Origin; }
+
+	return GetParticleLocation(PosX.Num() - 1);
+}
+
+FVector FRopeSolver::GetEndVelocity(float FixedDeltaTime) const
+{
+	if (!IsActive() || FixedDeltaTime <= 0.0f) { return FVector::ZeroVector; }
+
+	const int32 Last{ PosX.Num() - 1 };
+	return FVector(PosX[Last] - PrevX[Last], PosY[Last] - PrevY[Last], PosZ[Last] - PrevZ[Last]) / FixedDeltaTime;
+}
+
+void FRopeSolver::SetEndState(const FVector& End, const FVector& EndVelocity, float FixedDeltaTime)
+{
+	if (!IsActive()) { return; }
+
+	// The distance constraints pull the rest of the chain along on the next step
+	const int32 Last{ PosX.Num() - 1 };
+	const FVector3f Position{ End - Origin };
+	const FVector3f PreviousPosition{ Position - FVector3f(EndVelocity) * FixedDeltaTime };
+
+	PosX[Last] = Position.X;
+	PosY[Last] = Position.Y;
+	PosZ[Last] = Position.Z;
+	PrevX[Last] = PreviousPosition.X;
+	PrevY[Last] = PreviousPosition.Y;
+	PrevZ[Last] = PreviousPosition.Z;
+}
+
+
+
+void FRopeSolver::Integrate(float FixedDeltaTime, const FVector3f& EndAcceleration)
+{
+	const int32 NumParticles{ PosX.Num() };
+	const float Retain{ 1.0f - Damping };
+	const float GravityStep{ Gravity * FixedDeltaTime * FixedDeltaTime };
+
+	float* RESTRICT PX{ PosX.GetData() };
+	float* RESTRICT PY{ PosY.GetData() };
+	float* RESTRICT PZ{ PosZ.GetData() };
+	float* RESTRICT QX{ PrevX.GetData() };
+	float* RESTRICT QY{ PrevY.GetData() };
+	float* RESTRICT QZ{ PrevZ.GetData() };
+	const float* RESTRICT W{ InvMass.GetData() };
+
+	// Verlet integration; pinned particles have zero inverse mass, which zeroes their update without a branch
+	for (int32 i = 0; i < NumParticles; i++)
+	{
+		const float VX{ (PX[i] - QX[i]) * Retain * W[i] };
+		const float VY{ (PY[i] - QY[i]) * Retain * W[i] };
+		const float VZ{ (PZ[i] - QZ[i]) * Retain * W[i] };
+
+		QX[i] = PX[i];
+		QY[i] = PY[i];
+		QZ[i] = PZ[i];
+
+		PX[i] += VX;
+		PY[i] += VY;
+		PZ[i] += VZ - GravityStep * W[i];
+	}
+
+	const int32 Last{ NumParticles - 1 };
+	const float InputStep{ FixedDeltaTime * FixedDeltaTime * W[Last] };
+	PX[Last] += EndAcceleration.X * InputStep;
+	PY[Last] += EndAcceleration.Y * InputStep;
+	PZ[Last] += EndAcceleration.Z * InputStep;
+}
+
+void FRopeSolver::SolveDistanceConstraints(int32 FirstSegment)
+{
+	const int32 NumSegments{ PosX.Num() - 1 };
+
+	float* RESTRICT PX{ PosX.GetData() };
+	float* RESTRICT PY{ PosY.GetData() };
+	float* RESTRICT PZ{ PosZ.GetData() };
+	const float* RESTRICT W{ InvMass.GetData() };
+
+	for (int32 i = FirstSegment; i < NumSegments; i += 2)
+	{
+		const float DX{ PX[i + 1] - PX[i] };
+		const float DY{ PY[i + 1] - PY[i] };
+		const float DZ{ PZ[i + 1] - PZ[i] };
+		const float Length{ FMath::Sqrt(DX * DX + DY * DY + DZ * DZ) };
+		const float WeightSum{ W[i] + W[i + 1] };
+
+		if (Length < UE_KINDA_SMALL_NUMBER || WeightSum <= 0.0f) { continue; }
+
+		const float Correction{ (Length - SegmentLength) / (Length * WeightSum) };
+
+		PX[i] += W[i] * Correction * DX;
+		PY[i] += W[i] * Correction * DY;
+		PZ[i] += W[i] * Correction * DZ;
+		PX[i + 1] -= W[i + 1] * Correction * DX;
+		PY[i + 1] -= W[i + 1] * Correction * DY;
+		PZ[i + 1] -= W[i + 1] * Correction * DZ;
+	}
+}
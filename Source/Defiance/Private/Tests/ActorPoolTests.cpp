@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/DefianceTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationCommon.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Characters/ActorPoolSubsystem.h"
+#include "Characters/CommonActionsComponent.h"
+#include "Combat/LockOnComponent.h"
+#include "../../DefianceCharacter.h"
+
+
+namespace DefianceTests
+{
+	/** Waves timed for each way of spawning */
+	constexpr int32 PoolBenchmarkWaves{ 10 };
+
+	/** Actors in each wave */
+	constexpr int32 PoolBenchmarkWaveSize{ 50 };
+
+	/** The player character, whose Blueprint adds the common actions component */
+	constexpr const TCHAR* PooledCharacterClassPath{ TEXT("/Game/ThirdPerson/Blueprints/BP_ThirdPersonCharacter.BP_ThirdPersonCharacter_C") };
+
+	/** The action flags are only changed through input and RPCs, so the test reaches them through reflection */
+	static void SetActionFlag(UObject* Object, FName Name, bool bValue)
+	{
+		if (const FBoolProperty* Property{ FindFProperty<FBoolProperty>(Object->GetClass(), Name) }) { Property->SetPropertyValue_InContainer(Object, bValue); }
+	}
+
+	static bool GetActionFlag(const UObject* Object, FName Name)
+	{
+		const FBoolProperty* Property{ FindFProperty<FBoolProperty>(Object->GetClass(), Name) };
+		return Property && Property->GetPropertyValue_InContainer(Object);
+	}
+
+	/** Locks on, sprints, crouches and dodges, as a character killed mid-fight would */
+	static void DirtyCharacterState(ADefianceCharacter* Character, AActor* Target)
+	{
+		Character->LockOnComponent->CurrentTargetActor = Target;
+
+		UCommonActionsComponent* CommonActions{ Character->FindComponentByClass<UCommonActionsComponent>() };
+		if (!CommonActions) { return; }
+
+		SetActionFlag(CommonActions, TEXT("bIsSprinting"), true);
+		CommonActions->ProcessEvent(CommonActions->FindFunctionChecked(TEXT("OnRep_IsSprinting")), nullptr);
+		SetActionFlag(CommonActions, TEXT("bIsCrouching"), true);
+		SetActionFlag(CommonActions, TEXT("bIsDodging"), true);
+		SetActionFlag(CommonActions, TEXT("bIsRolling"), true);
+	}
+
+	/** Checks nothing of a previous life is left on the character */
+	static void TestResetState(FAutomationTestBase* Test, const ADefianceCharacter* Character)
+	{
+		Test->TestNull(TEXT("The lock-on target is dropped"), Character->LockOnComponent->CurrentTargetActor);
+
+		const UCommonActionsComponent* CommonActions{ Character->FindComponentByClass<UCommonActionsComponent>() };
+		if (!Test->TestNotNull(TEXT("The character has a common actions component"), CommonActions)) { return; }
+
+		Test->TestFalse(TEXT("Sprinting is reset"), GetActionFlag(CommonActions, TEXT("bIsSprinting")));
+		Test->TestFalse(TEXT("Crouching is reset"), GetActionFlag(CommonActions, TEXT("bIsCrouching")));
+		Test->TestFalse(TEXT("Dodging is reset"), GetActionFlag(CommonActions, TEXT("bIsDodging")));
+		Test->TestFalse(TEXT("Rolling is reset"), GetActionFlag(CommonActions, TEXT("bIsRolling")));
+
+		const FFloatProperty* MaxRunSpeed{ FindFProperty<FFloatProperty>(UCommonActionsComponent::StaticClass(), TEXT("MaxRunSpeed")) };
+		Test->TestEqual(TEXT("The walk speed is back to the run speed"), Character->GetCharacterMovement()->MaxWalkSpeed, MaxRunSpeed->GetPropertyValue_InContainer(CommonActions));
+	}
+
+	/** Checks the actor is parked in the pool with nothing ticking, colliding or moving */
+	static void TestPooledState(FAutomationTestBase* Test, const UActorPoolSubsystem* Pool, const ACharacter* Character)
+	{
+		Test->TestTrue(TEXT("Pooled actors are hidden"), Character->IsHidden());
+		Test->TestFalse(TEXT("Pooled actors do not collide"), Character->GetActorEnableCollision());
+		Test->TestFalse(TEXT("Pooled actors do not tick"), Character->IsActorTickEnabled());
+		Test->TestEqual(TEXT("Pooled actors are parked at the pool location"), Character->GetActorLocation(), Pool->PoolLocation);
+		Test->TestTrue(TEXT("Pooled characters do not move"), Character->GetCharacterMovement()->MovementMode == MOVE_None);
+
+		for (const UActorComponent* Component : Character->GetComponents())
+		{
+			if (Component->IsComponentTickEnabled())
+			{
+				Test->AddError(FString::Printf(TEXT("%s of a pooled actor still ticks."), *Component->GetName()));
+			}
+		}
+	}
+
+	/** Checks the actor was handed out the way a freshly spawned one would be */
+	static void TestAcquiredState(FAutomationTestBase* Test, const ACharacter* Character, const FTransform& Transform)
+	{
+		Test->TestFalse(TEXT("Acquired actors are visible"), Character->IsHidden());
+		Test->TestTrue(TEXT("Acquired actors collide"), Character->GetActorEnableCollision());
+		Test->TestEqual(TEXT("Acquired actors tick like spawned ones"), Character->IsActorTickEnabled(), Character->PrimaryActorTick.bStartWithTickEnabled != 0);
+		Test->TestEqual(TEXT("Acquired actors are placed at the requested transform"), Character->GetActorLocation(), Transform.GetLocation());
+		Test->TestTrue(TEXT("The movement component ticks again"), Character->GetCharacterMovement()->IsComponentTickEnabled());
+		Test->TestTrue(TEXT("Acquired characters can move"), Character->GetCharacterMovement()->MovementMode != MOVE_None);
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FActorPoolBenchmarkTest, "Defiance.Performance.ActorPool", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FActorPoolBenchmarkTest::RunTest(const FString& Parameters)
+{
+	DefianceTests::QueueStartNetPIE(this);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this]()
+	{
+		UWorld* World{ DefianceTests::FindPIEWorld(NM_DedicatedServer) };
+		UActorPoolSubsystem* Pool{ UActorPoolSubsystem::Get(World) };
+		if (!Pool)
+		{
+			AddError(TEXT("The PIE server has no actor pool subsystem."));
+			return true;
+		}
+
+		const TSubclassOf<ADefianceCharacter> CharacterClass{ LoadClass<ADefianceCharacter>(nullptr, DefianceTests::PooledCharacterClassPath) };
+		if (!CharacterClass)
+		{
+			AddError(TEXT("The player character class could not be loaded."));
+			return true;
+		}
+
+		TSet<AActor*> PooledActors;
+		const FActorPoolBenchmarkResult Result{ Pool->Benchmark(CharacterClass, DefianceTests::PoolBenchmarkWaves, DefianceTests::PoolBenchmarkWaveSize,
+			[this, Pool, &CharacterClass, &PooledActors](const TArray<AActor*>& Wave)
+			{
+				TestEqual(TEXT("Waves empty the pool without spawning"), Pool->GetNumFree(CharacterClass), 0);
+
+				for (int32 i = 0; i < Wave.Num(); i++)
+				{
+					ADefianceCharacter* Character{ Cast<ADefianceCharacter>(Wave[i]) };
+					if (!TestNotNull(TEXT("Acquired actor"), Character)) { continue; }
+
+					// Every wave after the first gets back the characters dirtied by the previous one
+					DefianceTests::TestAcquiredState(this, Character, UActorPoolSubsystem::GetBenchmarkTransform(i));
+					DefianceTests::TestResetState(this, Character);
+					DefianceTests::DirtyCharacterState(Character, Wave[(i + 1) % Wave.Num()]);
+					PooledActors.Add(Character);
+				}
+			}) };
+
+		TestEqual(TEXT("Every wave reuses the pre-warmed actors"), PooledActors.Num(), DefianceTests::PoolBenchmarkWaveSize);
+		TestEqual(TEXT("The last wave went back to the pool"), Pool->GetNumFree(CharacterClass), DefianceTests::PoolBenchmarkWaveSize);
+
+		for (AActor* Actor : PooledActors)
+		{
+			const ADefianceCharacter* Character{ CastChecked<ADefianceCharacter>(Actor) };
+			DefianceTests::TestPooledState(this, Pool, Character);
+			DefianceTests::TestResetState(this, Character);
+		}
+
+		// Timings depend on the machine and what else it is doing, so they are reported rather than asserted
+		AddInfo(FString::Printf(TEXT("Waves of %d: SpawnActor %.3f ms, pool %.3f ms."), DefianceTests::PoolBenchmarkWaveSize, Result.SpawnAverage, Result.PoolAverage));
+		return true;
+	}));
+
+	DefianceTests::QueueEndPIE();
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/DefianceTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationCommon.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/StaticMesh.h"
+#include "Components/StaticMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Characters/ClimbingComponent.h"
+#include "Environment/ClimbGraphActor.h"
+#include "Environment/ClimbGraphSubsystem.h"
+#include "Network/NetTelemetrySubsystem.h"
+
+
+namespace DefianceTests
+{
+	/** Round trip latency the climbing sequence is played under */
+	constexpr int32 ClimbPktLag{ 150 };
+
+	/** Climb corrections the sequence may cause before the test fails */
+	constexpr int32 MaxClimbCorrections{ 1 };
+
+	/** Seconds the climbing sequence runs for */
+	constexpr double ClimbSequenceDuration{ 12.0 };
+
+	/** Graph id of the test wall; a graph baked into the map only shares it by chance */
+	constexpr uint16 ClimbTestGraphId{ 0xFFF0 };
+
+	/**
+	 * Builds a ledged wall right in front of the given transform and bakes a climb graph for it. Server and client get
+	 * the same wall and graph so edge handles resolve to the same edge on both. Returns the number of edges baked.
+	 */
+	static int32 SpawnClimbWall(UWorld* World, const FTransform& PawnTransform)
+	{
+		UStaticMesh* Cube{ LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube")) };
+		if (!World || !Cube) { return 0; }
+
+		// 100 deep, 600 wide and 180 high, so the top front edge is at hand height and 45cm in front of the capsule
+		const FVector Forward{ PawnTransform.GetUnitAxis(EAxis::X).GetSafeNormal2D() };
+		const FVector Feet{ PawnTransform.GetLocation() - FVector(0.0f, 0.0f, 90.0f) };
+		const FTransform WallTransform{ Forward.Rotation(), Feet + Forward * 95.0f + FVector(0.0f, 0.0f, 90.0f), FVector(1.0f, 6.0f, 1.8f) };
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		// A registered static component refuses a new mesh, so the wall is set up before it finishes spawning
+		AStaticMeshActor* Wall{ World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), WallTransform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn) };
+		Wall->GetStaticMeshComponent()->SetStaticMesh(Cube);
+		Wall->Tags.Add(TEXT("Climb.Ledge"));
+		Wall->FinishSpawning(WallTransform);
+
+		// Baking changes the id, so the graph leaves the subsystem until it is done
+		AClimbGraphActor* Graph{ World->SpawnActor<AClimbGraphActor>(AClimbGraphActor::StaticClass(), FTransform(WallTransform.GetLocation()), SpawnParams) };
+		UClimbGraphSubsystem* ClimbGraph{ World->GetSubsystem<UClimbGraphSubsystem>() };
+		ClimbGraph->UnregisterGraph(Graph);
+		Graph->BakeClimbGraph();
+		Graph->GraphId = ClimbTestGraphId;
+		ClimbGraph->RegisterGraph(Graph);
+		return Graph->Edges.Num();
+	}
+
+	/** Grabs the ledge, shimmies both ways, drops, grabs again and climbs up */
+	static void RunClimbSequence(APawn* Pawn, double PreviousTime, double Time, bool& bOutClimbed)
+	{
+		UClimbingComponent* Climbing{ Pawn->FindComponentByClass<UClimbingComponent>() };
+		if (!Climbing) { return; }
+
+		auto Crossed = [PreviousTime, Time](double At) { return PreviousTime < At && Time >= At; };
+
+		if (Crossed(1.0) || Crossed(7.5)) { Climbing->TryGrab(); }
+		if (Time >= 2.0 && Time < 4.0) { Climbing->Shimmy(1.0f); }
+		if (Time >= 4.0 && Time < 6.0) { Climbing->Shimmy(-1.0f); }
+		if (Crossed(6.5)) { Climbing->Descend(); }
+		if (Crossed(9.0)) { Climbing->Ascend(); }
+
+		bOutClimbed |= Climbing->IsClimbing();
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FClimbCorrectionTest, "Defiance.Network.ClimbCorrections", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FClimbCorrectionTest::RunTest(const FString& Parameters)
+{
+	DefianceTests::QueueStartNetPIE(this);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this]()
+	{
+		APawn* ServerPawn{ DefianceTests::FindServerPawn() };
+		APawn* ClientPawn{ DefianceTests::FindClientPawn() };
+		if (!ServerPawn || !ClientPawn) { return true; }
+
+		if (!ClientPawn->FindComponentByClass<UClimbingComponent>())
+		{
+			AddError(TEXT("The player pawn has no UClimbingComponent."));
+			return true;
+		}
+
+		// Both walls are placed from the server's transform, which the client's pawn was spawned at
+		const FTransform PawnTransform{ ServerPawn->GetActorTransform() };
+		TestTrue(TEXT("The server baked the wall's edges"), DefianceTests::SpawnClimbWall(ServerPawn->GetWorld(), PawnTransform) > 0);
+		TestTrue(TEXT("The client baked the wall's edges"), DefianceTests::SpawnClimbWall(ClientPawn->GetWorld(), PawnTransform) > 0);
+
+		DefianceTests::SetPacketSimulation(DefianceTests::ClimbPktLag, 0);
+		if (UNetTelemetrySubsystem* Telemetry{ UNetTelemetrySubsystem::Get(ClientPawn) }) { Telemetry->ResetStats(); }
+		return true;
+	}));
+
+	TSharedRef<bool> bClimbed{ MakeShared<bool>(false) };
+	ADD_LATENT_AUTOMATION_COMMAND(FRunPawnScriptCommand(this, [bClimbed](APawn* Pawn, double PreviousTime, double Time)
+	{
+		DefianceTests::RunClimbSequence(Pawn, PreviousTime, Time, *bClimbed);
+	}, DefianceTests::ClimbSequenceDuration));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, bClimbed]()
+	{
+		APawn* Pawn{ DefianceTests::FindClientPawn() };
+		const UNetTelemetrySubsystem* Telemetry{ Pawn ? UNetTelemetrySubsystem::Get(Pawn) : nullptr };
+		if (Telemetry)
+		{
+			Telemetry->DumpStats();
+			TestTrue(TEXT("The client grabbed the ledge"), *bClimbed);
+			TestTrue(TEXT("Climb corrections at 150ms"), Telemetry->GetActionStats(ENetAction::Climb).Corrections <= DefianceTests::MaxClimbCorrections);
+		}
+
+		DefianceTests::SetPacketSimulation(0, 0);
+		return true;
+	}));
+
+	DefianceTests::QueueEndPIE();
+
+	return true;
+}
+
+#endif
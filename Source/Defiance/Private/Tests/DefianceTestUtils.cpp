@@ -0,0 +1,141 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/DefianceTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationCommon.h"
+#include "Editor.h"
+#include "FileHelpers.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+
+
+namespace DefianceTests
+{
+	/** Seconds the session may take to start and spawn the client's pawn */
+	constexpr double PIEStartTimeout{ 60.0 };
+}
+
+
+UWorld* DefianceTests::FindPIEWorld(ENetMode NetMode)
+{
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World{ Context.World() };
+		if (Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NetMode) { return World; }
+	}
+
+	return nullptr;
+}
+
+APawn* DefianceTests::FindClientPawn()
+{
+	UWorld* ClientWorld{ FindPIEWorld(NM_Client) };
+	APlayerController* PlayerController{ ClientWorld ? ClientWorld->GetFirstPlayerController() : nullptr };
+	return PlayerController ? PlayerController->GetPawn() : nullptr;
+}
+
+APawn* DefianceTests::FindServerPawn()
+{
+	UWorld* ServerWorld{ FindPIEWorld(NM_DedicatedServer) };
+	if (!ServerWorld) { return nullptr; }
+
+	// The test session has a single client
+	for (FConstPlayerControllerIterator It = ServerWorld->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController{ It->Get() };
+		if (PlayerController && PlayerController->GetPawn()) { return PlayerController->GetPawn(); }
+	}
+
+	return nullptr;
+}
+
+void DefianceTests::SetPacketSimulation(int32 PktLag, int32 PktLoss)
+{
+#if DO_ENABLE_NET_TEST
+	// Both ends delay their outgoing packets, so each gets half of the round trip
+	FPacketSimulationSettings Settings;
+	Settings.PktLag = PktLag / 2;
+	Settings.PktLoss = PktLoss;
+
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UNetDriver* NetDriver{ (Context.WorldType == EWorldType::PIE && Context.World()) ? Context.World()->GetNetDriver() : nullptr };
+		if (NetDriver) { NetDriver->SetPacketSimulationSettings(Settings); }
+	}
+#endif
+}
+
+void DefianceTests::QueueStartNetPIE(FAutomationTestBase* Test, const FString& MapName)
+{
+	TSharedRef<double> StartTime{ MakeShared<double>(0.0) };
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([MapName, StartTime]()
+	{
+		FEditorFileUtils::LoadMap(MapName, false, false);
+
+		ULevelEditorPlaySettings* PlaySettings{ NewObject<ULevelEditorPlaySettings>() };
+		PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_Client);
+		PlaySettings->SetPlayNumberOfClients(1);
+		PlaySettings->SetRunUnderOneProcess(true);
+
+		FRequestPlaySessionParams Params;
+		Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+		Params.EditorPlaySettings = PlaySettings;
+		GEditor->RequestPlaySession(Params);
+
+		*StartTime = FPlatformTime::Seconds();
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Test, StartTime]()
+	{
+		if (FindClientPawn() && FindServerPawn()) { return true; }
+
+		if (FPlatformTime::Seconds() - *StartTime > PIEStartTimeout)
+		{
+			Test->AddError(TEXT("The PIE session did not spawn the client's pawn in time."));
+			return true;
+		}
+		return false;
+	}));
+}
+
+void DefianceTests::QueueEndPIE()
+{
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]()
+	{
+		if (GEditor->IsPlaySessionInProgress()) { GEditor->RequestEndPlayMap(); }
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([]()
+	{
+		return !GEditor->IsPlaySessionInProgress() && GEditor->PlayWorld == nullptr;
+	}));
+}
+
+
+bool FRunPawnScriptCommand::Update()
+{
+	APawn* Pawn{ DefianceTests::FindClientPawn() };
+	if (!Pawn)
+	{
+		Test->AddError(TEXT("FRunPawnScriptCommand [Update]: The PIE client has no pawn."));
+		return true;
+	}
+
+	const double Time{ GetCurrentRunTime() };
+	Script(Pawn, PreviousTime, Time);
+	PreviousTime = Time;
+
+	return Time >= Duration;
+}
+
+#endif
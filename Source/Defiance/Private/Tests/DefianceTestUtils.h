@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+class APawn;
+class UWorld;
+
+
+namespace DefianceTests
+{
+	/** Map the network tests play in */
+	inline const TCHAR* const NetTestMap{ TEXT("/Game/ThirdPerson/Maps/ThirdPersonMap") };
+
+	/** Returns the PIE world running with the given net mode, if there is one */
+	UWorld* FindPIEWorld(ENetMode NetMode);
+
+	/** Returns the pawn of the local player of the PIE client */
+	APawn* FindClientPawn();
+
+	/** Returns the server's copy of the client's pawn */
+	APawn* FindServerPawn();
+
+	/** Applies PktLag (round trip, ms) and PktLoss (%) emulation to the net drivers of every PIE world */
+	void SetPacketSimulation(int32 PktLag, int32 PktLoss);
+
+	/** Queues the commands that open the map, start a PIE client on a dedicated server and wait for the client's pawn */
+	void QueueStartNetPIE(FAutomationTestBase* Test, const FString& MapName = NetTestMap);
+
+	/** Queues the commands that end the PIE session and wait for it to be torn down */
+	void QueueEndPIE();
+
+	/** Called every frame of a script with the client's pawn and the times of the previous and this frame, in seconds since the script started */
+	using FPawnScript = TFunction<void(APawn* Pawn, double PreviousTime, double Time)>;
+}
+
+
+/** Runs a script on the PIE client's pawn every frame for Duration seconds */
+class FRunPawnScriptCommand : public IAutomationLatentCommand
+{
+public:
+	FRunPawnScriptCommand(FAutomationTestBase* InTest, DefianceTests::FPawnScript InScript, double InDuration)
+		: Test(InTest), Script(MoveTemp(InScript)), Duration(InDuration)
+	{
+	}
+
+	virtual bool Update() override;
+
+private:
+	FAutomationTestBase* Test;
+	DefianceTests::FPawnScript Script;
+	double Duration;
+	double PreviousTime{ 0.0 };
+};
+
+#endif
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/DefianceTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationCommon.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "EnhancedInputSubsystems.h"
+#include "HAL/FileManager.h"
+#include "Debug/InputReplaySubsystem.h"
+#include "MyInputConfigData.h"
+
+
+namespace DefianceTests
+{
+	/** Name of the recording the test writes and plays back */
+	inline const TCHAR* const ReplayTestName{ TEXT("AutomationInputReplay") };
+
+	/** Seconds of input recorded */
+	constexpr double ReplayRecordDuration{ 6.0 };
+
+	/** Seconds the replay may take before the test gives up on it */
+	constexpr double ReplayTimeout{ 30.0 };
+
+	/** Distance between where the recording and the replay end that still counts as the same run */
+	constexpr double ReplayTolerance{ 50.0 };
+
+	/** Distance the recorded run has to cover, so standing still does not pass as a deterministic replay */
+	constexpr double ReplayMinTravel{ 300.0 };
+
+	/** Injects a move input that runs the pawn in a wide S, plus a sprint toggle, through Enhanced Input */
+	static void RunRecordedInput(const UMyInputConfigData* InputConfig, APawn* Pawn, double PreviousTime, double Time)
+	{
+		const APlayerController* PlayerController{ Pawn->GetController<APlayerController>() };
+		UEnhancedInputLocalPlayerSubsystem* InputSubsystem{ PlayerController ? ULocalPlayer::GetSubsystem<UEnhancedInputLocalPlayerSubsystem>(PlayerController->GetLocalPlayer()) : nullptr };
+		if (!InputSubsystem) { return; }
+
+		const FVector Move{ FMath::Sin(Time), 1.0, 0.0 };
+		InputSubsystem->InjectInputForAction(InputConfig->InputMove, FInputActionValue(EInputActionValueType::Axis2D, Move), {}, {});
+
+		if (PreviousTime < 2.0 && Time >= 2.0)
+		{
+			InputSubsystem->InjectInputForAction(InputConfig->InputSprint, FInputActionValue(true), {}, {});
+		}
+	}
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInputReplayTest, "Defiance.Debug.InputReplay", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+bool FInputReplayTest::RunTest(const FString& Parameters)
+{
+	UMyInputConfigData* InputConfig{ LoadObject<UMyInputConfigData>(nullptr, UInputReplaySubsystem::DefaultInputConfigPath) };
+	if (!TestNotNull(TEXT("Default input config"), InputConfig)) { return false; }
+
+	struct FReplayRun
+	{
+		FTransform StartTransform;
+		FVector RecordedEnd{ FVector::ZeroVector };
+		double ReplayStartTime{ 0.0 };
+	};
+	TSharedRef<FReplayRun> Run{ MakeShared<FReplayRun>() };
+
+	DefianceTests::QueueStartNetPIE(this);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, InputConfig, Run]()
+	{
+		APawn* ServerPawn{ DefianceTests::FindServerPawn() };
+		APawn* ClientPawn{ DefianceTests::FindClientPawn() };
+		UInputReplaySubsystem* Replay{ UInputReplaySubsystem::Get(ClientPawn) };
+		if (!ServerPawn || !Replay) { return true; }
+
+		Run->StartTransform = ServerPawn->GetActorTransform();
+		TestTrue(TEXT("Recording starts"), Replay->StartRecording(DefianceTests::ReplayTestName, InputConfig));
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FRunPawnScriptCommand(this, [InputConfig](APawn* Pawn, double PreviousTime, double Time)
+	{
+		DefianceTests::RunRecordedInput(InputConfig, Pawn, PreviousTime, Time);
+	}, DefianceTests::ReplayRecordDuration));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]()
+	{
+		APawn* ServerPawn{ DefianceTests::FindServerPawn() };
+		APawn* ClientPawn{ DefianceTests::FindClientPawn() };
+		UInputReplaySubsystem* Replay{ UInputReplaySubsystem::Get(ClientPawn) };
+		if (!ServerPawn || !Replay) { return true; }
+
+		Replay->StopRecording();
+		Run->RecordedEnd = ServerPawn->GetActorLocation();
+
+		const FString FilePath{ UInputReplaySubsystem::GetReplayFilePath(DefianceTests::ReplayTestName) };
+		TestTrue(TEXT("The recording was written"), IFileManager::Get().FileSize(*FilePath) > 0);
+		TestTrue(TEXT("The recorded run covers some ground"), FVector::Dist2D(Run->StartTransform.GetLocation(), Run->RecordedEnd) > DefianceTests::ReplayMinTravel);
+
+		// The replay puts the client's pawn back where the recording started; the server's copy has to follow or the
+		// first moves would be corrected
+		ServerPawn->SetActorTransform(Run->StartTransform, false, nullptr, ETeleportType::ResetPhysics);
+		TestTrue(TEXT("Replay starts"), Replay->StartReplay(DefianceTests::ReplayTestName));
+		Run->ReplayStartTime = FPlatformTime::Seconds();
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Run]()
+	{
+		APawn* ServerPawn{ DefianceTests::FindServerPawn() };
+		const UInputReplaySubsystem* Replay{ UInputReplaySubsystem::Get(DefianceTests::FindClientPawn()) };
+		if (!ServerPawn || !Replay) { return true; }
+
+		if (Replay->IsReplaying())
+		{
+			if (FPlatformTime::Seconds() - Run->ReplayStartTime < DefianceTests::ReplayTimeout) { return false; }
+
+			AddError(TEXT("The replay did not finish in time."));
+			return true;
+		}
+
+		const double EndError{ FVector::Dist(ServerPawn->GetActorLocation(), Run->RecordedEnd) };
+		AddInfo(FString::Printf(TEXT("Replay ended %.1f cm from the recording."), EndError));
+		TestTrue(TEXT("The replay ends where the recording ended"), EndError <= DefianceTests::ReplayTolerance);
+		return true;
+	}));
+
+	DefianceTests::QueueEndPIE();
+
+	return true;
+}
+
+#endif
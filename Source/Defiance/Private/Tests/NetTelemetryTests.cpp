@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "Tests/DefianceTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationCommon.h"
+#include "GameFramework/Pawn.h"
+#include "Characters/CommonActionsComponent.h"
+#include "Characters/GrapplingHookComponent.h"
+#include "Combat/LockOnComponent.h"
+#include "Network/NetTelemetrySubsystem.h"
+
+
+namespace DefianceTests
+{
+	struct FPacketPreset
+	{
+		int32 PktLag;
+		int32 PktLoss;
+	};
+
+	/** Network conditions the action sequence is played under */
+	constexpr FPacketPreset PacketPresets[]
+	{
+		{ 50, 0 },
+		{ 150, 0 },
+		{ 150, 2 },
+		{ 250, 5 },
+	};
+
+	/** Seconds the action sequence runs for */
+	constexpr double ActionSequenceDuration{ 40.0 };
+
+	/** Indicates the script just crossed the given time */
+	static bool Crossed(double PreviousTime, double Time, double At) { return PreviousTime < At && Time >= At; }
+
+	/** Runs, turns and fires every replicated action of the player in turn, twice over */
+	static void RunActionSequence(APawn* Pawn, double PreviousTime, double Time)
+	{
+		// Run in a slow circle so the actions happen at speed and in changing directions
+		const double Heading{ Time * 0.5 };
+		Pawn->AddMovementInput(FVector(FMath::Cos(Heading), FMath::Sin(Heading), 0.0));
+
+		UCommonActionsComponent* CommonActions{ Pawn->FindComponentByClass<UCommonActionsComponent>() };
+		ULockOnComponent* LockOn{ Pawn->FindComponentByClass<ULockOnComponent>() };
+		UGrapplingHookComponent* GrapplingHook{ Pawn->FindComponentByClass<UGrapplingHookComponent>() };
+
+		const double SequenceTime{ FMath::Fmod(Time, ActionSequenceDuration * 0.5) };
+		const double PreviousSequenceTime{ SequenceTime - (Time - PreviousTime) };
+
+		if (CommonActions)
+		{
+			if (Crossed(PreviousSequenceTime, SequenceTime, 1.0) || Crossed(PreviousSequenceTime, SequenceTime, 5.0)) { CommonActions->ToggleSprint(); }
+			if (Crossed(PreviousSequenceTime, SequenceTime, 6.0) || Crossed(PreviousSequenceTime, SequenceTime, 8.0)) { CommonActions->ToggleCrouch(); }
+			if (Crossed(PreviousSequenceTime, SequenceTime, 9.0) || Crossed(PreviousSequenceTime, SequenceTime, 10.5)) { CommonActions->DodgeRoll(); }
+			if (Crossed(PreviousSequenceTime, SequenceTime, 12.0)) { CommonActions->Jump(); }
+			if (Crossed(PreviousSequenceTime, SequenceTime, 12.5)) { CommonActions->StopJumping(); }
+		}
+
+		if (LockOn && (Crossed(PreviousSequenceTime, SequenceTime, 13.0) || Crossed(PreviousSequenceTime, SequenceTime, 15.0))) { LockOn->ToggleLockOn(); }
+
+		if (GrapplingHook && Crossed(PreviousSequenceTime, SequenceTime, 17.0)) { GrapplingHook->LaunchOnGrapple(); }
+	}
+}
+
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FCorrectionBudgetTest, "Defiance.Network.CorrectionBudget", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+void FCorrectionBudgetTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const DefianceTests::FPacketPreset& Preset : DefianceTests::PacketPresets)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("Lag%d_Loss%d"), Preset.PktLag, Preset.PktLoss));
+		OutTestCommands.Add(FString::Printf(TEXT("%d %d"), Preset.PktLag, Preset.PktLoss));
+	}
+}
+
+bool FCorrectionBudgetTest::RunTest(const FString& Parameters)
+{
+	TArray<FString> Values;
+	Parameters.ParseIntoArrayWS(Values);
+	if (!TestEqual(TEXT("Preset parameter count"), Values.Num(), 2)) { return false; }
+
+	const int32 PktLag{ FCString::Atoi(*Values[0]) };
+	const int32 PktLoss{ FCString::Atoi(*Values[1]) };
+
+	DefianceTests::QueueStartNetPIE(this);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([PktLag, PktLoss]()
+	{
+		DefianceTests::SetPacketSimulation(PktLag, PktLoss);
+
+		APawn* Pawn{ DefianceTests::FindClientPawn() };
+		if (UNetTelemetrySubsystem* Telemetry{ Pawn ? UNetTelemetrySubsystem::Get(Pawn) : nullptr }) { Telemetry->ResetStats(); }
+		return true;
+	}));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FRunPawnScriptCommand(this, &DefianceTests::RunActionSequence, DefianceTests::ActionSequenceDuration));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this]()
+	{
+		APawn* Pawn{ DefianceTests::FindClientPawn() };
+		const UNetTelemetrySubsystem* Telemetry{ Pawn ? UNetTelemetrySubsystem::Get(Pawn) : nullptr };
+		if (!Telemetry)
+		{
+			AddError(TEXT("The PIE client has no telemetry subsystem."));
+			return true;
+		}
+
+		Telemetry->DumpStats();
+		AddInfo(FString::Printf(TEXT("%.1f corrections per minute"), Telemetry->GetCorrectionsPerMinute()));
+		TestTrue(TEXT("Corrections per minute are within defiance.NetTelemetry.CorrectionBudget"), Telemetry->IsWithinCorrectionBudget());
+
+		DefianceTests::SetPacketSimulation(0, 0);
+		return true;
+	}));
+
+	DefianceTests::QueueEndPIE();
+
+	return true;
+}
+
+#endif
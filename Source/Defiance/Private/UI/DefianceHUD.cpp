@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/DefianceHUD.h"
+#include "UI/IndicatorLayerWidget.h"
+#include "GameFramework/PlayerController.h"
+
+
+ADefianceHUD::ADefianceHUD()
+{
+	IndicatorLayerClass = UIndicatorLayerWidget::StaticClass();
+}
+
+// Called when the game starts or when spawned
+void ADefianceHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!IsValid(PlayerOwner) || !PlayerOwner->IsLocalController() || !IndicatorLayerClass) { return; }
+
+	IndicatorLayer = CreateWidget<UIndicatorLayerWidget>(PlayerOwner, IndicatorLayerClass);
+	if (IsValid(IndicatorLayer))
+	{
+		IndicatorLayer->AddToViewport();
+	}
+}
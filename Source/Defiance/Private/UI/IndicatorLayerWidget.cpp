@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/IndicatorLayerWidget.h"
+#include "UI/TargetIndicatorWidget.h"
+#include "UI/TargetIndicatorSubsystem.h"
+#include "Blueprint/WidgetTree.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Components/InvalidationBox.h"
+#include "Components/CanvasPanel.h"
+#include "Components/CanvasPanelSlot.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "SceneView.h"
+
+
+UIndicatorLayerWidget::UIndicatorLayerWidget(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	LockOnIndicatorClass = UTargetIndicatorWidget::StaticClass();
+	GrappleIndicatorClass = UTargetIndicatorWidget::StaticClass();
+}
+
+void UIndicatorLayerWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	// Build the layer in code when no designer layout provides it
+	if (!IndicatorCanvas)
+	{
+		IndicatorBox = WidgetTree->ConstructWidget<UInvalidationBox>(UInvalidationBox::StaticClass(), TEXT("IndicatorBox"));
+		IndicatorCanvas = WidgetTree->ConstructWidget<UCanvasPanel>(UCanvasPanel::StaticClass(), TEXT("IndicatorCanvas"));
+		IndicatorBox->SetContent(IndicatorCanvas);
+		WidgetTree->RootWidget = IndicatorBox;
+	}
+
+	SetVisibility(ESlateVisibility::HitTestInvisible);
+
+	FillPool(LockOnIndicatorClass, LockOnSlots);
+	FillPool(GrappleIndicatorClass, GrappleSlots);
+}
+
+void UIndicatorLayerWidget::FillPool(TSubclassOf<UTargetIndicatorWidget> IndicatorClass, TArray<FIndicatorSlot>& OutSlots)
+{
+	if (!IndicatorClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UIndicatorLayerWidget [FillPool]: No indicator class set; that kind of indicator will not be drawn."))
+		return;
+	}
+
+	for (int32 i = 0; i < PoolSize; i++)
+	{
+		UTargetIndicatorWidget* Indicator{ CreateWidget<UTargetIndicatorWidget>(this, IndicatorClass) };
+		if (!IsValid(Indicator)) { continue; }
+
+		UCanvasPanelSlot* CanvasSlot{ IndicatorCanvas->AddChildToCanvas(Indicator) };
+		CanvasSlot->SetAutoSize(true);
+		CanvasSlot->SetAlignment(FVector2D(0.5, 0.5));
+		Indicator->SetVisibility(ESlateVisibility::Collapsed);
+
+		PooledWidgets.Add(Indicator);
+		OutSlots.Add(FIndicatorSlot{ Indicator });
+	}
+}
+
+
+
+void UIndicatorLayerWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+{
+	Super::NativeTick(MyGeometry, InDeltaTime);
+
+	const UTargetIndicatorSubsystem* Indicators{ UTargetIndicatorSubsystem::Get(this) };
+	APlayerController* PlayerController{ GetOwningPlayer() };
+	const ULocalPlayer* LocalPlayer{ IsValid(PlayerController) ? PlayerController->GetLocalPlayer() : nullptr };
+	if (!Indicators || !LocalPlayer || !LocalPlayer->ViewportClient) { return; }
+
+	// Gather everything to draw this frame
+	TArray<FIndicatorRequest, TInlineAllocator<4>> Requests;
+	if (const AActor* Target{ Indicators->GetLockOnTarget() })
+	{
+		Requests.Add(FIndicatorRequest{ Target->GetActorLocation() + LockOnIndicatorOffset, false, true });
+	}
+	if (Indicators->GetActiveGrapple())
+	{
+		const FVector GrappleLocation{ Indicators->GetActiveGrappleLocation() };
+		const APawn* Pawn{ PlayerController->GetPawn() };
+		const bool bInRange{ IsValid(Pawn) && FVector::Dist(Pawn->GetActorLocation(), GrappleLocation) <= Indicators->GrappleInteractRange };
+		Requests.Add(FIndicatorRequest{ GrappleLocation, true, bInRange });
+	}
+
+	// Nothing to draw and nothing drawn since the last change
+	if (Requests.Num() == 0)
+	{
+		if (HiddenRevision != Indicators->GetRevision())
+		{
+			HideAll();
+			HiddenRevision = Indicators->GetRevision();
+		}
+		return;
+	}
+	HiddenRevision = MAX_uint32;
+
+	// Project every request with the same view projection, computed once
+	FSceneViewProjectionData ProjectionData;
+	if (!LocalPlayer->GetProjectionData(LocalPlayer->ViewportClient->Viewport, ProjectionData))
+	{
+		HideAll();
+		return;
+	}
+
+	const FMatrix ViewProjection{ ProjectionData.ComputeViewProjectionMatrix() };
+	const FIntRect ViewRect{ ProjectionData.GetConstrainedViewRect() };
+	const float ViewportScale{ FMath::Max(UWidgetLayoutLibrary::GetViewportScale(this), UE_KINDA_SMALL_NUMBER) };
+
+	int32 UsedLockOnSlots{ 0 };
+	int32 UsedGrappleSlots{ 0 };
+	for (const FIndicatorRequest& Request : Requests)
+	{
+		TArray<FIndicatorSlot>& Slots{ Request.bIsGrapple ? GrappleSlots : LockOnSlots };
+		int32& UsedSlots{ Request.bIsGrapple ? UsedGrappleSlots : UsedLockOnSlots };
+		if (!Slots.IsValidIndex(UsedSlots)) { continue; }
+
+		FVector2D PixelPosition;
+		const bool bOnScreen{ FSceneView::ProjectWorldToScreen(Request.WorldLocation, ViewRect, ViewProjection, PixelPosition)
+			&& ViewRect.Contains(FIntPoint(FMath::FloorToInt(PixelPosition.X), FMath::FloorToInt(PixelPosition.Y))) };
+
+		UpdateSlot(Slots[UsedSlots++], bOnScreen, (PixelPosition - FVector2D(ViewRect.Min)) / ViewportScale, Request.bInRange);
+	}
+
+	// Hide the indicators nothing was assigned to
+	for (int32 i = UsedLockOnSlots; i < LockOnSlots.Num(); i++) { UpdateSlot(LockOnSlots[i], false, FVector2D::ZeroVector, false); }
+	for (int32 i = UsedGrappleSlots; i < GrappleSlots.Num(); i++) { UpdateSlot(GrappleSlots[i], false, FVector2D::ZeroVector, false); }
+}
+
+void UIndicatorLayerWidget::UpdateSlot(FIndicatorSlot& IndicatorSlot, bool bVisible, const FVector2D& ScreenPosition, bool bInRange)
+{
+	// Only touch the widget when something changed, otherwise the invalidation box keeps its cached paint
+	if (IndicatorSlot.bVisible != bVisible)
+	{
+		IndicatorSlot.bVisible = bVisible;
+		IndicatorSlot.Widget->SetVisibility(bVisible ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Collapsed);
+	}
+
+	if (!bVisible) { return; }
+
+	IndicatorSlot.Widget->SetInRange(bInRange);
+
+	if (FVector2D::DistSquared(IndicatorSlot.ScreenPosition, ScreenPosition) > FMath::Square(MoveThreshold))
+	{
+		IndicatorSlot.ScreenPosition = ScreenPosition;
+		IndicatorSlot.Widget->SetRenderTranslation(ScreenPosition);
+	}
+}
+
+void UIndicatorLayerWidget::HideAll()
+{
+	for (FIndicatorSlot& IndicatorSlot : LockOnSlots) { UpdateSlot(IndicatorSlot, false, FVector2D::ZeroVector, false); }
+	for (FIndicatorSlot& IndicatorSlot : GrappleSlots) { UpdateSlot(IndicatorSlot, false, FVector2D::ZeroVector, false); }
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/TargetIndicatorSubsystem.h"
+#include "Interfaces/Grapple.h"
+#include "Engine/World.h"
+
+
+UTargetIndicatorSubsystem* UTargetIndicatorSubsystem::Get(const UObject* WorldContextObject)
+{
+	if (!IsValid(WorldContextObject)) { return nullptr; }
+
+	UWorld* World{ WorldContextObject->GetWorld() };
+	return IsValid(World) ? World->GetSubsystem<UTargetIndicatorSubsystem>() : nullptr;
+}
+
+
+
+void UTargetIndicatorSubsystem::SetLockOnTarget(AActor* Target)
+{
+	if (LockOnTarget == Target) { return; }
+
+	LockOnTarget = Target;
+	Revision++;
+}
+
+void UTargetIndicatorSubsystem::ClearLockOnTarget(const AActor* Target)
+{
+	if (LockOnTarget != Target) { return; }
+
+	LockOnTarget = nullptr;
+	Revision++;
+}
+
+void UTargetIndicatorSubsystem::SetActiveGrapple(AActor* Grapple, float InteractRange, float DetectionRange, int32 Index)
+{
+	if (ActiveGrapple == Grapple && ActiveGrappleIndex == Index && GrappleInteractRange == InteractRange && GrappleDetectionRange == DetectionRange) { return; }
+
+	ActiveGrapple = Grapple;
+	ActiveGrappleIndex = Index;
+	GrappleInteractRange = InteractRange;
+	GrappleDetectionRange = DetectionRange;
+	Revision++;
+}
+
+void UTargetIndicatorSubsystem::ClearActiveGrapple(const AActor* Grapple, int32 Index)
+{
+	if (ActiveGrapple != Grapple || ActiveGrappleIndex != Index) { return; }
+
+	ActiveGrapple = nullptr;
+	ActiveGrappleIndex = INDEX_NONE;
+	Revision++;
+}
+
+FVector UTargetIndicatorSubsystem::GetActiveGrappleLocation() const
+{
+	const AActor* Grapple{ ActiveGrapple.Get() };
+	if (!Grapple) { return FVector::ZeroVector; }
+
+	const IGrapple* NativeGrapple{ Cast<IGrapple>(Grapple) };
+	return NativeGrapple ? NativeGrapple->GetAnchorLocation(ActiveGrappleIndex) : Grapple->GetActorLocation();
+}
@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "UI/TargetIndicatorWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/Image.h"
+#include "Components/SizeBox.h"
+#include "Engine/Texture2D.h"
+
+
+void UTargetIndicatorWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	ActiveColor = OutOfRangeColor;
+
+	// Build the marker in code when no designer layout provides one
+	if (!WidgetTree->RootWidget)
+	{
+		USizeBox* SizeBox{ WidgetTree->ConstructWidget<USizeBox>(USizeBox::StaticClass(), TEXT("IndicatorSize")) };
+		SizeBox->SetWidthOverride(IndicatorSize.X);
+		SizeBox->SetHeightOverride(IndicatorSize.Y);
+
+		IndicatorImage = WidgetTree->ConstructWidget<UImage>(UImage::StaticClass(), TEXT("IndicatorImage"));
+		if (UTexture2D* Texture{ IndicatorTexture.LoadSynchronous() }) { IndicatorImage->SetBrushFromTexture(Texture); }
+		SizeBox->SetContent(IndicatorImage);
+
+		WidgetTree->RootWidget = SizeBox;
+	}
+
+	if (IndicatorImage) { IndicatorImage->SetColorAndOpacity(FLinearColor(ActiveColor)); }
+}
+
+void UTargetIndicatorWidget::SetInRange(bool bInRange)
+{
+	if (bIsInRange == bInRange) { return; }
+
+	bIsInRange = bInRange;
+	ActiveColor = bInRange ? InRangeColor : OutOfRangeColor;
+	if (IndicatorImage) { IndicatorImage->SetColorAndOpacity(FLinearColor(ActiveColor)); }
+	OnInRangeChanged(bInRange);
+}
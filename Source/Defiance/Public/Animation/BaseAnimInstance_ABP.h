@@ -4,9 +4,45 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "Types.h"
+#include "WorldCollision.h"
 #include "BaseAnimInstance_ABP.generated.h"
 
+
+/**
+ * Applies the foot placement of UBaseAnimInstance_ABP to the pose the anim graph evaluated: the pelvis is lowered and
+ * each leg is solved with two bone IK onto its ground, so the graph itself needs no IK nodes reading the offsets.
+ */
+struct FBaseAnimInstanceProxy : public FAnimInstanceProxy
+{
+	FBaseAnimInstanceProxy() = default;
+	explicit FBaseAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+	/** Copied from the anim instance at the end of every update; offsets and rotations are in world space */
+	float PelvisOffset{ 0.0f };
+	float FootOffsets[2]{ 0.0f, 0.0f };
+	FRotator FootRotations[2]{ FRotator::ZeroRotator, FRotator::ZeroRotator };
+	float FootPlacementAlpha{ 0.0f };
+
+	FName PelvisBone;
+	FName FootBones[2];
+
+protected:
+	virtual bool Evaluate_WithRoot(FPoseContext& Output, FAnimNode_Base* InRootNode) override;
+
+private:
+	/** Compact pose indices of the pelvis and of the thigh, calf and foot of each leg; INDEX_NONE when not in the LOD */
+	int32 PelvisIndex{ INDEX_NONE };
+	int32 LegIndices[2][3]{ { INDEX_NONE, INDEX_NONE, INDEX_NONE }, { INDEX_NONE, INDEX_NONE, INDEX_NONE } };
+	uint16 CachedBonesSerial{ MAX_uint16 };
+
+	void CacheBones(const FBoneContainer& RequiredBones);
+
+	void ApplyFootPlacement(FPoseContext& Output);
+};
+
+
 /**
  * 
  */
@@ -15,6 +51,43 @@ class DEFIANCE_API UBaseAnimInstance_ABP : public UAnimInstance
 {
 	GENERATED_BODY()
 
+	/** Game thread state of the ground trace of one foot */
+	struct FFootTrace
+	{
+		/** Foot location last frame, to tell a planted foot from a moving one */
+		FVector LastFootLocation{ FVector::ZeroVector };
+
+		/** Foot location the ground below was traced for */
+		FVector TracedLocation{ FVector::ZeroVector };
+
+		bool bHasGround{ false };
+		float GroundZ{ 0.0f };
+		FVector GroundNormal{ FVector::UpVector };
+
+		FTraceHandle Trace;
+		bool bTracePending{ false };
+	};
+
+	/** Left then right */
+	FFootTrace FootTraces[2];
+	FTraceDelegate FootTraceDelegate;
+
+	/** Targets written on the game thread and eased to in NativeThreadSafeUpdateAnimation */
+	float TargetFootOffsets[2]{ 0.0f, 0.0f };
+	FRotator TargetFootRotations[2]{ FRotator::ZeroRotator, FRotator::ZeroRotator };
+	float TargetFootPlacementAlpha{ 0.0f };
+
+	/** Significance of the owner, set by USignificanceSubsystem when it changes */
+	ESignificanceTier SignificanceTier{ ESignificanceTier::High };
+
+	/** Issues the async ground traces of the feet that need one and turns the known ground into foot targets */
+	void UpdateFootTraces(float DeltaTimeX);
+
+	void HandleFootTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+
+protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override { return new FBaseAnimInstanceProxy(this); }
 
 public:
 	/** Called at start of play */
@@ -23,6 +96,9 @@ public:
 	/** Called every frame */
 	virtual void NativeUpdateAnimation(float DeltaTimeX) override;
 
+	/** Called every frame on a worker thread, after NativeUpdateAnimation */
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+
 
 
 	/** The owning ADefianceCharacter of this Anim BP */
@@ -115,6 +191,67 @@ public:
 	void UpdateLeanFactor();
 
 
+	/*-------------------------------------------FOOT PLACEMENT-------------------------------------------*/
+	// Offsets are in world space, relative to the bottom of the mesh, and are applied by FBaseAnimInstanceProxy after
+	// the anim graph has been evaluated
+
+	/** Vertical offset of the left foot to reach the ground below it */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+	float LeftFootOffset{ 0.0f };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+	float RightFootOffset{ 0.0f };
+
+	/** Lowers the pelvis so the foot on the lower ground can reach it */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+	float PelvisOffset{ 0.0f };
+
+	/** Rotation aligning the left foot to the ground normal */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+	FRotator LeftFootRotation{ FRotator::ZeroRotator };
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+	FRotator RightFootRotation{ FRotator::ZeroRotator };
+
+	/** Blend weight of the foot placement; goes to 0 in the air and for low-significance characters */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Foot Placement")
+	float FootPlacementAlpha{ 0.0f };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	FName PelvisBone{ TEXT("pelvis") };
+
+	/** Foot bones; their parent and grandparent are the calf and thigh the leg IK bends */
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	FName LeftFootBone{ TEXT("foot_l") };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	FName RightFootBone{ TEXT("foot_r") };
+
+	/** How far above and below the bottom of the mesh the ground is searched for */
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	float FootTraceUp{ 50.0f };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	float FootTraceDown{ 75.0f };
+
+	/** Largest offset a foot may be moved by */
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	float MaxFootOffset{ 50.0f };
+
+	/** Feet moving slower than this are planted and keep the ground found under them */
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	float PlantedFootSpeed{ 20.0f };
+
+	/** Distance a planted foot may slide from where its ground was traced before it is traced again */
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	float PlantedFootTolerance{ 5.0f };
+
+	UPROPERTY(EditDefaultsOnly, Category = "Foot Placement")
+	float FootInterpSpeed{ 15.0f };
+
+	void SetSignificanceTier(ESignificanceTier NewTier) { SignificanceTier = NewTier; }
+
+
 	/** Returns true if the angle is within the specified range with the buffer tolerance */
 	bool AngleInRange(float Angle, float MinAngle, float MaxAngle, float Buffer, bool bIncreaseBuffer);
 
@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "MeleeAttackNotifyState.generated.h"
+
+
+/**
+ * Opens the attack window of the owner's UMeleeComponent for the duration of the notify. Placed on the frames of an
+ * attack montage where the swing can hit; the window also closes if the montage is interrupted.
+ */
+UCLASS(meta = (DisplayName = "Melee Attack Window"))
+class DEFIANCE_API UMeleeAttackNotifyState : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration, const FAnimNotifyEventReference& EventReference) override;
+
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, const FAnimNotifyEventReference& EventReference) override;
+
+	virtual FString GetNotifyName_Implementation() const override;
+};
@@ -35,4 +35,10 @@ public:
 	// Returns the EDetailedDirection based on the given angle
 	UFUNCTION(BlueprintCallable)
 	static EDetailedDirection GetDetailedDirectionFromAngle(float Angle);
+
+	// Returns true if a Blueprint overrides the given event of the object, meaning it has to be called through the Blueprint VM
+	static bool IsEventOverriddenInBlueprint(const UObject* Object, FName EventName);
+
+	// Keeps the widget components of the actor from creating and drawing their widgets; call before the components begin play
+	static void DisableWidgetComponents(AActor* Actor);
 };
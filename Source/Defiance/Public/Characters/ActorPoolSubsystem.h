@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorPoolSubsystem.generated.h"
+
+
+USTRUCT()
+struct FActorPoolBucket
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> FreeActors;
+};
+
+
+/** What was ticking when an actor was pooled, so only that is switched back on */
+struct FPausedTicks
+{
+	bool bActorTicked{ false };
+	TArray<TWeakObjectPtr<UActorComponent>> Components;
+};
+
+
+/** Timings of UActorPoolSubsystem::Benchmark, in milliseconds per wave */
+struct FActorPoolBenchmarkResult
+{
+	double SpawnAverage{ 0.0 };
+	double SpawnWorst{ 0.0 };
+	double PoolAverage{ 0.0 };
+	double PoolWorst{ 0.0 };
+};
+
+
+/**
+ * Keeps deactivated actors around so wave spawns reuse them instead of paying for construction and BeginPlay.
+ * Pooled actors are hidden, stop ticking and colliding, and go dormant so they cost nothing on the network.
+ * Actors and components implementing IPoolable are told when they enter and leave the pool to reset their state.
+ */
+UCLASS()
+class DEFIANCE_API UActorPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FActorPoolBucket> Pools;
+
+	/** Ticks of the pooled actors; also tells which actors are in the pool */
+	TMap<TObjectKey<AActor>, FPausedTicks> PausedTicks;
+
+	/** Turns the actor off and adds it to the pool of its class */
+	void Deactivate(AActor* Actor);
+
+	/** Switches off the ticks of the actor and its components, adding them to what is switched back on when acquired */
+	void PauseTicks(AActor* Actor, FPausedTicks& OutPausedTicks) const;
+
+	/** BeginPlay registers the ticks of actors pooled before it again, so they are paused once more */
+	void HandleWorldBeginPlay();
+
+	FDelegateHandle WorldBeginPlayHandle;
+
+public:
+	/** Returns the actor pool subsystem of the world the object lives in */
+	static UActorPoolSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Where pooled actors are parked, far away from gameplay and relevancy checks */
+	FVector PoolLocation{ 0.0, 0.0, -100000.0 };
+
+	virtual void Deinitialize() override;
+
+	/** Spawns actors until the pool of the class holds at least Count of them */
+	void Prewarm(TSubclassOf<AActor> ActorClass, int32 Count);
+
+	/** Returns a pooled actor of the class placed at Transform, spawning a new one if the pool is empty */
+	AActor* Acquire(TSubclassOf<AActor> ActorClass, const FTransform& Transform);
+
+	template<typename T>
+	T* Acquire(TSubclassOf<T> ActorClass, const FTransform& Transform) { return Cast<T>(Acquire(TSubclassOf<AActor>(ActorClass.Get()), Transform)); }
+
+	/** Resets the actor and returns it to the pool; pawns lose their AI controller */
+	void Release(AActor* Actor);
+
+	/** Returns the number of actors of the class waiting in the pool */
+	int32 GetNumFree(TSubclassOf<AActor> ActorClass) const;
+
+	/**
+	 * Times waves spawned with SpawnActor against waves acquired from the pool, which is pre-warmed first. OnPoolWave
+	 * is called with every pooled wave, outside the timings, before it is released again.
+	 */
+	FActorPoolBenchmarkResult Benchmark(TSubclassOf<AActor> ActorClass, int32 Waves, int32 WaveSize, TFunctionRef<void(const TArray<AActor*>&)> OnPoolWave);
+
+	/** Returns where the actor at Index of a benchmark wave is placed */
+	static FTransform GetBenchmarkTransform(int32 Index);
+};
@@ -16,7 +16,7 @@ class DEFIANCE_API ABaseCharacter : public ACharacter, public IEnemy
 
 	/** Camera boom positioning the camera behind the character */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
-	class USpringArmComponent* CameraBoom;
+	class UDefianceSpringArmComponent* CameraBoom;
 
 	/** Follow camera */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
@@ -24,10 +24,7 @@ class DEFIANCE_API ABaseCharacter : public ACharacter, public IEnemy
 
 public:
 	// Sets default values for this character's properties
-	ABaseCharacter();
-
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
+	ABaseCharacter(const FObjectInitializer& ObjectInitializer);
 
 
 	// Property replication
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Types.h"
+#include "Environment/ClimbGraphSubsystem.h"
+#include "ClimbingComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(
+	FOnClimbTransitionSignature,
+	UClimbingComponent, OnClimbTransitionDelegate,
+	EClimbTransition, Transition
+);
+
+
+/**
+ * Lets a character grab, shimmy along and jump between the edges baked into the level's climb graphs.
+ * Targets are picked through graph queries and handed to UDefianceMovementComponent, which simulates the
+ * climbing movement mode identically on the owning client and the server.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class DEFIANCE_API UClimbingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	ACharacter* OwnerRef;
+
+	class UDefianceMovementComponent* MovementComp;
+
+	UClimbGraphSubsystem* ClimbGraph;
+
+	void HandleClimbTransition(EClimbTransition Transition);
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+
+public:	
+	// Sets default values for this component's properties
+	UClimbingComponent();
+
+	UPROPERTY(BlueprintAssignable)
+	FOnClimbTransitionSignature OnClimbTransitionDelegate;
+
+
+	UFUNCTION(BlueprintPure)
+	bool IsClimbing() const;
+
+	UFUNCTION(BlueprintPure)
+	EClimbStance GetClimbStance() const;
+
+	/** Grabs the nearest edge within reach of the hands */
+	UFUNCTION(BlueprintCallable)
+	bool TryGrab();
+
+	/** Moves along the current edge; positive values move towards the character's right */
+	UFUNCTION(BlueprintCallable)
+	void Shimmy(float AxisValue);
+
+	/** Climbs onto the top of the current edge if there is room */
+	UFUNCTION(BlueprintCallable)
+	void Ascend();
+
+	/** Lets go of the current edge */
+	UFUNCTION(BlueprintCallable)
+	void Descend();
+
+	/** Turns around on edges that can be held from both sides */
+	UFUNCTION(BlueprintCallable)
+	void Pivot();
+
+	/** Jumps to the best edge in the given world direction */
+	UFUNCTION(BlueprintCallable)
+	bool JumpToEdge(FVector Direction);
+
+	/** Starts swinging from the held high bar or rope, if the owner has a USwingComponent */
+	UFUNCTION(BlueprintCallable)
+	bool Swing();
+};
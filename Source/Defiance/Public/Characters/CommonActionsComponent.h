@@ -5,8 +5,12 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "Types.h"
+#include "Engine/StreamableManager.h"
+#include "Interfaces/Poolable.h"
 #include "CommonActionsComponent.generated.h"
 
+class UAnimMontage;
+
 DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(
 	FOnUpdatedMovementStanceSignature,
 	UCommonActionsComponent, OnUpdatedMovementStanceDelegate,
@@ -16,7 +20,7 @@ DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(
 
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
-class DEFIANCE_API UCommonActionsComponent : public UActorComponent
+class DEFIANCE_API UCommonActionsComponent : public UActorComponent, public IPoolable
 {
 	GENERATED_BODY()
 
@@ -26,7 +30,20 @@ class DEFIANCE_API UCommonActionsComponent : public UActorComponent
 
 	class UCharacterMovementComponent* MovementComp;
 
-	FVector CameraBoomLocation;
+	/** Eases to the crouch height; only owners with a UDefianceSpringArmComponent have one */
+	class UDefianceSpringArmComponent* CameraBoom;
+
+	/** Keeps the dodge montages resident once they have been streamed in */
+	TSharedPtr<FStreamableHandle> DodgeMontagesHandle;
+
+	/** Keeps the roll montages resident once they have been streamed in */
+	TSharedPtr<FStreamableHandle> RollMontagesHandle;
+
+	/** Starts streaming the dodge montages with high priority and the roll montages after them */
+	void RequestMontagesAsyncLoad();
+
+	/** Returns the montage for the given direction, loading it synchronously if streaming has not finished yet */
+	UAnimMontage* GetMontage(const TMap<EDetailedDirection, TSoftObjectPtr<UAnimMontage>>& Montages, EDetailedDirection DetailedDirection) const;
 
 
 protected:
@@ -38,9 +55,6 @@ public:
 	// Sets default values for this component's properties
 	UCommonActionsComponent();
 
-	// Called every frame
-	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
 
 	// Property replication
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
@@ -48,6 +62,9 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnUpdatedMovementStanceSignature OnUpdatedMovementStanceDelegate;
 
+	/** Stands the character back up at run speed with no action in progress */
+	virtual void OnReleasedToPool() override;
+
 
 	/*-------------------------------------------LOCOMOTION-------------------------------------------*/
 	/** Indicates whether the character should use directional movement */
@@ -152,11 +169,11 @@ public:
 
 	/** A collection of dodge animation montages mapped according to direction */
 	UPROPERTY(EditAnywhere, Category = "Movement|Dodge & Roll")
-	TMap<EDetailedDirection, UAnimMontage*> DodgeAnimMontage;
+	TMap<EDetailedDirection, TSoftObjectPtr<UAnimMontage>> DodgeAnimMontage;
 
 	/** A collection of roll animation montages mapped according to direction */
 	UPROPERTY(EditAnywhere, Category = "Movement|Dodge & Roll")
-	TMap<EDetailedDirection, UAnimMontage*> RollAnimMontage;
+	TMap<EDetailedDirection, TSoftObjectPtr<UAnimMontage>> RollAnimMontage;
 
 	UFUNCTION(BlueprintCallable)
 	void DodgeRoll();
@@ -164,6 +181,9 @@ public:
 	UFUNCTION(Server, Reliable, WithValidation)
 	void SR_Dodge(EDetailedDirection DetailedDirection);
 
+	/** Starts a dodge that was queued by SR_Dodge; returns false if the character cannot dodge right now */
+	bool ApplyDodge(EDetailedDirection DetailedDirection);
+
 	UFUNCTION(NetMulticast, Reliable)
 	void NM_PlayDodgeAnim(EDetailedDirection DetailedDirection);
 
@@ -173,6 +193,9 @@ public:
 	UFUNCTION(Server, Reliable, WithValidation)
 	void SR_Roll(EDetailedDirection DetailedDirection);
 
+	/** Starts a roll that was queued by SR_Roll; returns false if the character cannot roll right now */
+	bool ApplyRoll(EDetailedDirection DetailedDirection);
+
 	UFUNCTION(NetMulticast, Reliable)
 	void NM_PlayRollAnim(EDetailedDirection DetailedDirection);
 
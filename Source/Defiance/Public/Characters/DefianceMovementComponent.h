@@ -0,0 +1,261 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Types.h"
+#include "Environment/ClimbGraphSubsystem.h"
+#include "Characters/SwingComponent.h"
+#include "DefianceMovementComponent.generated.h"
+
+struct FClimbEdge;
+class UGrapplingHookComponent;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnClimbTransitionNative, EClimbTransition);
+
+
+/** Extra data sent with every move so the server can replay climbing, swinging and grapple launch requests */
+class DEFIANCE_API FDefianceNetworkMoveData : public FCharacterNetworkMoveData
+{
+public:
+	typedef FCharacterNetworkMoveData Super;
+
+	/** Edge requested by a grab or jump, packed as a FClimbEdgeHandle */
+	uint32 PackedClimbEdge{ FClimbEdgeHandle().Pack() };
+
+	EClimbTransition ClimbTransition{ EClimbTransition::None };
+
+	/** Swing started on this move; the anchor and type are only sent then */
+	bool bWantsToSwing{ false };
+
+	FVector SwingAnchor{ FVector::ZeroVector };
+
+	EClimbableType SwingType{ EClimbableType::Rope };
+
+	/** Grapple launch made on this move; the grapple and anchor are only sent then */
+	bool bWantsToLaunch{ false };
+
+	AActor* LaunchGrapple{ nullptr };
+
+	int32 LaunchGrappleIndex{ INDEX_NONE };
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+class DEFIANCE_API FDefianceNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+public:
+	FDefianceNetworkMoveDataContainer();
+
+	FDefianceNetworkMoveData MoveData[3];
+};
+
+
+/** Client move carrying the climbing, swinging and grapple launch requests made during it and the swing state it started from */
+class DEFIANCE_API FSavedMove_Defiance : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	bool bSavedWantsToGrab{ false };
+
+	EClimbTransition SavedClimbTransition{ EClimbTransition::None };
+
+	uint32 SavedPackedClimbEdge{ FClimbEdgeHandle().Pack() };
+
+	bool bSavedWantsToSwing{ false };
+
+	FVector SavedSwingAnchor{ FVector::ZeroVector };
+
+	EClimbableType SavedSwingType{ EClimbableType::Rope };
+
+	bool bSavedWantsToLaunch{ false };
+
+	TWeakObjectPtr<AActor> SavedLaunchGrapple;
+
+	int32 SavedLaunchGrappleIndex{ INDEX_NONE };
+
+	/** Indicates the move started while swinging; SavedSwingState is only set then */
+	bool bSavedSwinging{ false };
+
+	FSwingState SavedSwingState;
+
+	virtual void Clear() override;
+
+	virtual uint8 GetCompressedFlags() const override;
+
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+
+	virtual bool IsImportantMove(const FSavedMovePtr& LastAckedMove) const override;
+
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+
+	virtual void PrepMoveFor(ACharacter* C) override;
+};
+
+class DEFIANCE_API FNetworkPredictionData_Client_Defiance : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	FNetworkPredictionData_Client_Defiance(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
+
+/**
+ * Character movement component shared by all Defiance characters
+ */
+UCLASS()
+class DEFIANCE_API UDefianceMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+	FDefianceNetworkMoveDataContainer DefianceNetworkMoveDataContainer;
+
+	UPROPERTY()
+	UClimbGraphSubsystem* ClimbGraph;
+
+	UPROPERTY()
+	USwingComponent* SwingComponent;
+
+	UPROPERTY()
+	UGrapplingHookComponent* GrapplingHookComponent;
+
+public:
+	UDefianceMovementComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Called on the owning client when the server corrects its predicted position */
+	virtual void ClientAdjustPosition_Implementation(float TimeStamp, FVector NewLoc, FVector NewVel, UPrimitiveComponent* NewBase, FName NewBaseBoneName, bool bHasBase, bool bBaseRelativePosition, uint8 ServerMovementMode, TOptional<FRotator> OptionalRotation = TOptional<FRotator>()) override;
+
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+	/** Puts the swing back to where it was at the first unacknowledged move before the moves are replayed */
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+
+	/*-------------------------------------------CLIMBING-------------------------------------------*/
+	FOnClimbTransitionNative OnClimbTransition;
+
+	/** Maximum distance between the hands and an edge for it to be grabbed */
+	UPROPERTY(EditAnywhere, Category = "Movement|Climbing")
+	float ClimbGrabRadius{ 60.0f };
+
+	/** Extra distance the server accepts on top of ClimbGrabRadius when validating a client's grab */
+	UPROPERTY(EditAnywhere, Category = "Movement|Climbing")
+	float ClimbGrabTolerance{ 40.0f };
+
+	/** Height of the hands above the actor location */
+	UPROPERTY(EditAnywhere, Category = "Movement|Climbing")
+	float ClimbHandHeight{ 90.0f };
+
+	/** Distance of the actor location from the wall (X) and below the edge (Y) while hanging */
+	UPROPERTY(EditAnywhere, Category = "Movement|Climbing")
+	FVector2D ClimbHangOffset{ 40.0f, 100.0f };
+
+	UPROPERTY(EditAnywhere, Category = "Movement|Climbing")
+	float ClimbShimmySpeed{ 150.0f };
+
+	/** Speed the character travels at to reach a newly grabbed edge */
+	UPROPERTY(EditAnywhere, Category = "Movement|Climbing")
+	float ClimbSnapSpeed{ 1200.0f };
+
+	/** Maximum distance covered by a jump between edges */
+	UPROPERTY(EditAnywhere, Category = "Movement|Climbing")
+	float ClimbMaxJumpDistance{ 400.0f };
+
+	/** The edge the character is holding on to */
+	FClimbEdgeHandle ClimbEdge;
+
+	/** Position along the current edge; Range 0-1 */
+	float ClimbAlpha{ 0.0f };
+
+	/** Indicates the character faces along the edge normal instead of against it (after a pivot) */
+	bool bClimbPivoted{ false };
+
+	/** Requests made by the owning client for the next move; cleared once the move consumed them */
+	bool bWantsToGrab{ false };
+	EClimbTransition RequestedClimbTransition{ EClimbTransition::None };
+	FClimbEdgeHandle RequestedClimbEdge;
+
+	/** Requests grabbing the given edge (found by the caller through the climb graph) */
+	void RequestGrab(FClimbEdgeHandle Edge);
+
+	/** Requests an Ascent, Descent, Pivot or Jump (which needs a target edge) */
+	void RequestClimbTransition(EClimbTransition Transition, FClimbEdgeHandle TargetEdge = FClimbEdgeHandle());
+
+	UFUNCTION(BlueprintPure, Category = "Movement|Climbing")
+	bool IsClimbing() const;
+
+	UFUNCTION(BlueprintPure, Category = "Movement|Climbing")
+	EClimbStance GetClimbStance() const;
+
+	/** Returns the location of the hands */
+	FVector GetClimbHandLocation() const;
+
+	/** Returns the climb graph of the world */
+	UClimbGraphSubsystem* GetClimbGraph() const { return ClimbGraph; }
+
+	/*-------------------------------------------SWINGING-------------------------------------------*/
+	/** Returns the owner's swing component, which holds the swing simulated by the swinging movement mode */
+	USwingComponent* GetSwingComponent() const { return SwingComponent; }
+
+	/** Swing start requested by the owning client for the next move; cleared once the move consumed it */
+	bool bWantsToSwing{ false };
+	FVector RequestedSwingAnchor{ FVector::ZeroVector };
+	EClimbableType RequestedSwingType{ EClimbableType::Rope };
+
+	/** Requests starting a swing from Anchor; the move starts it from wherever the character is at the time */
+	void RequestSwing(const FVector& Anchor, EClimbableType Type);
+
+	/*-------------------------------------------GRAPPLING-------------------------------------------*/
+	/** Returns the owner's grappling hook, which works out the launch velocity */
+	UGrapplingHookComponent* GetGrapplingHookComponent() const { return GrapplingHookComponent; }
+
+	/** Grapple launch requested by the owning client for the next move; cleared once the move consumed it */
+	bool bWantsToLaunch{ false };
+	TWeakObjectPtr<AActor> RequestedLaunchGrapple;
+	int32 RequestedLaunchGrappleIndex{ INDEX_NONE };
+
+	/** Requests a launch onto the landing location of the grapple (and anchor); the move solves the arc from wherever the character is at the time */
+	void RequestGrappleLaunch(AActor* Grapple, int32 Index);
+
+	UFUNCTION(BlueprintPure, Category = "Movement|Swing")
+	bool IsSwinging() const;
+
+protected:
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+
+	virtual void PhysicsRotation(float DeltaTime) override;
+
+private:
+	void PhysClimbing(float DeltaTime, int32 Iterations);
+
+	void PhysSwinging(float DeltaTime, int32 Iterations);
+
+	/** Starts holding the given edge at the point closest to the hands; returns false if it is out of reach */
+	bool EnterClimbing(FClimbEdgeHandle Edge, float MaxDistance, EClimbTransition Transition);
+
+	/** Re-derives the edge and alpha from the current location after a server correction */
+	void ResyncClimbState();
+
+	/** Returns the actor transform that holds the given point of an edge */
+	FTransform GetClimbHangTransform(const FClimbEdge& Edge, float Alpha) const;
+
+	void BroadcastClimbTransition(EClimbTransition Transition);
+};
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "WorldCollision.h"
+#include "DefianceSpringArmComponent.generated.h"
+
+
+/**
+ * Camera boom whose collision probe is an async sweep. Each frame places the camera from the previous frame's result,
+ * extrapolated one frame ahead, so the game thread never waits on camera collision. The crouch height is eased to
+ * instead of snapped to.
+ */
+UCLASS(ClassGroup=(Camera), meta=(BlueprintSpawnableComponent))
+class DEFIANCE_API UDefianceSpringArmComponent : public USpringArmComponent
+{
+	GENERATED_BODY()
+
+	APawn* OwnerRef;
+
+	/** Capsule the boom is attached to, watched for the height changes of crouching */
+	class UCapsuleComponent* CapsuleRef;
+
+	/** Built once; the probe always ignores the owner */
+	FCollisionQueryParams ProbeParams;
+
+	FTraceHandle ProbeTrace;
+	FTraceDelegate ProbeTraceDelegate;
+
+	/** Distance from the arm origin to the blocking hit of the last two probes, if they hit */
+	bool bProbeHit{ false };
+	float ProbeHitDistance{ 0.0f };
+	bool bPreviousProbeHit{ false };
+	float PreviousProbeHitDistance{ 0.0f };
+
+	/** Arm length the camera was placed at last frame, after the collision */
+	float CollisionArmLength{ -1.0f };
+
+	FVector BaseRelativeLocation{ FVector::ZeroVector };
+	float CrouchOffset{ 0.0f };
+	float TargetCrouchOffset{ 0.0f };
+	float LastCapsuleHalfHeight{ 0.0f };
+
+	void HandleProbeTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Indicates a local player looks through this boom, as its pawn or as a spectator */
+	bool IsViewedLocally() const;
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void UpdateDesiredArmLocation(bool bDoTrace, bool bDoLocationLag, bool bDoRotationLag, float DeltaTime) override;
+
+public:
+	UDefianceSpringArmComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Probe with an async sweep; off falls back to the synchronous sweep of USpringArmComponent */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = CameraCollision)
+	bool bAsyncProbe{ true };
+
+	/** How fast the arm extends again once the probe is clear; it always pulls in at once */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = CameraCollision)
+	float ProbeRecoverySpeed{ 10.0f };
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Camera)
+	float CrouchInterpSpeed{ 10.0f };
+
+	/** Height above its standing location the boom eases to, e.g. to hold the view steady while crouched */
+	UFUNCTION(BlueprintCallable)
+	void SetCrouchOffset(float NewCrouchOffset);
+};
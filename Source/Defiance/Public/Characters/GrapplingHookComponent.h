@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "WorldCollision.h"
 #include "GrapplingHookComponent.generated.h"
 
 
@@ -14,6 +15,82 @@ class DEFIANCE_API UGrapplingHookComponent : public UActorComponent
 
 	ACharacter* OwnerRef;
 
+	/** Grapple point (and anchor) that last received OnActivate */
+	TWeakObjectPtr<AActor> NotifiedGrapple;
+	int32 NotifiedGrappleIndex{ INDEX_NONE };
+
+	/** Sends OnDeactivate/OnActivate once per frame for the net change of ActiveGrapple */
+	void FlushGrappleNotifications();
+
+	/** Detection only serves the local player, so the tick is switched on and off as the owner changes controllers */
+	UFUNCTION()
+	void HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
+	/** Detection search submitted to UGameplayQuerySubsystem, if one is in flight */
+	uint32 DetectionQueryId{ 0 };
+
+	/** Picks the visible grapple point closest to the center of the view among the hits of the search */
+	void HandleDetectionQuery(const TArray<FHitResult>& OutHit);
+
+	/** Grapple point or field anchor found by the detection search */
+	struct FGrappleCandidate
+	{
+		/** Dot product of the camera forward vector and the direction to the anchor */
+		float Alignment;
+		TWeakObjectPtr<AActor> Actor;
+		int32 Index;
+		FVector Location;
+		FVector LandingLocation;
+	};
+
+	/** Indicates the visibility trace reached the candidate (and the right anchor of it) first */
+	static bool IsCandidateHit(const FHitResult& Hit, const FGrappleCandidate& Candidate);
+
+	/*-------------------------------------------FLIGHT PREFETCH-------------------------------------------*/
+	// While a launch is in flight its landing point is already known, so detection searches around it and the next
+	// ActiveGrapple is ready when the character lands. The visibility traces are spread over the flight, one async
+	// trace per frame.
+
+	/** Where the launch in progress comes down */
+	FVector FlightLanding{ FVector::ZeroVector };
+
+	/** World time the flight is over by even if no landing is reported */
+	double FlightEndTime{ 0.0 };
+
+	/** Grapple launched from; never offered again during its own flight */
+	TWeakObjectPtr<AActor> LaunchedGrapple;
+	int32 LaunchedGrappleIndex{ INDEX_NONE };
+
+	/** Candidates around the landing point, best first, still waiting for their visibility trace */
+	TArray<FGrappleCandidate> PrefetchCandidates;
+	int32 NextPrefetchCandidate{ 0 };
+
+	/** Camera location predicted for the landing, where the prefetch traces start */
+	FVector PrefetchCameraLocation{ FVector::ZeroVector };
+
+	FTraceHandle PrefetchTrace;
+	FTraceDelegate PrefetchTraceDelegate;
+
+	/** Starts the async visibility trace of the next prefetch candidate */
+	void TracePrefetchCandidate();
+
+	void HandlePrefetchTrace(const FTraceHandle& TraceHandle, FTraceDatum& TraceDatum);
+
+	/** Predicts the landing of the launch from Grapple just applied from LaunchLocation and points detection at it */
+	void StartFlight(AActor* Grapple, int32 GrappleIndex, const FVector& LaunchLocation, const FVector& FlightVelocity, const FVector& LandingLocation);
+
+	UFUNCTION()
+	void HandleLanded(const FHitResult& Hit);
+
+	void EndFlight();
+
+	/** Location detection searches around: the owner, or the landing point during a flight */
+	FVector GetDetectionOrigin() const;
+
+	/** Solves the launch from the owner's location onto the landing location of the grapple (and anchor); returns false
+	 * if it is out of range or needs more than MaxLaunchSpeed */
+	bool ComputeLaunch(AActor* Grapple, int32 GrappleIndex, FVector& OutFlightVelocity, FVector& OutLandingLocation) const;
+
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
@@ -29,12 +106,20 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
 	AActor* ActiveGrapple;
 
+	/** Anchor of ActiveGrapple when it holds many (AGrapplePointField), INDEX_NONE otherwise */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 ActiveGrappleIndex{ INDEX_NONE };
+
 	UPROPERTY(EditAnywhere)
 	float DetectionRadius{ 1000.0f };
 
 	UPROPERTY(EditAnywhere)
 	float InteractRange{ 600.0f };
 
+	/** Frames a detection search may be held back when the query budget is used up */
+	UPROPERTY(EditAnywhere)
+	int32 DetectionDeadlineFrames{ 2 };
+
 	UPROPERTY(VisibleAnywhere)
 	bool bCanLaunch{ true };
 
@@ -47,15 +132,37 @@ public:
 	UPROPERTY(EditAnywhere)
 	FVector LaunchModifier{ FVector(1.6, 1.6, 1.2) };
 
+	/** Fastest launch the hook can give; candidates that need more are never offered */
+	UPROPERTY(EditAnywhere)
+	float MaxLaunchSpeed{ 2500.0f };
+
+	/** Time after the predicted landing a flight ends by itself if the landing is never reported */
+	UPROPERTY(EditAnywhere)
+	float FlightEndMargin{ 0.5f };
+
 
+	/** Submits a search for grapple points to UGameplayQuerySubsystem; ActiveGrapple is updated when it has run */
 	UFUNCTION(BlueprintCallable)
 	void DetectGrapple(float Range);
 
-	void UpdateActiveGrapple(AActor* NewGrapple);
+	void UpdateActiveGrapple(AActor* NewGrapple, int32 NewGrappleIndex = INDEX_NONE);
 
+	/** Launches the owner onto the landing location of the active grapple point or anchor, if it is in range. The launch
+	 * is sent with the next move, so it only applies once the movement component runs that move */
 	UFUNCTION(BlueprintCallable)
 	void LaunchOnGrapple();
 
+	/** Called by the movement component on the move that requested the launch; returns false if the grapple cannot be launched onto from here */
+	bool LaunchFromMove(AActor* Grapple, int32 GrappleIndex);
+
+	/** Returns where a launch on the active grapple point or anchor comes down, or the zero vector without one */
+	UFUNCTION(BlueprintCallable)
+	FVector GetActiveLandingLocation() const;
+
+	/** Swings from the active grapple point on a rope, if the owner has a USwingComponent */
+	UFUNCTION(BlueprintCallable)
+	void SwingOnGrapple();
+
 
 	
 };
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Types.h"
+#include "SignificanceSubsystem.generated.h"
+
+
+/**
+ * Sorts every Defiance character into a significance tier by its distance to the closest player view, and slows down
+ * the ticks of the less significant ones. Locally controlled characters always stay in the High tier.
+ */
+UCLASS()
+class DEFIANCE_API USignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Registered characters and their current tiers share indices */
+	TArray<TWeakObjectPtr<ACharacter>> Characters;
+	TArray<ESignificanceTier> Tiers;
+
+	TArray<FVector> ViewLocations;
+
+	float TimeUntilUpdate{ 0.0f };
+
+	ESignificanceTier ComputeTier(const ACharacter* Character) const;
+
+	/** Sets the tick intervals of the character and of the components that can run slower */
+	void ApplyTier(ACharacter* Character, ESignificanceTier Tier) const;
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Returns the significance subsystem of the world the object lives in */
+	static USignificanceSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Seconds between two evaluations of the tiers */
+	float UpdateInterval{ 0.25f };
+
+	/** Characters further than this from every player view drop to the Medium tier */
+	float MediumDistance{ 2000.0f };
+
+	/** Characters further than this from every player view drop to the Low tier */
+	float LowDistance{ 5000.0f };
+
+	/** Tick interval of each tier; 0 ticks every frame */
+	float TierTickIntervals[static_cast<int32>(ESignificanceTier::MAX)]{ 0.0f, 1.0f / 30.0f, 0.1f };
+
+	void RegisterCharacter(ACharacter* Character);
+
+	void UnregisterCharacter(const ACharacter* Character);
+
+	/** Returns the tier of the character; unregistered characters are High */
+	ESignificanceTier GetTier(const ACharacter* Character) const;
+
+	/** Logs the number of characters in each tier */
+	void DumpStats() const;
+};
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Types.h"
+#include "Physics/RopeSolver.h"
+#include "SwingComponent.generated.h"
+
+
+/** Everything the swing simulation carries from one move to the next; saved with every client move so a swing can be replayed */
+struct FSwingState
+{
+	FRopeSolver Solver;
+
+	/** Time not yet consumed by fixed solver steps */
+	float StepAccumulator{ 0.0f };
+};
+
+
+/**
+ * Swings the character from a rope, high bar or grapple anchor. The swing is solved by a FRopeSolver at a fixed
+ * step from inside the swinging movement mode of UDefianceMovementComponent, so it runs as part of every move and
+ * is replayed with the move after a server correction. Pumping is the character's movement input.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class DEFIANCE_API USwingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	ACharacter* OwnerRef;
+
+	class UCharacterMovementComponent* MovementComp;
+
+	FSwingState State;
+
+	/** Indicates the hands are close enough to Anchor to swing from it */
+	bool IsWithinReach(const FVector& Location, const FVector& Anchor) const;
+
+	void BeginSwing(const FVector& Anchor, EClimbableType Type, const FVector& StartLocation, const FVector& StartVelocity);
+
+	void EndSwing();
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+
+public:	
+	// Sets default values for this component's properties
+	USwingComponent();
+
+	// Property replication
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+
+	/** Indicates if the character is currently swinging; the owner predicts it, so it is not replicated back to them */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = "Movement|Swing")
+	bool bIsSwinging{ false };
+
+	/** What the character is swinging from */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = "Movement|Swing")
+	EClimbableType SwingType{ EClimbableType::Rope };
+
+	/** Point the character is swinging from, used to rebuild the swing when a correction starts it on the owner */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Replicated, Category = "Movement|Swing")
+	FVector_NetQuantize SwingAnchor{ FVector::ZeroVector };
+
+	/** Fixed solver step */
+	UPROPERTY(EditAnywhere, Category = "Movement|Swing")
+	float FixedStep{ 1.0f / 60.0f };
+
+	/** Maximum solver steps run in one move, to avoid a spiral after a hitch */
+	UPROPERTY(EditAnywhere, Category = "Movement|Swing")
+	int32 MaxStepsPerFrame{ 4 };
+
+	/** Number of segments used for ropes; high bars and grapples always use a single rigid segment */
+	UPROPERTY(EditAnywhere, Category = "Movement|Swing")
+	int32 RopeSegments{ 8 };
+
+	/** Acceleration applied by fully pumping the swing */
+	UPROPERTY(EditAnywhere, Category = "Movement|Swing")
+	float PumpStrength{ 600.0f };
+
+	/** Height of the hands above the actor location */
+	UPROPERTY(EditAnywhere, Category = "Movement|Swing")
+	float HandHeight{ 90.0f };
+
+	/** Maximum distance between the hands and the anchor */
+	UPROPERTY(EditAnywhere, Category = "Movement|Swing")
+	float MaxSwingLength{ 1500.0f };
+
+
+	/** Starts swinging from Anchor on the next move */
+	UFUNCTION(BlueprintCallable)
+	void StartSwing(FVector Anchor, EClimbableType Type);
+
+	/** Lets go and keeps the swing's momentum */
+	UFUNCTION(BlueprintCallable)
+	void StopSwing();
+
+	/** Pumps the swing towards the given world direction; Range 0-1 */
+	UFUNCTION(BlueprintCallable)
+	void Pump(FVector Direction);
+
+	UFUNCTION(Server, Reliable)
+	void SR_StopSwing();
+
+	/** Called by the movement component on the move that requested the swing; returns false if Anchor is out of reach */
+	bool BeginSwingFromMove(const FVector& Anchor, EClimbableType Type);
+
+	/** Advances the swing by one move; PumpInput is the move's input (Range 0-1). Returns where the character should be */
+	void SimulateSwing(float DeltaTime, const FVector& PumpInput, FVector& OutLocation, FQuat& OutRotation);
+
+	/** Called by the movement component when the character left the swinging movement mode */
+	void HandleSwingEnded();
+
+	/** Moves the end of the swing to the character, after a server correction placed it somewhere else */
+	void SyncToCharacter(const FVector& Location, const FVector& Velocity);
+
+	const FSwingState& GetSwingState() const { return State; }
+
+	void RestoreSwingState(const FSwingState& SwingState);
+};
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Interfaces/Poolable.h"
 #include "LockOnComponent.generated.h"
 
 DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(
@@ -12,20 +13,55 @@ DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(
 	AActor*, NewTargetActorRef
 );
 
+DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_OneParam(
+	FOnLockOnResultSignature,
+	ULockOnComponent, OnLockOnResultDelegate,
+	AActor*, LockedTarget
+);
+
 
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
-class DEFIANCE_API ULockOnComponent : public UActorComponent
+class DEFIANCE_API ULockOnComponent : public UActorComponent, public IPoolable
 {
 	GENERATED_BODY()
 
 	ACharacter* OwnerRef;
 
-	APlayerController* Controller;
+	/** Controller of the owner while it is the local player */
+	APlayerController* Controller{ nullptr };
 
 	class UCharacterMovementComponent* MovementComp;
 
 	class USpringArmComponent* CameraBoom;
 
+	/** Target selected locally, and the one that last received OnSelect */
+	TWeakObjectPtr<AActor> SelectedTarget;
+	TWeakObjectPtr<AActor> NotifiedTarget;
+
+	/** Sends OnDeselect/OnSelect once per frame for the net change of SelectedTarget */
+	void FlushTargetNotifications();
+
+	/** Only the local player steers its camera towards the target, so the tick follows the owner's controller */
+	UFUNCTION()
+	void HandleControllerChanged(APawn* Pawn, AController* OldController, AController* NewController);
+
+	/** Target search submitted to UGameplayQuerySubsystem, if one is in flight */
+	uint32 LockOnQueryId{ 0 };
+
+	/** Submits the target search; returns false if there is no query subsystem */
+	bool RequestLockOn(float SphereRadious, bool bResetCameraOnMiss);
+
+	/** Picks the best target among the hits of the search and locks onto it */
+	void HandleLockOnQuery(const TArray<FHitResult>& OutHit, float SphereRadious, bool bResetCameraOnMiss);
+
+	/** Sets the target of a lock on request that passed validation */
+	bool ApplyLockOn(AActor* NewTarget);
+
+	/** Look input is ignored while locked on; kept as a flag so repeated lock ons do not stack on the controller's counter */
+	bool bLookInputLocked{ false };
+
+	void SetLookInputLocked(bool bLocked);
+
 
 public:	
 	// Sets default values for this component's properties
@@ -43,13 +79,23 @@ public:
 	UPROPERTY(BlueprintAssignable)
 	FOnUpdatedTargetSignature OnUpdatedTargetDelegate;
 
+	/** Called on the owning client when a target search finishes, and again if the server refuses its target; LockedTarget is null when nothing was locked */
+	UPROPERTY(BlueprintAssignable)
+	FOnLockOnResultSignature OnLockOnResultDelegate;
+
+	/** Drops the current target and deselects it */
+	virtual void OnReleasedToPool() override;
+
 
 protected:
 	// Called when the game starts
 	virtual void BeginPlay() override;
 
+	/** Starts searching for a target to lock onto; the search runs through UGameplayQuerySubsystem before the end of the
+	 *  frame and reports through OnLockOnResultDelegate. Returns false if the search could not be submitted, not whether
+	 *  a target was found */
 	UFUNCTION(BlueprintCallable)
-	bool StartLockOn(float SphereRadious = 750.0f);
+	bool StartLockOnSearch(float SphereRadious = 750.0f);
 
 	UFUNCTION(BlueprintCallable)
 	void EndLockOn();
@@ -60,8 +106,13 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void ResetCamera();
 
+	/** ClientTimeStamp is the server time of the poses the client saw (URewindSubsystem::GetViewTime), used to validate against the rewound positions */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void SR_UpdateLockOn(AActor* NewTarget);
+	void SR_UpdateLockOn(AActor* NewTarget, double ClientTimeStamp);
+
+	/** Called on the owning client when the server refused to lock onto RejectedTarget; undoes what the client predicted */
+	UFUNCTION(Client, Reliable)
+	void CL_LockOnRejected(AActor* RejectedTarget);
 
 	
 	UPROPERTY(EditAnywhere)
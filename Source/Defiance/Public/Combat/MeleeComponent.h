@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/NetSerialization.h"
+#include "MeleeComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_SPARSE_DELEGATE_TwoParams(
+	FOnMeleeHitReceivedSignature,
+	UMeleeComponent, OnMeleeHitReceivedDelegate,
+	AActor*, Attacker,
+	FVector, HitLocation
+);
+
+
+/**
+ * Melee attacks and hit reactions of a character. Every character that can be hit needs one; hit detection for all
+ * attacks in the world is batched by UMeleeHitSubsystem.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class DEFIANCE_API UMeleeComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+	friend class UMeleeHitSubsystem;
+
+	ACharacter* OwnerRef;
+
+	class UMeleeHitSubsystem* HitSubsystem;
+
+	/** Socket locations in component space and the component transform when they were last sampled */
+	TArray<FVector> PrevSocketLocations;
+	FTransform PrevComponentTransform;
+
+	/** Victims already hit by the current attack */
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<4>> HitVictims;
+
+	/** Increased with every attack so late hit reports of a previous attack are ignored */
+	uint8 AttackId{ 0 };
+
+	TSharedPtr<struct FStreamableHandle> HitReactHandle;
+
+	/** Called by the hit subsystem when the current attack overlaps a victim */
+	void HandleHit(AActor* Victim, const FVector& HitLocation);
+
+	void ApplyHit(AActor* Victim, const FVector& HitLocation);
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+
+public:	
+	// Sets default values for this component's properties
+	UMeleeComponent();
+
+
+	/** Indicates an attack window is open */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Melee")
+	bool bIsAttacking{ false };
+
+	/** Sockets of the owner's mesh traced during an attack (weapon tip and base, fists...) */
+	UPROPERTY(EditAnywhere, Category = "Melee")
+	TArray<FName> TraceSockets{ TEXT("hand_r") };
+
+	/** Radius of the sphere traced at every socket */
+	UPROPERTY(EditAnywhere, Category = "Melee")
+	float TraceRadius{ 15.0f };
+
+	/** Sub-steps are added between frames so no socket moves further than this in one step */
+	UPROPERTY(EditAnywhere, Category = "Melee")
+	float MaxSubStepDistance{ 20.0f };
+
+	UPROPERTY(EditAnywhere, Category = "Melee")
+	int32 MaxSubSteps{ 8 };
+
+	/** Health removed from crowd members hit by this character */
+	UPROPERTY(EditAnywhere, Category = "Melee")
+	float HitDamage{ 25.0f };
+
+	/** Maximum distance between the attacker and the victim the server accepts for a hit */
+	UPROPERTY(EditAnywhere, Category = "Melee")
+	float MaxHitReach{ 300.0f };
+
+	/** Extra distance around the victim's rewound capsule the server accepts for a reported hit location */
+	UPROPERTY(EditAnywhere, Category = "Melee")
+	float HitTolerance{ 50.0f };
+
+	/** Reactions played when this character is hit; one is picked at random */
+	UPROPERTY(EditAnywhere, Category = "Melee|Animation")
+	TArray<TSoftObjectPtr<UAnimSequenceBase>> HitReactAnimations;
+
+	UPROPERTY(EditAnywhere, Category = "Melee|Animation")
+	FName HitReactSlot{ TEXT("DefaultSlot") };
+
+	UPROPERTY(BlueprintAssignable)
+	FOnMeleeHitReceivedSignature OnMeleeHitReceivedDelegate;
+
+
+	/** Opens the attack window; called by the attack animation on the controlling machine */
+	UFUNCTION(BlueprintCallable)
+	void BeginAttack();
+
+	/** Closes the attack window */
+	UFUNCTION(BlueprintCallable)
+	void EndAttack();
+
+	/** Returns true if hits of this attack are detected on this machine (the owning client, or the server for AI) */
+	bool IsDetectingHits() const;
+
+	UFUNCTION(Server, Reliable)
+	void SR_BeginAttack(uint8 NewAttackId);
+
+	UFUNCTION(Server, Reliable)
+	void SR_EndAttack();
+
+	/** Sent by the owning client for every victim it hit; the server confirms the hit before applying it */
+	UFUNCTION(Server, Reliable)
+	void SR_ConfirmHit(AActor* Victim, FVector_NetQuantize HitLocation, uint8 HitAttackId, double ClientTimeStamp);
+
+	UFUNCTION(NetMulticast, Unreliable)
+	void NM_ReceiveHit(AActor* Attacker, FVector_NetQuantize HitLocation);
+};
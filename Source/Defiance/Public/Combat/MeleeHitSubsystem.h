@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MeleeHitSubsystem.generated.h"
+
+class UMeleeComponent;
+
+
+/**
+ * Detects melee hits for every active attack of the world in a single batch once per frame. Attack sockets are
+ * sub-stepped between frames so fast swings cannot pass through a victim, and every step is tested against a snapshot
+ * of all hittable capsules, so the cost grows with active attacks instead of with physics scene queries.
+ */
+UCLASS()
+class DEFIANCE_API UMeleeHitSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Swept sphere of one socket between two sub-steps */
+	struct FMeleeSweep
+	{
+		FVector3f Start;
+		FVector3f End;
+		FVector3f BoundsMin;
+		FVector3f BoundsMax;
+		float Radius;
+		int32 AttackerIndex;
+	};
+
+	/** Every component that can be hit */
+	UPROPERTY()
+	TArray<UMeleeComponent*> Hittables;
+
+	/** Components with an attack window open on this machine */
+	UPROPERTY()
+	TArray<UMeleeComponent*> ActiveAttackers;
+
+	/** Capsules of the hittables for the current batch, as separate arrays; the segment runs from bottom to top sphere center */
+	TArray<FVector3f> VictimBottoms;
+	TArray<FVector3f> VictimTops;
+	TArray<float> VictimRadii;
+
+	TArray<FMeleeSweep> Sweeps;
+
+	/** Drops components destroyed without unregistering, which garbage collection left as null */
+	void RemoveStaleComponents();
+
+	void GatherVictims();
+
+	void GatherSweeps();
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual bool IsTickable() const override { return ActiveAttackers.Num() > 0; }
+
+	/** Returns the melee hit subsystem of the world the object lives in */
+	static UMeleeHitSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Oldest hit report the server accepts, in seconds */
+	float MaxHitAge{ 0.5f };
+
+	void RegisterHittable(UMeleeComponent* Component);
+
+	void UnregisterHittable(UMeleeComponent* Component);
+
+	/** Starts tracing the component's sockets every frame until EndAttack */
+	void BeginAttack(UMeleeComponent* Component);
+
+	void EndAttack(UMeleeComponent* Component);
+
+	/** Samples the component's sockets now, so the next batch sweeps from here */
+	static void SampleSockets(UMeleeComponent* Component, TArray<FVector>& OutComponentLocations, FTransform& OutComponentTransform);
+};
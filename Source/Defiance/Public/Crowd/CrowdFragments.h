@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "CrowdFragments.generated.h"
+
+
+//Team the crowd member fights for
+USTRUCT()
+struct DEFIANCE_API FCrowdTeamFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	uint8 Team = 0;
+};
+
+USTRUCT()
+struct DEFIANCE_API FCrowdHealthFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	float Health = 100.0f;
+};
+
+//Movement and the state of the simple chase/wander behavior
+USTRUCT()
+struct DEFIANCE_API FCrowdMovementFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	FVector Velocity = FVector::ZeroVector;
+
+	/** Point the member is walking towards */
+	FVector Goal = FVector::ZeroVector;
+
+	/** Center of the area the member wanders around when no player is close */
+	FVector Home = FVector::ZeroVector;
+
+	float MaxSpeed = 300.0f;
+
+	/** Time left before a new wander goal is picked */
+	float WanderTimeLeft = 0.0f;
+
+	/** Per member seed so wandering differs between members but stays deterministic */
+	uint32 RandomSeed = 0;
+};
+
+//Actor standing in for the member while a player is close
+USTRUCT()
+struct DEFIANCE_API FCrowdActorFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	TWeakObjectPtr<AActor> Actor;
+
+	/** Class spawned on promotion; kept loaded by the spawner that created the member */
+	TWeakObjectPtr<UClass> ActorClass;
+};
+
+//Marks crowd members players can lock onto
+USTRUCT()
+struct DEFIANCE_API FCrowdLockableTag : public FMassTag
+{
+	GENERATED_BODY()
+};
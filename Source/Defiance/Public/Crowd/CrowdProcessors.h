@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+#include "CrowdProcessors.generated.h"
+
+
+/**
+ * Picks where every crowd member not represented by an actor walks: towards the closest player within aggro range,
+ * otherwise to a random point around its home
+ */
+UCLASS()
+class DEFIANCE_API UCrowdBehaviorProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UCrowdBehaviorProcessor();
+
+protected:
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
+
+
+/**
+ * Moves every crowd member not represented by an actor along its velocity
+ */
+UCLASS()
+class DEFIANCE_API UCrowdMovementProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UCrowdMovementProcessor();
+
+protected:
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
+
+
+/**
+ * Runs on the game thread after movement: copies promoted actors back into their members, gathers lockable members
+ * for lock on queries and queues promotions, demotions and deaths for UCrowdSubsystem
+ */
+UCLASS()
+class DEFIANCE_API UCrowdSyncProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UCrowdSyncProcessor();
+
+protected:
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+};
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "CrowdSpawner.generated.h"
+
+/**
+ * Spawns a crowd of Mass enemies around itself when the game starts
+ */
+UCLASS()
+class DEFIANCE_API ACrowdSpawner : public AActor
+{
+	GENERATED_BODY()
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+public:	
+	// Sets default values for this actor's properties
+	ACrowdSpawner();
+
+	UPROPERTY(EditAnywhere, Category = "Crowd")
+	int32 Count{ 1000 };
+
+	/** Radius around the spawner the members are spread in */
+	UPROPERTY(EditAnywhere, Category = "Crowd")
+	float Radius{ 5000.0f };
+
+	UPROPERTY(EditAnywhere, Category = "Crowd")
+	uint8 Team{ 1 };
+
+	UPROPERTY(EditAnywhere, Category = "Crowd")
+	float MaxSpeed{ 300.0f };
+
+	/** Indicates if players can lock onto the members */
+	UPROPERTY(EditAnywhere, Category = "Crowd")
+	bool bLockable{ true };
+
+	/** Actor spawned for a member while a player is close; should implement IEnemy to be lockable */
+	UPROPERTY(EditAnywhere, Category = "Crowd")
+	TSubclassOf<AActor> PromotedActorClass;
+};
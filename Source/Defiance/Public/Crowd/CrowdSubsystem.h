@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MassEntityTypes.h"
+#include "CrowdSubsystem.generated.h"
+
+struct FMassEntityManager;
+
+
+//Something a player can lock onto: a promoted actor, or a crowd member that is only an entity
+struct FCrowdLockOnCandidate
+{
+	FVector Location;
+	FMassEntityHandle Entity;
+};
+
+
+/**
+ * Owns the Mass crowd of enemies. Members are plain entities simulated by the crowd processors on the server and are
+ * promoted to actors only while a player is within PromotionRadius, so a horde costs actor ticks only where it matters.
+ */
+UCLASS()
+class DEFIANCE_API UCrowdSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	friend class UCrowdSyncProcessor;
+
+	/** Lockable members without an actor, gathered by UCrowdSyncProcessor every frame */
+	TArray<FMassEntityHandle> LockableEntities;
+	TArray<FVector> LockableLocations;
+
+	/** Requests queued by UCrowdSyncProcessor and applied in Tick */
+	TArray<FMassEntityHandle> PendingPromotions;
+	TArray<FMassEntityHandle> PendingDemotions;
+	TArray<FMassEntityHandle> PendingDeaths;
+
+	/** Locations of all player pawns, read by the processors */
+	TArray<FVector> PlayerLocations;
+
+	TMap<TObjectKey<AActor>, FMassEntityHandle> PromotedActors;
+
+	FMassEntityManager* GetEntityManager() const;
+
+	void Demote(FMassEntityHandle Entity);
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Returns the crowd subsystem of the world the object lives in */
+	static UCrowdSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Members closer than this to a player are represented by an actor */
+	float PromotionRadius{ 2500.0f };
+
+	/** Extra distance a promoted member has to move away before it turns back into an entity */
+	float DemotionHysteresis{ 500.0f };
+
+	/** Members chase players within this distance */
+	float AggroRadius{ 1500.0f };
+
+	/** Distance around its home a member wanders */
+	float WanderRadius{ 800.0f };
+
+	/** Creates Count members spread around Center; only has an effect on the server */
+	void SpawnCrowd(int32 Count, const FVector& Center, float Radius, uint8 Team, float MaxSpeed, TSubclassOf<AActor> ActorClass, bool bLockable);
+
+	/** Appends every lockable member within Radius of Origin that is not represented by an actor */
+	void FindLockOnCandidates(const FVector& Origin, float Radius, TArray<FCrowdLockOnCandidate>& OutCandidates) const;
+
+	/** Spawns the actor of a member right away (when it is picked as a lock on target); returns the actor */
+	AActor* Promote(FMassEntityHandle Entity);
+
+	/** Returns the member the actor represents, or an invalid handle */
+	FMassEntityHandle FindEntityForActor(const AActor* Actor) const;
+
+	/** Removes health from the member represented by the actor; returns false if the actor is not a crowd member */
+	bool ApplyDamageToActor(const AActor* Actor, float Damage);
+
+	const TArray<FVector>& GetPlayerLocations() const { return PlayerLocations; }
+};
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "CharacterMemoryCommandlet.generated.h"
+
+/**
+ * Prints the per character memory report without starting the game, for tracking regressions in automation.
+ * Usage: UnrealEditor-Cmd Defiance.uproject -run=CharacterMemory [-Count=50] [-Class=/Game/Path.Class_C]
+ */
+UCLASS()
+class DEFIANCE_API UCharacterMemoryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UCharacterMemoryCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
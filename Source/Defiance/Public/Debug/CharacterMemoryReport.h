@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ACharacter;
+
+/**
+ * Measures what a character costs in memory by spawning a batch of them and adding up every object they own
+ * (components, anim instances, ...). Shared by the defiance.Memory.CharacterReport console command and
+ * UCharacterMemoryCommandlet.
+ */
+struct DEFIANCE_API FCharacterMemoryReport
+{
+	/** Blueprint character used when no class is given */
+	static const TCHAR* DefaultCharacterClassPath;
+
+	/** Loads the character class at ClassPath, or the default one when ClassPath is empty */
+	static UClass* LoadCharacterClass(const FString& ClassPath);
+
+	/** Spawns Count characters of the class, prints the average size of each object type per character, then destroys them */
+	static void Run(UWorld* World, UClass* CharacterClass, int32 Count, FOutputDevice& Ar);
+};
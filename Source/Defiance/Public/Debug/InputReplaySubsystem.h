@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "InputActionValue.h"
+#include "InputReplaySubsystem.generated.h"
+
+class UInputAction;
+class UMyInputConfigData;
+
+
+/** Value of one input action during one frame of a recording */
+struct FInputReplayEvent
+{
+	/** Frame relative to the start of the recording */
+	uint32 Frame{ 0 };
+
+	/** Index into the action table of the recording */
+	uint8 ActionIndex{ 0 };
+
+	EInputActionValueType ValueType{ EInputActionValueType::Boolean };
+
+	FVector Value{ FVector::ZeroVector };
+};
+
+
+/**
+ * Records the Enhanced Input actions of UMyInputConfigData on the local player, frame by frame, into a small binary
+ * file, and plays such a file back by injecting the same action values on the same frames. Replayed input goes through
+ * the character's regular input bindings, so it reaches the movement, common actions, lock on and grappling
+ * components the same way a player does. Replays step every frame by its recorded delta time and reuse the recorded random seed.
+ *
+ * Start a replay headless with -DefianceReplay=<Name>; the game exits when it is done and the result is logged.
+ */
+UCLASS()
+class DEFIANCE_API UInputReplaySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	enum class EMode : uint8
+	{
+		Idle,
+		Recording,
+		Replaying
+	};
+
+	EMode Mode{ EMode::Idle };
+
+	/** Actions of the recording; events refer to them by index */
+	UPROPERTY()
+	TArray<TObjectPtr<UInputAction>> Actions;
+
+	TArray<FInputReplayEvent> Events;
+
+	/** Delta time of every recorded frame; the replay runs with exactly these steps */
+	TArray<float> FrameDeltas;
+
+	/** Value of GFrameCounter on frame 0 of the recording or replay */
+	uint64 StartFrame{ 0 };
+
+	/** Next event to inject while replaying */
+	int32 NextEvent{ 0 };
+
+	int32 RandomSeed{ 0 };
+
+	/** Pawn transform and control rotation when the recording started; restored before a replay */
+	FTransform StartTransform;
+	FRotator StartControlRotation;
+
+	FString FilePath;
+
+	/** Exits the game when the replay is done (headless runs) */
+	bool bExitWhenDone{ false };
+
+	/** Replay requested from the command line, started once the local player has a pawn */
+	FString PendingReplayName;
+
+	/** Measurements taken while replaying */
+	TArray<float> GameThreadTimes;
+	TArray<float> FrameTimes;
+	double LastFrameTime{ 0.0 };
+	uint64 StartQueriesRun{ 0 };
+	uint64 StartQueriesShared{ 0 };
+	uint64 StartQueriesDeferred{ 0 };
+	bool bSavedUseFixedTimeStep{ false };
+	double SavedFixedDeltaTime{ 0.0 };
+
+	void TickRecording();
+
+	void TickReplay();
+
+	void FinishReplay();
+
+	/** Reads or writes the whole recording depending on the archive */
+	void SerializeRecording(FArchive& Ar);
+
+	bool SaveFile();
+
+	bool LoadFile();
+
+	class UEnhancedInputLocalPlayerSubsystem* GetInputSubsystem() const;
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual bool IsTickable() const override;
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Returns the input replay subsystem of the world the object lives in */
+	static UInputReplaySubsystem* Get(const UObject* WorldContextObject);
+
+	/** Input config recorded when none is given */
+	static const TCHAR* DefaultInputConfigPath;
+
+	/** Returns where recordings with the given name are stored */
+	static FString GetReplayFilePath(const FString& Name);
+
+	/** Starts recording every action of the config on the local player */
+	bool StartRecording(const FString& Name, UMyInputConfigData* InputConfig);
+
+	/** Stops recording and writes the file */
+	void StopRecording();
+
+	/** Loads the recording and starts feeding it to the local player from the next frame */
+	bool StartReplay(const FString& Name, bool bInExitWhenDone = false);
+
+	bool IsRecording() const { return Mode == EMode::Recording; }
+
+	bool IsReplaying() const { return Mode == EMode::Replaying; }
+};
@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "StressMapCommandlet.generated.h"
+
+/**
+ * Generates a benchmark map filled with grapple points, lock on targets, occluders and climbable geometry at a multiple
+ * of the production density. The layout only depends on the seed, so two runs with the same arguments produce the same
+ * map and benchmark results (and input replays recorded on it) stay comparable.
+ *
+ * Usage: UnrealEditor-Cmd Defiance.uproject -run=StressMap [-Seed=1] [-Density=10] [-Map=/Game/Benchmarks/StressMap_10x]
+ *        [-GrapplePoints=] [-Enemies=] [-Occluders=] [-Climbables=] [-GrappleClass=] [-EnemyClass=] [-GrappleField]
+ * The map then loads like any other: Defiance /Game/Benchmarks/StressMap_10x -DefianceReplay=<Name>
+ */
+UCLASS()
+class DEFIANCE_API UStressMapCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UStressMapCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** Counts of ThirdPersonMap, multiplied by -Density when no explicit count is given */
+	static constexpr int32 BaseGrapplePoints{ 8 };
+	static constexpr int32 BaseEnemies{ 4 };
+	static constexpr int32 BaseOccluders{ 16 };
+	static constexpr int32 BaseClimbables{ 8 };
+
+	/** Half size of the square the content is spread over; the same at every density, so the candidates around the
+	 * player grow with it. -Extent= overrides it */
+	static constexpr float DefaultHalfExtent{ 3000.0f };
+
+	static const TCHAR* DefaultGrapplePointClassPath;
+
+	static const TCHAR* DefaultEnemyClassPath;
+};
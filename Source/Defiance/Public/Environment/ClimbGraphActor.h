@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Types.h"
+#include "ClimbGraphActor.generated.h"
+
+//Struct describing a single climbable edge baked from level geometry
+USTRUCT()
+struct FClimbEdge
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FVector3f Start{ FVector3f::ZeroVector };
+
+	UPROPERTY()
+	FVector3f End{ FVector3f::ZeroVector };
+
+	/** Horizontal direction pointing away from the wall the edge belongs to */
+	UPROPERTY()
+	FVector3f Normal{ FVector3f::ForwardVector };
+
+	UPROPERTY()
+	EClimbableType Type{ EClimbableType::Ledge };
+
+	/** Indicates there is room to stand on top of the edge */
+	UPROPERTY()
+	bool bCanAscend{ false };
+
+	/** Edge connected to End (INDEX_NONE if the edge is open) */
+	UPROPERTY()
+	int32 NextEdge{ INDEX_NONE };
+
+	/** Edge connected to Start (INDEX_NONE if the edge is open) */
+	UPROPERTY()
+	int32 PrevEdge{ INDEX_NONE };
+
+	/** Transition played when moving from End onto NextEdge */
+	UPROPERTY()
+	EClimbTransition NextTransition{ EClimbTransition::None };
+
+	/** Transition played when moving from Start onto PrevEdge */
+	UPROPERTY()
+	EClimbTransition PrevTransition{ EClimbTransition::None };
+
+	FVector GetPoint(float Alpha) const { return FVector(FMath::Lerp(Start, End, Alpha)); }
+
+	float GetLength() const { return (End - Start).Size(); }
+};
+
+
+/**
+ * Holds the climbable edges baked for one level cell. The actor is placed in the cell it covers so it streams in and out
+ * with it, and registers its graph with the UClimbGraphSubsystem while loaded.
+ */
+UCLASS()
+class DEFIANCE_API AClimbGraphActor : public AActor
+{
+	GENERATED_BODY()
+
+	/** Area of the level covered by this graph */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Climbing", meta = (AllowPrivateAccess = "true"))
+	class UBoxComponent* Bounds;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	// Sets default values for this actor's properties
+	AClimbGraphActor();
+
+
+	/** Identifier used to reference this graph's edges over the network; assigned at bake */
+	UPROPERTY(VisibleAnywhere, Category = "Climbing|Bake")
+	uint16 GraphId{ 0 };
+
+	UPROPERTY(VisibleAnywhere, Category = "Climbing|Bake")
+	TArray<FClimbEdge> Edges;
+
+	/** Size of a spatial grid bucket on the XY plane */
+	UPROPERTY(EditAnywhere, Category = "Climbing|Bake", meta = (ClampMin = "1.0"))
+	float BucketSize{ 200.0f };
+
+	/** Edge endpoints closer than this are welded together */
+	UPROPERTY(EditAnywhere, Category = "Climbing|Bake")
+	float WeldTolerance{ 5.0f };
+
+	/** Direction changes sharper than this (degrees) between connected edges are baked as corners */
+	UPROPERTY(EditAnywhere, Category = "Climbing|Bake")
+	float CornerAngle{ 30.0f };
+
+	/** Capsule used at bake time to check whether a ledge can be climbed onto */
+	UPROPERTY(EditAnywhere, Category = "Climbing|Bake")
+	FVector2D AscentCapsule{ 35.0f, 90.0f };
+
+	/** Returns the world space box covered by this graph */
+	FBox GetGraphBounds() const;
+
+	/** Returns the nearest edge within Radius, or INDEX_NONE */
+	int32 FindNearestEdge(const FVector& Location, float Radius, float& OutAlpha, float& OutDistance) const;
+
+	/** Returns the best edge in front of From along Direction within MaxDistance, or INDEX_NONE */
+	int32 FindJumpTarget(const FVector& From, const FVector& Direction, float MaxDistance, int32 ExcludedEdge, float& OutAlpha, float& OutScore) const;
+
+#if WITH_EDITOR
+	/** Extracts climbable edges from every tagged static mesh inside the bounds */
+	UFUNCTION(CallInEditor, Category = "Climbing|Bake")
+	void BakeClimbGraph();
+#endif
+
+private:
+	UPROPERTY()
+	FVector GridOrigin{ FVector::ZeroVector };
+
+	UPROPERTY()
+	FIntPoint GridSize{ 0, 0 };
+
+	/** Start offset of each bucket in BucketEdges; has one extra entry so a bucket's range is [i, i + 1) */
+	UPROPERTY()
+	TArray<int32> BucketOffsets;
+
+	/** Edge indices of all buckets, stored back to back */
+	UPROPERTY()
+	TArray<int32> BucketEdges;
+
+	/** BucketSize, kept away from zero so the grid math never divides by it */
+	float GetBucketSize() const { return FMath::Max(BucketSize, 1.0f); }
+
+	/** Calls Visitor with every edge index stored in the buckets overlapping the XY box */
+	template<typename VisitorType>
+	void ForEachEdgeInBox(const FVector& Min, const FVector& Max, VisitorType&& Visitor) const;
+
+#if WITH_EDITOR
+	void AddEdgesFromComponent(class UStaticMeshComponent* MeshComponent, EClimbableType Type);
+
+	void LinkEdges();
+
+	void BuildGrid();
+#endif
+};
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Types.h"
+#include "ClimbGraphSubsystem.generated.h"
+
+struct FClimbEdge;
+class AClimbGraphActor;
+
+//Struct referencing an edge of a loaded climb graph; packs into 32 bits so it can be sent over the network
+USTRUCT(BlueprintType)
+struct FClimbEdgeHandle
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	uint16 GraphId{ 0 };
+
+	UPROPERTY()
+	uint16 EdgeIndex{ MAX_uint16 };
+
+	bool IsValid() const { return EdgeIndex != MAX_uint16; }
+
+	uint32 Pack() const { return (static_cast<uint32>(GraphId) << 16) | EdgeIndex; }
+
+	static FClimbEdgeHandle Unpack(uint32 Packed)
+	{
+		FClimbEdgeHandle Handle;
+		Handle.GraphId = static_cast<uint16>(Packed >> 16);
+		Handle.EdgeIndex = static_cast<uint16>(Packed & 0xFFFF);
+		return Handle;
+	}
+
+	bool operator==(const FClimbEdgeHandle& Other) const { return GraphId == Other.GraphId && EdgeIndex == Other.EdgeIndex; }
+	bool operator!=(const FClimbEdgeHandle& Other) const { return !(*this == Other); }
+};
+
+
+/**
+ * Keeps track of the climb graphs of all loaded level cells and answers climbing queries against them
+ */
+UCLASS()
+class DEFIANCE_API UClimbGraphSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Loaded graphs mapped by their baked id */
+	TMap<uint16, TWeakObjectPtr<AClimbGraphActor>> Graphs;
+
+public:
+	void RegisterGraph(AClimbGraphActor* Graph);
+
+	void UnregisterGraph(AClimbGraphActor* Graph);
+
+	/** Returns the edge referenced by the handle, or nullptr if its graph is not loaded */
+	const FClimbEdge* GetEdge(FClimbEdgeHandle Handle) const;
+
+	/** Returns the nearest edge within Radius across all loaded graphs */
+	FClimbEdgeHandle FindNearestEdge(const FVector& Location, float Radius, float& OutAlpha) const;
+
+	/** Returns the best edge to jump to from From along Direction */
+	FClimbEdgeHandle FindJumpTarget(const FVector& From, const FVector& Direction, float MaxDistance, FClimbEdgeHandle ExcludedEdge, float& OutAlpha) const;
+
+	/** Returns the edge connected to the end (bForward) or start of the given edge, and the transition to reach it */
+	FClimbEdgeHandle GetNeighbour(FClimbEdgeHandle Handle, bool bForward, EClimbTransition& OutTransition) const;
+
+	/** Returns the climb stance used on the given type of climbable */
+	static EClimbStance GetStanceForType(EClimbableType Type);
+};
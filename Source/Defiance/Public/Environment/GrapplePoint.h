@@ -22,9 +22,6 @@ public:
 	// Sets default values for this actor's properties
 	AGrapplePoint();
 
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
 	APawn* PlayerPawnRef;
@@ -47,12 +44,9 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
 	bool bIsActive{ false };
 
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-	float DistanceToPlayer;
-
-	
-	UFUNCTION(BlueprintCallable)
-	void UpdateDistanceToPlayer();
+	/** Only fed the per-point widget, which UIndicatorLayerWidget replaced; no longer updated */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta = (DeprecatedProperty, DeprecationMessage = "The grapple indicator is drawn by UIndicatorLayerWidget."))
+	float DistanceToPlayer{ 0.0f };
 
 	UFUNCTION(BlueprintCallable)
 	void ActivateGrapplePoint(APawn* PlayerPawn, float InteractRange, float DetectionRange);
@@ -63,4 +57,25 @@ public:
 	UFUNCTION(BlueprintCallable)
 	virtual FVector GetLandingLocation() override;
 
+	/** Approach positions a launch lands from without hitting anything, one bit each; see FGrappleReachability */
+	UPROPERTY(VisibleAnywhere, Category = "Grapple|Bake")
+	uint32 ReachabilityMask{ MAX_uint32 };
+
+	/** Interact range the mask was baked for; 0 when it was never baked */
+	UPROPERTY(VisibleAnywhere, Category = "Grapple|Bake")
+	float ReachabilityRange{ 0.0f };
+
+	/** Uses the baked mask; points that were never baked are always reachable */
+	virtual bool IsReachableFrom(const FVector& Location, int32 Index = INDEX_NONE) const override;
+
+#if WITH_EDITOR
+	/** Bakes ReachabilityMask for this point with the capsule and grappling hook settings of the player pawn */
+	UFUNCTION(CallInEditor, Category = "Grapple|Bake")
+	void BakeReachability();
+#endif
+
+	virtual void OnActivate_Implementation(const APawn* PlayerPawn, float InteractRange, float DetectionRange) override;
+
+	virtual void OnDeactivate_Implementation() override;
+
 };
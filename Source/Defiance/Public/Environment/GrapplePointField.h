@@ -0,0 +1,97 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Interfaces/Grapple.h"
+#include "InstancedStaticMeshDelegates.h"
+#include "GrapplePointField.generated.h"
+
+class UInstancedStaticMeshComponent;
+
+/**
+ * Many grapple anchors in one actor: every instance of the Anchors component is an anchor, with its data stored in
+ * arrays indexed like the instances. Anchors are targeted through the anchor functions of IGrapple, so a traversal heavy
+ * level costs one actor, one draw call per LOD and one set of instance bodies instead of an AGrapplePoint per anchor.
+ * The active anchor is highlighted through per instance custom data 0 (1 while active) for the material to use.
+ */
+UCLASS()
+class DEFIANCE_API AGrapplePointField : public AActor, public IGrapple
+{
+	GENERATED_BODY()
+
+	/** One instance per anchor; overlaps the Grapple channel so detection finds the anchors */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grapple", meta = (AllowPrivateAccess = "true"))
+	UInstancedStaticMeshComponent* Anchors;
+
+public:
+	// Sets default values for this actor's properties
+	AGrapplePointField();
+
+	/** Pads the anchor arrays for instances added without data; removals are handled as they happen */
+	virtual void OnConstruction(const FTransform& Transform) override;
+
+	virtual void PostRegisterAllComponents() override;
+
+	virtual void PostUnregisterAllComponents() override;
+
+	/** Landing location of every anchor, relative to the anchor */
+	UPROPERTY(EditAnywhere, Category = "Grapple")
+	TArray<FVector3f> LandingOffsets;
+
+	/** Distance to the player below which an anchor is too close to launch on */
+	UPROPERTY(EditAnywhere, Category = "Grapple")
+	TArray<float> MinDistances;
+
+	/** Used for anchors added without their own data */
+	UPROPERTY(EditAnywhere, Category = "Grapple")
+	FVector DefaultLandingOffset{ FVector::ZeroVector };
+
+	UPROPERTY(EditAnywhere, Category = "Grapple")
+	float DefaultMinDistance{ 200.0f };
+
+	/** Baked like AGrapplePoint::ReachabilityMask, one per anchor */
+	UPROPERTY(VisibleAnywhere, Category = "Grapple|Bake")
+	TArray<uint32> ReachabilityMasks;
+
+	/** Interact range the masks were baked for; 0 when they were never baked */
+	UPROPERTY(VisibleAnywhere, Category = "Grapple|Bake")
+	float ReachabilityRange{ 0.0f };
+
+	/** Adds an anchor at a world location and returns its index */
+	int32 AddAnchor(const FVector& Location, const FVector& LandingOffset, float MinDistance);
+
+	int32 GetNumAnchors() const;
+
+	virtual FVector GetLandingLocation() override;
+
+	virtual int32 GetAnchorIndex(const FHitResult& Hit) const override;
+
+	virtual FVector GetAnchorLocation(int32 Index) const override;
+
+	virtual FVector GetAnchorLandingLocation(int32 Index) override;
+
+	virtual bool IsReachableFrom(const FVector& Location, int32 Index = INDEX_NONE) const override;
+
+	virtual void OnActivateAnchor(int32 Index, const APawn* PlayerPawnRef, float InteractRange, float DetectionRange) override;
+
+	virtual void OnDeactivateAnchor(int32 Index) override;
+
+#if WITH_EDITOR
+	/** Bakes ReachabilityMasks for every anchor with the capsule and grappling hook settings of the player pawn */
+	UFUNCTION(CallInEditor, Category = "Grapple|Bake")
+	void BakeReachability();
+#endif
+
+private:
+	/** Anchor highlighted for the local player */
+	int32 ActiveAnchor{ INDEX_NONE };
+
+	void SetAnchorHighlighted(int32 Index, bool bHighlighted);
+
+	/** Moves the anchor data along with the instances when some are removed, so it stays on the same anchors */
+	void HandleInstanceIndexUpdated(UInstancedStaticMeshComponent* Component, TArrayView<const FInstancedStaticMeshDelegates::FInstanceIndexUpdateData> IndexUpdates);
+
+	FDelegateHandle InstanceIndexUpdatedHandle;
+};
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Offline check of which approach positions around a grapple point lead to a collision free launch onto its landing
+ * location. Positions are sampled on NumRings rings of NumSectors directions between the point's MinDistanceToPlayer
+ * and the interact range; each one solves the arc like UGrapplingHookComponent::LaunchOnGrapple does and sweeps the
+ * character capsule along it. The results are stored as one bit per position in AGrapplePoint::ReachabilityMask (or
+ * AGrapplePointField::ReachabilityMasks per anchor) so detection can skip unreachable points without any trajectory work at runtime.
+ */
+struct DEFIANCE_API FGrappleReachability
+{
+	static constexpr int32 NumSectors{ 8 };
+	static constexpr int32 NumRings{ 4 };
+
+	/** Launch settings of the grappling hook and the capsule swept along the arcs */
+	struct FBakeSettings
+	{
+		float CapsuleRadius{ 0.0f };
+		float CapsuleHalfHeight{ 0.0f };
+		float InteractRange{ 0.0f };
+		float DetectionRadius{ 0.0f };
+		float ArcParam{ 0.0f };
+		FVector LaunchModifier{ FVector::OneVector };
+	};
+
+	/** Returns the bits of ReachabilityMask that describe an approach from Location; all the rings of its direction
+	 * when it is further than the baked range */
+	static uint32 GetSampleMask(const FVector& GrappleLocation, const FVector& Location, float MinDistance, float Range);
+
+#if WITH_EDITOR
+	/** Reads the settings from the player pawn class of the world's game mode, with the capsule and grappling hook its
+	 * Blueprint overrides; ADefianceCharacter and the grappling hook defaults stand in for what cannot be found */
+	static FBakeSettings GetPlayerBakeSettings(const UWorld* World);
+
+	/** Bakes the masks of every given AGrapplePoint and AGrapplePointField anchor. The sweeps of all anchors run in parallel. */
+	static void Bake(UWorld* World, TArrayView<AActor* const> Grapples, const FBakeSettings& Settings);
+
+	/** Bakes with the settings of the player pawn */
+	static void Bake(UWorld* World, TArrayView<AActor* const> Grapples) { Bake(World, Grapples, GetPlayerBakeSettings(World)); }
+#endif
+};
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GrappleReachabilityCommandlet.generated.h"
+
+/**
+ * Bakes the reachability mask of every grapple point of a map and saves the packages that changed. World Partition
+ * maps are loaded whole so the sweeps see all geometry; with external actors only the grapple point packages are saved.
+ * Usage: UnrealEditor-Cmd Defiance.uproject -run=GrappleReachability -Map=/Game/ThirdPerson/Maps/ThirdPersonMap
+ */
+UCLASS()
+class DEFIANCE_API UGrappleReachabilityCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGrappleReachabilityCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
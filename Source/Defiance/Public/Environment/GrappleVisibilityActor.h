@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "UObject/ObjectKey.h"
+#include "GrappleVisibilityActor.generated.h"
+
+
+/** Answer of the baked visibility for a grapple point */
+enum class EGrappleVisibility : uint8
+{
+	/** The location or the point is not covered by a bake; a trace is needed */
+	Unknown,
+	Hidden,
+	PotentiallyVisible
+};
+
+
+/**
+ * Holds a baked potentially visible set of grapple points for one level cell. The cell is split into a grid and every
+ * grid cell stores one bit per nearby grapple point telling if the point can be seen from somewhere inside it. Like
+ * AClimbGraphActor, the actor is placed in the cell it covers so it streams in and out with it, and registers with the
+ * UGrappleVisibilitySubsystem while loaded.
+ */
+UCLASS()
+class DEFIANCE_API AGrappleVisibilityActor : public AActor
+{
+	GENERATED_BODY()
+
+	/** Area of the level covered by this set */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grapple", meta = (AllowPrivateAccess = "true"))
+	class UBoxComponent* Bounds;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+public:
+	// Sets default values for this actor's properties
+	AGrappleVisibilityActor();
+
+
+	/** Size of a grid cell */
+	UPROPERTY(EditAnywhere, Category = "Grapple|Bake")
+	FVector CellSize{ 400.0f, 400.0f, 300.0f };
+
+	/** Grapple points the bits refer to; soft so they may live in other streaming cells */
+	UPROPERTY(VisibleAnywhere, Category = "Grapple|Bake")
+	TArray<TSoftObjectPtr<AActor>> GrapplePoints;
+
+	/** Returns the world space box covered by this set */
+	FBox GetVisibilityBounds() const;
+
+	/** Returns whether the grapple point can be seen from Location according to the bake */
+	EGrappleVisibility GetVisibility(const FVector& Location, const AActor* GrapplePoint) const;
+
+	/** Maps the loaded grapple points to their bits; called on BeginPlay and whenever grapple points stream in */
+	void ResolvePoints();
+
+#if WITH_EDITOR
+	/** Traces from sample locations of every grid cell to every grapple point in detection range */
+	UFUNCTION(CallInEditor, Category = "Grapple|Bake")
+	void BakeVisibility();
+#endif
+
+private:
+	UPROPERTY()
+	FVector GridOrigin{ FVector::ZeroVector };
+
+	UPROPERTY()
+	FIntVector GridSize{ 0, 0, 0 };
+
+	/** 32 bit words used by one grid cell */
+	UPROPERTY()
+	int32 WordsPerCell{ 0 };
+
+	/** Visibility bits of all grid cells, stored back to back */
+	UPROPERTY()
+	TArray<uint32> CellBits;
+
+	/** Index in GrapplePoints of every loaded point */
+	TMap<FObjectKey, int32> PointIndices;
+};
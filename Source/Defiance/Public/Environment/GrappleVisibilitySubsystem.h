@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Environment/GrappleVisibilityActor.h"
+#include "GrappleVisibilitySubsystem.generated.h"
+
+
+/**
+ * Keeps track of the grapple visibility sets of all loaded level cells
+ */
+UCLASS()
+class DEFIANCE_API UGrappleVisibilitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	TArray<TWeakObjectPtr<AGrappleVisibilityActor>> VisibilitySets;
+
+	/** Lets the sets resolve the grapple points of a level that streamed in after them */
+	void HandleLevelAddedToWorld(ULevel* Level, UWorld* World);
+
+	FDelegateHandle LevelAddedHandle;
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	virtual void Deinitialize() override;
+
+	void RegisterVisibilitySet(AGrappleVisibilityActor* VisibilitySet);
+
+	void UnregisterVisibilitySet(AGrappleVisibilityActor* VisibilitySet);
+
+	/** Returns whether the grapple point can be seen from Location, using the set covering Location */
+	EGrappleVisibility GetVisibility(const FVector& Location, const AActor* GrapplePoint) const;
+};
@@ -23,9 +23,17 @@ class DEFIANCE_API IEnemy
 	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
 public:
 
-	UFUNCTION(BlueprintImplementableEvent)
+	/** Called on the locking player's machine when this becomes its lock on target */
+	UFUNCTION(BlueprintNativeEvent)
 	void OnSelect();
+	virtual void OnSelect_Implementation();
 
-	UFUNCTION(BlueprintImplementableEvent)
+	UFUNCTION(BlueprintNativeEvent)
 	void OnDeselect();
+	virtual void OnDeselect_Implementation();
+
+	/** Calls OnSelect on the target, only going through the Blueprint VM when a Blueprint overrides it */
+	static void NotifySelect(UObject* Target);
+
+	static void NotifyDeselect(UObject* Target);
 };
@@ -23,11 +23,14 @@ class DEFIANCE_API IGrapple
 	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
 public:
 
-	UFUNCTION(BlueprintImplementableEvent)
+	/** Called on the player's machine when this becomes its best grapple candidate */
+	UFUNCTION(BlueprintNativeEvent)
 	void OnActivate(const APawn* PlayerPawnRef, float InteractRange, float DetectionRange);
+	virtual void OnActivate_Implementation(const APawn* PlayerPawnRef, float InteractRange, float DetectionRange);
 
-	UFUNCTION(BlueprintImplementableEvent)
+	UFUNCTION(BlueprintNativeEvent)
 	void OnDeactivate();
+	virtual void OnDeactivate_Implementation();
 
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnInteract();
@@ -35,4 +38,30 @@ public:
 
 	virtual FVector GetLandingLocation() { return FVector::ZeroVector; }
 
+	/*-------------------------------------------ANCHORS-------------------------------------------*/
+	// A grapple can hold many anchors (AGrapplePointField); they are told apart by index. Single grapple points only
+	// have INDEX_NONE.
+
+	/** Returns the anchor a query hit on this grapple */
+	virtual int32 GetAnchorIndex(const FHitResult& Hit) const { return INDEX_NONE; }
+
+	/** Returns where the anchor hangs */
+	virtual FVector GetAnchorLocation(int32 Index) const;
+
+	virtual FVector GetAnchorLandingLocation(int32 Index) { return GetLandingLocation(); }
+
+	/** Indicates a launch from Location can reach the landing location of the anchor without hitting anything */
+	virtual bool IsReachableFrom(const FVector& Location, int32 Index = INDEX_NONE) const { return true; }
+
+	/** Called instead of OnActivate/OnDeactivate when a single anchor becomes the player's best candidate */
+	virtual void OnActivateAnchor(int32 Index, const APawn* PlayerPawnRef, float InteractRange, float DetectionRange) {}
+
+	virtual void OnDeactivateAnchor(int32 Index) {}
+
+	/** Calls OnActivate on the grapple (OnActivateAnchor for an anchor), only going through the Blueprint VM when a
+	 * Blueprint overrides it */
+	static void NotifyActivate(UObject* Grapple, int32 Index, const APawn* PlayerPawnRef, float InteractRange, float DetectionRange);
+
+	static void NotifyDeactivate(UObject* Grapple, int32 Index);
+
 };
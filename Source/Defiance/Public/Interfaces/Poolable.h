@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "Poolable.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE(MinimalAPI)
+class UPoolable : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Implemented by actors and components that keep gameplay state across a trip through UActorPoolSubsystem
+ */
+class DEFIANCE_API IPoolable
+{
+	GENERATED_BODY()
+
+	// Add interface functions to this class. This is the class that will be inherited to implement this interface.
+public:
+	/** Called after the actor was moved into place and activated, before it is handed out */
+	virtual void OnAcquiredFromPool() {}
+
+	/** Called before the actor is deactivated; anything the next user could observe has to be reset here */
+	virtual void OnReleasedToPool() {}
+};
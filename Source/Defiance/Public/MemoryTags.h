@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// Low Level Memory tracker tags of the Defiance module; visible with -llm and "stat LLMFULL", all grouped under Defiance
+LLM_DECLARE_TAG_API(Defiance, DEFIANCE_API);
+LLM_DECLARE_TAG_API(Defiance_LockOn, DEFIANCE_API);
+LLM_DECLARE_TAG_API(Defiance_Grapple, DEFIANCE_API);
+LLM_DECLARE_TAG_API(Defiance_CommonActions, DEFIANCE_API);
+LLM_DECLARE_TAG_API(Defiance_Animation, DEFIANCE_API);
+LLM_DECLARE_TAG_API(Defiance_Network, DEFIANCE_API);
+LLM_DECLARE_TAG_API(Defiance_Crowd, DEFIANCE_API);
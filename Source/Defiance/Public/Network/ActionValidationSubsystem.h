@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Types.h"
+#include "ActionValidationSubsystem.generated.h"
+
+class FRewindHistory;
+
+/** Applies a validated action; returns false if the action is not possible in the current state */
+DECLARE_DELEGATE_RetVal(bool, FApplyActionDelegate);
+
+
+/**
+ * Collects the action requests clients send during a frame and validates all of them in one parallel pass over
+ * flat arrays at the end of the frame, instead of one check at a time as packets arrive. Accepted actions are applied
+ * on the game thread ordered by player, and then by arrival, so the result does not depend on packet interleaving.
+ */
+UCLASS()
+class DEFIANCE_API UActionValidationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	/** Requests queued this frame; all arrays share indices */
+	TArray<ENetAction> Actions;
+	TArray<TWeakObjectPtr<ACharacter>> Requesters;
+	TArray<TWeakObjectPtr<const AActor>> Targets;
+	TArray<double> TimeStamps;
+	TArray<float> MaxDistances;
+	TArray<FApplyActionDelegate> ApplyDelegates;
+	TArray<FSimpleDelegate> RejectDelegates;
+
+	/** Per request data gathered for the parallel pass; kept between frames to reuse the allocations */
+	TArray<const FRewindHistory*> RequesterHistories;
+	TArray<const FRewindHistory*> TargetHistories;
+	TArray<FVector> RequesterLocations;
+	TArray<FVector> TargetLocations;
+	TArray<bool> HasTargets;
+	TArray<bool> Accepted;
+	TArray<int32> ApplyOrder;
+
+	void ResetQueue();
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual bool IsTickable() const override;
+
+	/** Returns the action validation subsystem of the world the object lives in */
+	static UActionValidationSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Below this many requests the pass runs on the game thread; spreading a handful of checks costs more than it saves */
+	int32 MinParallelRequests{ 32 };
+
+	/**
+	 * Queues an action received on the server. With a target, the action is only accepted if the requester was within
+	 * MaxDistance of it at ClientTimeStamp, according to the rewind history. Rejected actions are reported to telemetry
+	 * and call Reject, so the requester can take back what it predicted.
+	 */
+	void QueueAction(ENetAction Action, ACharacter* Requester, FApplyActionDelegate&& Apply, const AActor* Target = nullptr, double ClientTimeStamp = 0.0, float MaxDistance = 0.0f, FSimpleDelegate&& Reject = FSimpleDelegate());
+};
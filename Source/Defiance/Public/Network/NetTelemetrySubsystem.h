@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Types.h"
+#include "NetTelemetrySubsystem.generated.h"
+
+//Struct with the network counters gathered for a single action
+USTRUCT(BlueprintType)
+struct FNetActionStats
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Number of server RPCs sent for this action */
+	UPROPERTY(BlueprintReadOnly, Category = "Telemetry")
+	int32 Requests = 0;
+
+	/** Number of client position corrections attributed to this action */
+	UPROPERTY(BlueprintReadOnly, Category = "Telemetry")
+	int32 Corrections = 0;
+
+	/** Number of times the server rejected the RPC in its _Validate */
+	UPROPERTY(BlueprintReadOnly, Category = "Telemetry")
+	int32 RejectedValidations = 0;
+
+	/** Highest number of unacknowledged reliable bunches on the owner's channel when the RPC was sent */
+	UPROPERTY(BlueprintReadOnly, Category = "Telemetry")
+	int32 MaxReliableQueueDepth = 0;
+};
+
+
+/**
+ * Counts movement corrections, reliable RPC queue depth and rejected validations, attributed to the action that caused them
+ */
+UCLASS()
+class DEFIANCE_API UNetTelemetrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	struct FLastAction
+	{
+		ENetAction Action{ ENetAction::None };
+		double Time{ 0.0 };
+	};
+
+	/** Last action sent by each locally controlled actor */
+	TMap<TWeakObjectPtr<const AActor>, FLastAction> LastActions;
+
+	/** Counters indexed by ENetAction */
+	TStaticArray<FNetActionStats, static_cast<int32>(ENetAction::MAX)> Stats;
+
+	/** Time the counters were last reset */
+	double StartTime{ 0.0 };
+
+	FNetActionStats& GetMutableStats(ENetAction Action) { return Stats[static_cast<int32>(Action)]; }
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Returns the telemetry subsystem of the world the object lives in */
+	static UNetTelemetrySubsystem* Get(const UObject* WorldContextObject);
+
+	/** Corrections received within this many seconds of an action are attributed to it */
+	float AttributionWindow{ 0.5f };
+
+	/** Called on the client right before an action RPC is sent to the server */
+	void RecordActionRequest(AActor* Owner, ENetAction Action);
+
+	/** Called on the client when the server corrects the owner's predicted movement */
+	void RecordCorrection(const AActor* Owner);
+
+	/** Called on the server when an action RPC fails its _Validate or is rejected by UActionValidationSubsystem */
+	void RecordRejectedValidation(ENetAction Action);
+
+	UFUNCTION(BlueprintCallable, Category = "Telemetry")
+	FNetActionStats GetActionStats(ENetAction Action) const { return Stats[static_cast<int32>(Action)]; }
+
+	/** Returns the corrections per minute across all actions since the last reset */
+	UFUNCTION(BlueprintCallable, Category = "Telemetry")
+	float GetCorrectionsPerMinute() const;
+
+	/** Returns true if the corrections per minute are within defiance.NetTelemetry.CorrectionBudget */
+	UFUNCTION(BlueprintCallable, Category = "Telemetry")
+	bool IsWithinCorrectionBudget() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Telemetry")
+	void ResetStats();
+
+	/** Prints all counters to the log */
+	void DumpStats() const;
+};
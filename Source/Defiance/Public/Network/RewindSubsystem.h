@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Types.h"
+#include "RewindSubsystem.generated.h"
+
+class ACharacter;
+
+
+//State of a character at a point in time, as recorded or interpolated by the rewind history
+struct FRewindSample
+{
+	double Time{ 0.0 };
+	FVector Location{ FVector::ZeroVector };
+	FQuat Rotation{ FQuat::Identity };
+	float CapsuleRadius{ 0.0f };
+	float CapsuleHalfHeight{ 0.0f };
+	ERewindFlags Flags{ ERewindFlags::None };
+};
+
+
+/**
+ * Fixed capacity ring buffer of the states of one character. Each field is kept in its own array so recording is a
+ * handful of stores and searching by time only touches the timestamps.
+ */
+class DEFIANCE_API FRewindHistory
+{
+public:
+	void Init(int32 InCapacity);
+
+	/** Appends a sample, overwriting the oldest one once the buffer is full; Time has to increase */
+	void Record(double Time, const FVector& Location, const FQuat& Rotation, float CapsuleRadius, float CapsuleHalfHeight, ERewindFlags Flags);
+
+	/** Returns the state at Time, interpolated between the closest samples and clamped to the recorded range */
+	bool Query(double Time, FRewindSample& OutSample) const;
+
+	int32 Num() const { return Count; }
+
+	double GetOldestTime() const { return Count > 0 ? Times[GetPhysicalIndex(0)] : 0.0; }
+
+	double GetNewestTime() const { return Count > 0 ? Times[GetPhysicalIndex(Count - 1)] : 0.0; }
+
+private:
+	TArray<double> Times;
+	TArray<FVector> Locations;
+	TArray<FQuat4f> Rotations;
+	TArray<float> CapsuleRadii;
+	TArray<float> CapsuleHalfHeights;
+	TArray<ERewindFlags> Flags;
+
+	/** Physical index of the next sample to write */
+	int32 Head{ 0 };
+
+	int32 Count{ 0 };
+
+	/** Converts an index counted from the oldest sample to an index in the arrays */
+	int32 GetPhysicalIndex(int32 LogicalIndex) const
+	{
+		const int32 Index{ Head - Count + LogicalIndex };
+		return Index < 0 ? Index + Times.Num() : Index;
+	}
+};
+
+
+/**
+ * Records the state of every Defiance character once per server frame, so validation can check a client request
+ * against the world as the client saw it instead of against the server's present
+ */
+UCLASS()
+class DEFIANCE_API URewindSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	struct FRecordedCharacter
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		TWeakObjectPtr<class UCharacterMovementComponent> MovementComp;
+		TWeakObjectPtr<class UCommonActionsComponent> CommonActionsComp;
+		TWeakObjectPtr<class UMeleeComponent> MeleeComp;
+	};
+
+	/** Recorded characters and their histories share indices */
+	TArray<FRecordedCharacter> Characters;
+	TArray<FRewindHistory> Histories;
+
+	TMap<TWeakObjectPtr<const AActor>, int32> CharacterIndices;
+
+	ERewindFlags GetFlags(const FRecordedCharacter& Recorded) const;
+
+	void RemoveCharacterAt(int32 Index);
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	virtual bool IsTickable() const override;
+
+	/** Returns the rewind subsystem of the world the object lives in */
+	static URewindSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Returns the server time as estimated by this machine */
+	static double GetServerTime(const UObject* WorldContextObject);
+
+	/**
+	 * Returns the server time of the poses this machine has on screen: the server's present less the trip the poses
+	 * took to get here and the interpolation delay of simulated characters. Clients send it along with requests that
+	 * need rewinding.
+	 */
+	static double GetViewTime(const UObject* WorldContextObject);
+
+	/** Seconds of history kept per character */
+	float HistoryLength{ 1.0f };
+
+	/** Furthest back the server rewinds; requests from further back are checked against this point instead */
+	float MaxRewindTime{ 0.5f };
+
+	/** How far a time stamp may lie outside of the recorded history before the request is treated as malformed */
+	float MaxTimeStampError{ 1.0f };
+
+	/** Indicates a client time stamp could be genuine; meant for _Validate, which should only refuse malformed requests */
+	bool IsTimeStampPlausible(double ClientTimeStamp) const;
+
+	/** Limits a client time stamp to the last MaxRewindTime seconds and to the present */
+	double ClampRewindTime(double ClientTimeStamp) const;
+
+	/** Expected server frame rate; together with HistoryLength this sets the capacity of every history */
+	int32 RecordRate{ 60 };
+
+	/** Starts recording the character; only has an effect on the server */
+	void RegisterCharacter(ACharacter* Character);
+
+	void UnregisterCharacter(const ACharacter* Character);
+
+	/** Returns the history of the character, or nullptr if it is not recorded */
+	const FRewindHistory* GetHistory(const AActor* Actor) const;
+
+	/** Returns the state of the actor at the given server time; returns false if the actor has no history */
+	bool QueryCharacter(const AActor* Actor, double Time, FRewindSample& OutSample) const;
+
+	/** Returns the location of the actor at the given server time, or its current location when it has no history */
+	FVector GetLocationAtTime(const AActor* Actor, double Time) const;
+};
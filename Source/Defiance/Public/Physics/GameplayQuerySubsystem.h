@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "CollisionQueryParams.h"
+#include "GameplayQuerySubsystem.generated.h"
+
+DECLARE_DELEGATE_OneParam(FGameplayQueryDelegate, const TArray<FHitResult>& /*Hits*/);
+
+
+UENUM()
+enum class EGameplayQueryShape : uint8
+{
+	/** Multi line trace from Start to End */
+	Line,
+	/** Multi sphere sweep from Start to End; a sweep with Start == End is an overlap */
+	Sphere
+};
+
+
+/** A spatial query waiting to be run by UGameplayQuerySubsystem */
+struct DEFIANCE_API FGameplayQueryRequest
+{
+	EGameplayQueryShape Shape{ EGameplayQueryShape::Sphere };
+
+	FVector Start{ FVector::ZeroVector };
+	FVector End{ FVector::ZeroVector };
+
+	/** Radius of sphere queries */
+	float Radius{ 0.0f };
+
+	ECollisionChannel Channel{ ECC_Visibility };
+
+	FCollisionQueryParams Params{ FCollisionQueryParams::DefaultQueryParam };
+
+	/** Queries with a higher priority run first when the budget does not cover every pending query */
+	int32 Priority{ 0 };
+
+	/** Frames the query may be held back by the budget; a query past its deadline runs regardless */
+	int32 DeadlineFrames{ 0 };
+
+	/** Receives the hits on the game thread; bind with CreateUObject/CreateWeakLambda so a destroyed owner is skipped */
+	FGameplayQueryDelegate OnComplete;
+};
+
+
+/**
+ * Runs the sweeps and traces submitted by gameplay components once per frame inside a time budget, so a burst of
+ * queries is spread over the following frames instead of landing on one. Identical queries submitted in the same
+ * frame are run once and their results shared.
+ */
+UCLASS()
+class DEFIANCE_API UGameplayQuerySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+	struct FPendingQuery
+	{
+		FGameplayQueryRequest Request;
+		uint32 Id;
+		int32 FramesWaited;
+	};
+
+	TArray<FPendingQuery> PendingQueries;
+
+	/** Queries being run this frame; callbacks submitting new queries add them to PendingQueries for the next frame */
+	TArray<FPendingQuery> RunningQueries;
+
+	uint32 NextQueryId{ 1 };
+
+	/** Distance under which the ends of two otherwise identical queries are considered the same */
+	static constexpr double ShareTolerance{ 1.0 };
+
+	/** Returns true if both queries produce the same hits */
+	static bool CanShareResults(const FGameplayQueryRequest& A, const FGameplayQueryRequest& B);
+
+	void RunQuery(const FGameplayQueryRequest& Request, TArray<FHitResult>& OutHits) const;
+
+public:
+	virtual void Tick(float DeltaTime) override;
+
+	virtual TStatId GetStatId() const override;
+
+	/** Returns the query subsystem of the world the object lives in */
+	static UGameplayQuerySubsystem* Get(const UObject* WorldContextObject);
+
+	/** Queues a query to run at the end of this frame or a later one; returns an id that can be passed to CancelQuery */
+	uint32 SubmitQuery(FGameplayQueryRequest&& Request);
+
+	/** Drops a query that has not run yet */
+	void CancelQuery(uint32 QueryId);
+
+	bool IsQueryPending(uint32 QueryId) const;
+
+	/** Totals since the world started, for comparing runs (the stats only cover a frame) */
+	uint64 NumQueriesRun{ 0 };
+	uint64 NumQueriesShared{ 0 };
+	uint64 NumQueriesDeferred{ 0 };
+};
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Closed form check of which grapple targets a launch can reach, four targets per SIMD register. Uses the same arc as
+ * UGameplayStatics::SuggestProjectileVelocity_CustomArc (launch direction between straight up and the target, set by
+ * ArcParam), scales the velocity by the launch modifier and compares the resulting speed with the maximum.
+ */
+struct DEFIANCE_API FGrappleBallistics
+{
+	/**
+	 * Writes for each target whether it can be reached from Start. Targets are passed as separate coordinate arrays of
+	 * equal length; OutReachable must be as long.
+	 */
+	static void ComputeReachable(
+		const FVector& Start,
+		TConstArrayView<float> TargetX,
+		TConstArrayView<float> TargetY,
+		TConstArrayView<float> TargetZ,
+		float GravityZ,
+		float ArcParam,
+		const FVector& LaunchModifier,
+		float MaxLaunchSpeed,
+		TArrayView<bool> OutReachable);
+};
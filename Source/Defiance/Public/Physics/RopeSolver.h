@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Position based dynamics chain used for ropes (many segments) and high bars (a single rigid segment).
+ * Particles are stored as separate float arrays relative to the anchor so every pass is a straight loop over
+ * contiguous memory. Stepping only ever uses a fixed time step, which keeps the result independent of the frame
+ * rate; the solver is plain copyable data, so a snapshot can be restored and stepped again to replay a swing.
+ */
+class DEFIANCE_API FRopeSolver
+{
+public:
+	/** Downward acceleration applied to every particle */
+	float Gravity{ 980.0f };
+
+	/** Fraction of velocity removed every step */
+	float Damping{ 0.002f };
+
+	/** Number of constraint passes per step; higher values make the rope stiffer */
+	int32 ConstraintIterations{ 8 };
+
+	/** Creates a chain of NumSegments from Anchor to End; the anchor particle is pinned */
+	void Init(const FVector& Anchor, const FVector& End, int32 NumSegments, const FVector& EndVelocity, float FixedDeltaTime);
+
+	void Reset();
+
+	bool IsActive() const { return PosX.Num() > 1; }
+
+	/** Advances the chain by one fixed step; EndAcceleration is applied to the last particle only (input pumping) */
+	void Step(float FixedDeltaTime, const FVector3f& EndAcceleration);
+
+	FVector GetAnchorLocation() const { return Origin; }
+
+	FVector GetEndLocation() const;
+
+	FVector GetEndVelocity(float FixedDeltaTime) const;
+
+	/** Moves the last particle to End with EndVelocity, e.g. to follow a server correction of the character */
+	void SetEndState(const FVector& End, const FVector& EndVelocity, float FixedDeltaTime);
+
+	int32 GetNumParticles() const { return PosX.Num(); }
+
+	FVector GetParticleLocation(int32 Index) const { return Origin + FVector(PosX[Index], PosY[Index], PosZ[Index]); }
+
+private:
+	/** World location of the anchor; particle positions are relative to it */
+	FVector Origin{ FVector::ZeroVector };
+
+	float SegmentLength{ 0.0f };
+
+	TArray<float> PosX, PosY, PosZ;
+	TArray<float> PrevX, PrevY, PrevZ;
+	TArray<float> InvMass;
+
+	void Integrate(float FixedDeltaTime, const FVector3f& EndAcceleration);
+
+	/** Solves every other segment starting at FirstSegment; those segments share no particles so the loop has no dependencies */
+	void SolveDistanceConstraints(int32 FirstSegment);
+};
@@ -69,6 +69,60 @@ enum class EClimbableType : uint8
 	Rope		UMETA(DisplayName = "Rope")
 };
 
+//Enum with the custom movement modes of UDefianceMovementComponent (used with MOVE_Custom)
+UENUM(BlueprintType)
+enum class ECustomMovementMode : uint8
+{
+	CMOVE_None		UMETA(Hidden),
+	CMOVE_Climbing	UMETA(DisplayName = "Climbing"),
+	CMOVE_Swinging	UMETA(DisplayName = "Swinging")
+};
+
+//Bit flags with the actions a character was performing, stored in the server-side rewind history
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class ERewindFlags : uint8
+{
+	None		= 0			UMETA(Hidden),
+	Crouching	= 1 << 0	UMETA(DisplayName = "Crouching"),
+	Falling		= 1 << 1	UMETA(DisplayName = "Falling"),
+	Climbing	= 1 << 2	UMETA(DisplayName = "Climbing"),
+	Swinging	= 1 << 3	UMETA(DisplayName = "Swinging"),
+	Dodging		= 1 << 4	UMETA(DisplayName = "Dodging"),
+	Rolling		= 1 << 5	UMETA(DisplayName = "Rolling"),
+	Attacking	= 1 << 6	UMETA(DisplayName = "Attacking")
+};
+ENUM_CLASS_FLAGS(ERewindFlags)
+
+//Enum with the gameplay significance tiers of a character, from most to least significant
+UENUM(BlueprintType)
+enum class ESignificanceTier : uint8
+{
+	High		UMETA(DisplayName = "High"),
+	Medium		UMETA(DisplayName = "Medium"),
+	Low			UMETA(DisplayName = "Low"),
+	MAX			UMETA(Hidden)
+};
+
+//Enum with all gameplay actions sent to the server (used for network telemetry)
+UENUM(BlueprintType)
+enum class ENetAction : uint8
+{
+	None			UMETA(DisplayName = "None"),
+	StartSprint		UMETA(DisplayName = "Start Sprint"),
+	EndSprint		UMETA(DisplayName = "End Sprint"),
+	StartCrouch		UMETA(DisplayName = "Start Crouch"),
+	EndCrouch		UMETA(DisplayName = "End Crouch"),
+	Dodge			UMETA(DisplayName = "Dodge"),
+	Roll			UMETA(DisplayName = "Roll"),
+	UpdateLockOn	UMETA(DisplayName = "Update Lock On"),
+	Climb			UMETA(DisplayName = "Climb"),
+	Swing			UMETA(DisplayName = "Swing"),
+	MeleeAttack		UMETA(DisplayName = "Melee Attack"),
+	MeleeHit		UMETA(DisplayName = "Melee Hit"),
+	GrappleLaunch	UMETA(DisplayName = "Grapple Launch"),
+	MAX				UMETA(Hidden)
+};
+
 
 //Struct with velocity values on each direction used to blend animations
 USTRUCT(BlueprintType, Blueprintable)
@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "DefianceHUD.generated.h"
+
+/**
+ * HUD of the local player; owns the screen space target indicator layer
+ */
+UCLASS()
+class DEFIANCE_API ADefianceHUD : public AHUD
+{
+	GENERATED_BODY()
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+public:
+	ADefianceHUD();
+
+	UPROPERTY(EditAnywhere, Category = "Indicators")
+	TSubclassOf<class UIndicatorLayerWidget> IndicatorLayerClass;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Indicators")
+	class UIndicatorLayerWidget* IndicatorLayer;
+};
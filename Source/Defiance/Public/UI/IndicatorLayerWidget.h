@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "IndicatorLayerWidget.generated.h"
+
+class UTargetIndicatorWidget;
+
+
+/**
+ * Full screen layer that draws the lock on and grapple indicators of the local player. Targets are projected once per
+ * frame in a single batch and placed on a small pool of indicators inside an invalidation box, so Slate only repaints
+ * when an indicator moves or changes state.
+ */
+UCLASS()
+class DEFIANCE_API UIndicatorLayerWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+	/** A pooled indicator and the state it was last given, so unchanged indicators are not touched */
+	struct FIndicatorSlot
+	{
+		UTargetIndicatorWidget* Widget{ nullptr };
+		FVector2D ScreenPosition{ FVector2D::ZeroVector };
+		bool bVisible{ false };
+	};
+
+	/** A target to draw this frame */
+	struct FIndicatorRequest
+	{
+		FVector WorldLocation;
+		bool bIsGrapple;
+		bool bInRange;
+	};
+
+	/** Keeps the pooled widgets alive */
+	UPROPERTY()
+	TArray<UTargetIndicatorWidget*> PooledWidgets;
+
+	TArray<FIndicatorSlot> LockOnSlots;
+	TArray<FIndicatorSlot> GrappleSlots;
+
+	/** Revision of the indicator subsystem when the indicators were last hidden */
+	uint32 HiddenRevision{ MAX_uint32 };
+
+	void FillPool(TSubclassOf<UTargetIndicatorWidget> IndicatorClass, TArray<FIndicatorSlot>& OutSlots);
+
+	void UpdateSlot(FIndicatorSlot& IndicatorSlot, bool bVisible, const FVector2D& ScreenPosition, bool bInRange);
+
+	void HideAll();
+
+protected:
+	virtual void NativeOnInitialized() override;
+
+	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+
+public:
+	UIndicatorLayerWidget(const FObjectInitializer& ObjectInitializer);
+
+	/** Optional when subclassed in the editor; created in code otherwise */
+	UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional))
+	class UInvalidationBox* IndicatorBox;
+
+	UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional))
+	class UCanvasPanel* IndicatorCanvas;
+
+	/** Defaults to the plain marker built in code */
+	UPROPERTY(EditAnywhere, Category = "Indicators")
+	TSubclassOf<UTargetIndicatorWidget> LockOnIndicatorClass;
+
+	UPROPERTY(EditAnywhere, Category = "Indicators")
+	TSubclassOf<UTargetIndicatorWidget> GrappleIndicatorClass;
+
+	/** Number of indicators created up front for each kind */
+	UPROPERTY(EditAnywhere, Category = "Indicators")
+	int32 PoolSize{ 2 };
+
+	/** Offset from the lock on target's location the indicator is drawn at */
+	UPROPERTY(EditAnywhere, Category = "Indicators")
+	FVector LockOnIndicatorOffset{ 0.0, 0.0, 40.0 };
+
+	/** Indicators closer than this many slate units to their last position are left where they are */
+	UPROPERTY(EditAnywhere, Category = "Indicators")
+	float MoveThreshold{ 0.5f };
+};
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "TargetIndicatorSubsystem.generated.h"
+
+
+/**
+ * Holds what the local player's target indicators show: the locked on enemy and the active grapple point.
+ * Updated by IEnemy::NotifySelect and IGrapple::NotifyActivate, whatever the Blueprint events of the target do.
+ */
+UCLASS()
+class DEFIANCE_API UTargetIndicatorSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+	TWeakObjectPtr<AActor> LockOnTarget;
+
+	TWeakObjectPtr<AActor> ActiveGrapple;
+
+	/** Anchor of the active grapple, for grapples made of many */
+	int32 ActiveGrappleIndex{ INDEX_NONE };
+
+	/** Increased on every change so the HUD can skip frames where nothing changed */
+	uint32 Revision{ 0 };
+
+public:
+	/** Returns the indicator subsystem of the world the object lives in */
+	static UTargetIndicatorSubsystem* Get(const UObject* WorldContextObject);
+
+	/** Range of the player's grapple when the active grapple point was activated */
+	float GrappleInteractRange{ 0.0f };
+	float GrappleDetectionRange{ 0.0f };
+
+	void SetLockOnTarget(AActor* Target);
+
+	/** Clears the lock on target if it is still the given actor */
+	void ClearLockOnTarget(const AActor* Target);
+
+	void SetActiveGrapple(AActor* Grapple, float InteractRange, float DetectionRange, int32 Index = INDEX_NONE);
+
+	/** Clears the active grapple if it is still the given actor (and anchor) */
+	void ClearActiveGrapple(const AActor* Grapple, int32 Index = INDEX_NONE);
+
+	UFUNCTION(BlueprintPure, Category = "Indicators")
+	AActor* GetLockOnTarget() const { return LockOnTarget.Get(); }
+
+	UFUNCTION(BlueprintPure, Category = "Indicators")
+	AActor* GetActiveGrapple() const { return ActiveGrapple.Get(); }
+
+	/** Returns where the active grapple anchor hangs; only meaningful while GetActiveGrapple is set */
+	FVector GetActiveGrappleLocation() const;
+
+	uint32 GetRevision() const { return Revision; }
+};
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UI/SimpleWidget.h"
+#include "TargetIndicatorWidget.generated.h"
+
+class UImage;
+class UTexture2D;
+
+/**
+ * Screen space marker drawn over a lock on target or grapple point by UIndicatorLayerWidget. Draws IndicatorTexture
+ * tinted with ActiveColor unless a subclass made in the editor provides its own layout.
+ */
+UCLASS()
+class DEFIANCE_API UTargetIndicatorWidget : public USimpleWidget
+{
+	GENERATED_BODY()
+
+	bool bIsInRange{ false };
+
+protected:
+	virtual void NativeOnInitialized() override;
+
+public:
+	/** Optional when subclassed in the editor; created in code otherwise and tinted with ActiveColor */
+	UPROPERTY(BlueprintReadOnly, meta = (BindWidgetOptional))
+	UImage* IndicatorImage;
+
+	/** Texture of the image built in code */
+	UPROPERTY(EditAnywhere, Category = "Appearance")
+	TSoftObjectPtr<UTexture2D> IndicatorTexture{ FSoftObjectPath(TEXT("/Game/UI/Images/TargetLock.TargetLock")) };
+
+	/** Size of the image built in code, in slate units */
+	UPROPERTY(EditAnywhere, Category = "Appearance")
+	FVector2D IndicatorSize{ 48.0, 48.0 };
+
+	/** Color used while the target can be interacted with */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Color")
+	FColor InRangeColor = FColor::Green;
+
+	/** Color used while the target is detected but out of reach */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Color")
+	FColor OutOfRangeColor = FColor::White;
+
+	/** Updates ActiveColor; only notifies the Blueprint when the state actually changes */
+	void SetInRange(bool bInRange);
+
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnInRangeChanged(bool bInRange);
+};